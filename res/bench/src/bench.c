@@ -0,0 +1,574 @@
+// Defined before any header that includes SDL.h, as the benchmark has its own main
+#define SDL_MAIN_HANDLED
+
+#include "core/buffer.h"
+#include "core/image_packer.h"
+#include "core/xml_parser.h"
+#include "core/zlib_helper.h"
+#include "game/file_io.h"
+#include "game/game.h"
+#include "game/replay.h"
+#include "map/desirability.h"
+#include "map/grid.h"
+#include "map/road_network.h"
+#include "map/routing.h"
+#include "map/routing_terrain.h"
+#include "map/terrain.h"
+#include "map/water_supply.h"
+#include "platform/file_manager.h"
+#include "platform/renderer.h"
+
+#include "SDL.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SYNTHETIC_MAP_SIZE 160
+#define SYNTHETIC_ROAD_SPACING 6
+
+#define PACKER_RECTANGLES 2000
+#define PACKER_IMAGE_SIZE 2048
+
+#define DEFAULT_MIN_TIME_MILLIS 500
+#define MAX_ITERATIONS 1000000000u
+#define MAX_BENCHMARKS 32
+#define BENCHMARK_NAME_MAX 64
+
+#define DEFAULT_XML_FILE "res/assets/Graphics/walkers.xml"
+
+#define REPLAY_BENCHMARK_NAME "game_replay/replay"
+#define REPLAY_WINDOW_WIDTH 640
+#define REPLAY_WINDOW_HEIGHT 480
+
+typedef enum {
+    OUTPUT_JSON = 0,
+    OUTPUT_CSV = 1
+} output_format;
+
+typedef struct {
+    char name[BENCHMARK_NAME_MAX];
+    unsigned int iterations;
+    double real_time_ns;
+    double cpu_time_ns;
+    double bytes_per_second;
+    char label[BENCHMARK_NAME_MAX];
+    const char *error;
+} benchmark_result;
+
+static struct {
+    output_format format;
+    const char *save_file;
+    const char *xml_file;
+    const char *replay_file;
+    const char *data_dir;
+    const char *filter;
+    unsigned int min_time_millis;
+    benchmark_result results[MAX_BENCHMARKS];
+    int num_results;
+    struct {
+        int src_x;
+        int src_y;
+        int dst_x;
+        int dst_y;
+    } route;
+    struct {
+        uint8_t *input;
+        uint8_t *compressed;
+        uint8_t *output;
+        int input_size;
+        int compressed_size;
+        int compressed_capacity;
+    } zlib;
+    struct {
+        char *data;
+        unsigned int size;
+    } xml;
+    unsigned int packer_sizes[PACKER_RECTANGLES][2];
+} data;
+
+static const xml_parser_element ASSET_XML_ELEMENTS[] = {
+    { "assetlist" },
+    { "image", 0, 0, "assetlist" },
+    { "layer", 0, 0, "image" },
+    { "animation", 0, 0, "image" },
+    { "frame", 0, 0, "animation" }
+};
+
+#define ASSET_XML_TOTAL_ELEMENTS (sizeof(ASSET_XML_ELEMENTS) / sizeof(xml_parser_element))
+
+typedef void (*benchmark_function)(void);
+
+static void add_result(const char *name, const char *error)
+{
+    if (data.num_results >= MAX_BENCHMARKS) {
+        return;
+    }
+    benchmark_result *result = &data.results[data.num_results++];
+    memset(result, 0, sizeof(benchmark_result));
+    snprintf(result->name, BENCHMARK_NAME_MAX, "%s", name);
+    result->error = error;
+}
+
+static void run_benchmark(const char *name, benchmark_function function, size_t bytes_per_iteration)
+{
+    if (data.filter && !strstr(name, data.filter)) {
+        return;
+    }
+    if (data.num_results >= MAX_BENCHMARKS) {
+        return;
+    }
+    // Warm up caches and lazily allocated state before measuring
+    function();
+
+    uint64_t frequency = SDL_GetPerformanceFrequency();
+    uint64_t min_ticks = frequency * data.min_time_millis / 1000;
+    unsigned int iterations = 1;
+    uint64_t elapsed;
+    clock_t cpu_elapsed;
+    while (1) {
+        clock_t cpu_start = clock();
+        uint64_t start = SDL_GetPerformanceCounter();
+        for (unsigned int i = 0; i < iterations; i++) {
+            function();
+        }
+        elapsed = SDL_GetPerformanceCounter() - start;
+        cpu_elapsed = clock() - cpu_start;
+        if (elapsed >= min_ticks || iterations >= MAX_ITERATIONS / 2) {
+            break;
+        }
+        iterations *= 2;
+    }
+    add_result(name, 0);
+    benchmark_result *result = &data.results[data.num_results - 1];
+    result->iterations = iterations;
+    result->real_time_ns = elapsed * 1e9 / frequency / iterations;
+    result->cpu_time_ns = cpu_elapsed * 1e9 / CLOCKS_PER_SEC / iterations;
+    if (bytes_per_iteration && result->real_time_ns > 0) {
+        result->bytes_per_second = bytes_per_iteration * 1e9 / result->real_time_ns;
+    }
+}
+
+static void find_route_endpoints(void)
+{
+    int width, height;
+    map_grid_size(&width, &height);
+    int found = 0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (!map_terrain_is(map_grid_offset(x, y), TERRAIN_ROAD)) {
+                continue;
+            }
+            if (!found) {
+                data.route.src_x = x;
+                data.route.src_y = y;
+                found = 1;
+            }
+            data.route.dst_x = x;
+            data.route.dst_y = y;
+        }
+    }
+}
+
+static void create_synthetic_map(void)
+{
+    int border = GRID_SIZE_LEGACY - SYNTHETIC_MAP_SIZE;
+    map_grid_init(SYNTHETIC_MAP_SIZE, SYNTHETIC_MAP_SIZE, border / 2 * GRID_SIZE_LEGACY + border / 2, border);
+    map_terrain_clear();
+    map_terrain_init_outside_map();
+
+    // A road lattice with a few gardens on it, and trees and water in between
+    unsigned int seed = 12345;
+    for (int y = 0; y < SYNTHETIC_MAP_SIZE; y++) {
+        for (int x = 0; x < SYNTHETIC_MAP_SIZE; x++) {
+            seed = seed * 1103515245 + 12345;
+            unsigned int random = (seed >> 16) & 0x7fff;
+            int grid_offset = map_grid_offset(x, y);
+            if (x % SYNTHETIC_ROAD_SPACING == 0 || y % SYNTHETIC_ROAD_SPACING == 0) {
+                map_terrain_set(grid_offset, random % 20 ? TERRAIN_ROAD : TERRAIN_GARDEN);
+            } else if (random % 7 == 0) {
+                map_terrain_set(grid_offset, TERRAIN_TREE);
+            } else if (random % 31 == 0) {
+                map_terrain_set(grid_offset, TERRAIN_WATER);
+            }
+        }
+    }
+    map_routing_update_all();
+    find_route_endpoints();
+}
+
+static int load_real_map(void)
+{
+    if (game_file_io_read_saved_game(data.save_file, 0) != 1) {
+        return 0;
+    }
+    map_routing_update_all();
+    find_route_endpoints();
+    return 1;
+}
+
+static void bench_routing_distances(void)
+{
+    map_routing_calculate_distances(data.route.src_x, data.route.src_y);
+}
+
+static void bench_routing_road_garden(void)
+{
+    map_routing_citizen_can_travel_over_road_garden(
+        data.route.src_x, data.route.src_y, data.route.dst_x, data.route.dst_y, 8);
+}
+
+static void bench_road_network_update(void)
+{
+    map_road_network_update();
+}
+
+static void bench_desirability_update(void)
+{
+    map_desirability_update();
+}
+
+static void bench_water_supply_update(void)
+{
+    map_water_supply_update_reservoir_fountain();
+}
+
+static void run_map_benchmarks(const char *map_name, int with_buildings)
+{
+    char name[BENCHMARK_NAME_MAX];
+    snprintf(name, BENCHMARK_NAME_MAX, "map_routing_calculate_distances/%s", map_name);
+    run_benchmark(name, bench_routing_distances, 0);
+    snprintf(name, BENCHMARK_NAME_MAX, "map_routing_citizen_can_travel_over_road_garden/%s", map_name);
+    run_benchmark(name, bench_routing_road_garden, 0);
+    snprintf(name, BENCHMARK_NAME_MAX, "map_road_network_update/%s", map_name);
+    run_benchmark(name, bench_road_network_update, 0);
+    if (!with_buildings) {
+        return;
+    }
+    snprintf(name, BENCHMARK_NAME_MAX, "map_desirability_update/%s", map_name);
+    run_benchmark(name, bench_desirability_update, 0);
+    snprintf(name, BENCHMARK_NAME_MAX, "map_water_supply_update_reservoir_fountain/%s", map_name);
+    run_benchmark(name, bench_water_supply_update, 0);
+}
+
+static int prepare_zlib_input(void)
+{
+    // The terrain grid is one of the largest compressed pieces of a saved game
+    data.zlib.input_size = sizeof(grid_u32);
+    data.zlib.compressed_capacity = data.zlib.input_size + data.zlib.input_size / 10 + 1024;
+    data.zlib.input = malloc(data.zlib.input_size);
+    data.zlib.output = malloc(data.zlib.input_size);
+    data.zlib.compressed = malloc(data.zlib.compressed_capacity);
+    if (!data.zlib.input || !data.zlib.output || !data.zlib.compressed) {
+        return 0;
+    }
+    buffer buf;
+    buffer_init(&buf, data.zlib.input, data.zlib.input_size);
+    map_terrain_save_state(&buf);
+    return zlib_helper_compress(data.zlib.input, data.zlib.input_size,
+        data.zlib.compressed, data.zlib.compressed_capacity, &data.zlib.compressed_size);
+}
+
+static void bench_zlib_compress(void)
+{
+    int size;
+    zlib_helper_compress(data.zlib.input, data.zlib.input_size,
+        data.zlib.compressed, data.zlib.compressed_capacity, &size);
+}
+
+static void bench_zlib_decompress(void)
+{
+    int size;
+    zlib_helper_decompress(data.zlib.compressed, data.zlib.compressed_size,
+        data.zlib.output, data.zlib.input_size, &size);
+}
+
+static void run_zlib_benchmarks(void)
+{
+    if (!prepare_zlib_input()) {
+        add_result("zlib_helper_compress", "Unable to prepare the terrain grid");
+        return;
+    }
+    run_benchmark("zlib_helper_compress/terrain", bench_zlib_compress, data.zlib.input_size);
+    run_benchmark("zlib_helper_decompress/terrain", bench_zlib_decompress, data.zlib.input_size);
+    free(data.zlib.input);
+    free(data.zlib.output);
+    free(data.zlib.compressed);
+}
+
+static void prepare_packer_sizes(void)
+{
+    // Mostly small sprites with the occasional large one, like the asset images
+    unsigned int seed = 54321;
+    for (int i = 0; i < PACKER_RECTANGLES; i++) {
+        seed = seed * 1103515245 + 12345;
+        unsigned int random = (seed >> 16) & 0x7fff;
+        unsigned int max_size = random % 16 ? 64 : 256;
+        data.packer_sizes[i][0] = 8 + random % max_size;
+        data.packer_sizes[i][1] = 8 + (random / max_size) % max_size;
+    }
+}
+
+static void bench_image_packer(void)
+{
+    image_packer packer;
+    if (image_packer_init(&packer, PACKER_RECTANGLES, PACKER_IMAGE_SIZE, PACKER_IMAGE_SIZE) != IMAGE_PACKER_OK) {
+        return;
+    }
+    packer.options.fail_policy = IMAGE_PACKER_NEW_IMAGE;
+    packer.options.reduce_image_size = 1;
+    packer.options.sort_by = IMAGE_PACKER_SORT_BY_AREA;
+    for (int i = 0; i < PACKER_RECTANGLES; i++) {
+        packer.rects[i].input.width = data.packer_sizes[i][0];
+        packer.rects[i].input.height = data.packer_sizes[i][1];
+    }
+    image_packer_pack(&packer);
+    image_packer_free(&packer);
+}
+
+static int load_xml_file(void)
+{
+    FILE *fp = fopen(data.xml_file, "rb");
+    if (!fp) {
+        return 0;
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    data.xml.data = size > 0 ? malloc(size) : 0;
+    if (!data.xml.data) {
+        fclose(fp);
+        return 0;
+    }
+    data.xml.size = (unsigned int) fread(data.xml.data, 1, size, fp);
+    fclose(fp);
+    return data.xml.size == (unsigned int) size;
+}
+
+static void bench_xml_parser(void)
+{
+    xml_parser_reset();
+    xml_parser_parse(data.xml.data, data.xml.size, 1);
+}
+
+static void run_xml_benchmark(void)
+{
+    if (!load_xml_file()) {
+        add_result("xml_parser_parse/assets", "Unable to read the assets XML file");
+        return;
+    }
+    if (xml_parser_init(ASSET_XML_ELEMENTS, ASSET_XML_TOTAL_ELEMENTS, 0)) {
+        run_benchmark("xml_parser_parse/assets", bench_xml_parser, data.xml.size);
+        xml_parser_free();
+    } else {
+        add_result("xml_parser_parse/assets", "Unable to initialize the XML parser");
+    }
+    free(data.xml.data);
+}
+
+static int init_game_without_display(void)
+{
+    // The simulation relies on the image ids of the game graphics, which are loaded into textures,
+    // so the game runs with a hidden window on the dummy video driver
+    if (SDL_VideoInit("dummy") != 0) {
+        return 0;
+    }
+    SDL_Window *window = SDL_CreateWindow("augustus-bench", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+        REPLAY_WINDOW_WIDTH, REPLAY_WINDOW_HEIGHT, SDL_WINDOW_HIDDEN);
+    if (!window || !platform_renderer_init(window)) {
+        return 0;
+    }
+    if (data.data_dir && !platform_file_manager_set_base_path(data.data_dir)) {
+        return 0;
+    }
+    return game_pre_init() && game_init();
+}
+
+static void run_replay_benchmark(void)
+{
+    if (data.filter && !strstr(REPLAY_BENCHMARK_NAME, data.filter)) {
+        return;
+    }
+    if (!init_game_without_display()) {
+        add_result(REPLAY_BENCHMARK_NAME, "Unable to load the game data");
+        return;
+    }
+    if (!game_replay_start_playback(data.replay_file)) {
+        add_result(REPLAY_BENCHMARK_NAME, "Unable to start the replay");
+        return;
+    }
+    clock_t cpu_start = clock();
+    uint64_t start = SDL_GetPerformanceCounter();
+    while (game_replay_is_playing()) {
+        game_replay_run_ticks();
+    }
+    uint64_t elapsed = SDL_GetPerformanceCounter() - start;
+    clock_t cpu_elapsed = clock() - cpu_start;
+
+    const replay_results *replay = game_replay_get_results();
+    if (!replay->ticks) {
+        add_result(REPLAY_BENCHMARK_NAME, "The replay has no ticks");
+        return;
+    }
+    // Timings of a simulation that no longer does what was recorded are not comparable
+    if (replay->has_recorded_checksum && replay->checksum != replay->recorded_checksum) {
+        add_result(REPLAY_BENCHMARK_NAME, "The replay diverged from the recording");
+        return;
+    }
+    // One iteration is one game tick
+    add_result(REPLAY_BENCHMARK_NAME, 0);
+    benchmark_result *result = &data.results[data.num_results - 1];
+    result->iterations = replay->ticks;
+    result->real_time_ns = elapsed * 1e9 / SDL_GetPerformanceFrequency() / replay->ticks;
+    result->cpu_time_ns = cpu_elapsed * 1e9 / CLOCKS_PER_SEC / replay->ticks;
+    snprintf(result->label, BENCHMARK_NAME_MAX, "checksum:%08x", (unsigned int) replay->checksum);
+}
+
+static void print_json(void)
+{
+    printf("{\n");
+    printf("  \"context\": {\n");
+    printf("    \"executable\": \"augustus-bench\",\n");
+    printf("    \"num_cpus\": %d,\n", SDL_GetCPUCount());
+#ifdef NDEBUG
+    printf("    \"library_build_type\": \"release\"\n");
+#else
+    printf("    \"library_build_type\": \"debug\"\n");
+#endif
+    printf("  },\n");
+    printf("  \"benchmarks\": [\n");
+    for (int i = 0; i < data.num_results; i++) {
+        const benchmark_result *result = &data.results[i];
+        printf("    {\n");
+        printf("      \"name\": \"%s\",\n", result->name);
+        printf("      \"run_name\": \"%s\",\n", result->name);
+        printf("      \"run_type\": \"iteration\",\n");
+        if (result->error) {
+            printf("      \"error_occurred\": true,\n");
+            printf("      \"error_message\": \"%s\"\n", result->error);
+        } else {
+            printf("      \"iterations\": %u,\n", result->iterations);
+            printf("      \"real_time\": %.3f,\n", result->real_time_ns);
+            printf("      \"cpu_time\": %.3f,\n", result->cpu_time_ns);
+            if (result->bytes_per_second > 0) {
+                printf("      \"bytes_per_second\": %.3f,\n", result->bytes_per_second);
+            }
+            if (*result->label) {
+                printf("      \"label\": \"%s\",\n", result->label);
+            }
+            printf("      \"time_unit\": \"ns\"\n");
+        }
+        printf("    }%s\n", i + 1 < data.num_results ? "," : "");
+    }
+    printf("  ]\n");
+    printf("}\n");
+}
+
+static void print_csv(void)
+{
+    printf("name,iterations,real_time,cpu_time,time_unit,bytes_per_second,items_per_second,label,"
+        "error_occurred,error_message\n");
+    for (int i = 0; i < data.num_results; i++) {
+        const benchmark_result *result = &data.results[i];
+        if (result->error) {
+            printf("\"%s\",,,,,,,,true,\"%s\"\n", result->name, result->error);
+        } else if (result->bytes_per_second > 0) {
+            printf("\"%s\",%u,%.3f,%.3f,ns,%.3f,,,,\n", result->name, result->iterations,
+                result->real_time_ns, result->cpu_time_ns, result->bytes_per_second);
+        } else {
+            printf("\"%s\",%u,%.3f,%.3f,ns,,,\"%s\",,\n", result->name, result->iterations,
+                result->real_time_ns, result->cpu_time_ns, result->label);
+        }
+    }
+}
+
+static void print_usage(void)
+{
+    fprintf(stderr, "Usage: augustus-bench [ARGS]\n");
+    fprintf(stderr, "ARGS may be:\n");
+    fprintf(stderr, "--format json|csv\n");
+    fprintf(stderr, "          Output format, json by default\n");
+    fprintf(stderr, "--filter TEXT\n");
+    fprintf(stderr, "          Only runs the benchmarks whose name contains TEXT\n");
+    fprintf(stderr, "--min-time MILLIS\n");
+    fprintf(stderr, "          Minimum time to run each benchmark for, %d by default\n", DEFAULT_MIN_TIME_MILLIS);
+    fprintf(stderr, "--save FILE\n");
+    fprintf(stderr, "          Saved game to run the map benchmarks on, in addition to a synthetic map\n");
+    fprintf(stderr, "--xml FILE\n");
+    fprintf(stderr, "          Assets XML file to parse, %s by default\n", DEFAULT_XML_FILE);
+    fprintf(stderr, "--replay FILE\n");
+    fprintf(stderr, "          Replay to play back as fast as possible, recorded with the startreplay command\n");
+    fprintf(stderr, "--data-dir DIR\n");
+    fprintf(stderr, "          Caesar 3 directory to load the game data from for the replay, the working directory\n");
+    fprintf(stderr, "          by default. A relative replay path is relative to this directory\n");
+}
+
+static int parse_arguments(int argc, char **argv)
+{
+    data.format = OUTPUT_JSON;
+    data.xml_file = DEFAULT_XML_FILE;
+    data.min_time_millis = DEFAULT_MIN_TIME_MILLIS;
+    for (int i = 1; i < argc; i++) {
+        int has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--format") == 0 && has_value) {
+            i++;
+            if (strcmp(argv[i], "csv") == 0) {
+                data.format = OUTPUT_CSV;
+            } else if (strcmp(argv[i], "json") != 0) {
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--filter") == 0 && has_value) {
+            data.filter = argv[++i];
+        } else if (strcmp(argv[i], "--min-time") == 0 && has_value) {
+            data.min_time_millis = (unsigned int) strtoul(argv[++i], 0, 10);
+        } else if (strcmp(argv[i], "--save") == 0 && has_value) {
+            data.save_file = argv[++i];
+        } else if (strcmp(argv[i], "--xml") == 0 && has_value) {
+            data.xml_file = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && has_value) {
+            data.replay_file = argv[++i];
+        } else if (strcmp(argv[i], "--data-dir") == 0 && has_value) {
+            data.data_dir = argv[++i];
+        } else {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    if (!parse_arguments(argc, argv)) {
+        print_usage();
+        return 1;
+    }
+
+    create_synthetic_map();
+    run_map_benchmarks("synthetic", 0);
+    if (data.save_file) {
+        if (load_real_map()) {
+            run_map_benchmarks("save", 1);
+        } else {
+            add_result("map/save", "Unable to load the saved game");
+        }
+    }
+    run_zlib_benchmarks();
+
+    prepare_packer_sizes();
+    run_benchmark("image_packer_pack/synthetic", bench_image_packer, 0);
+
+    run_xml_benchmark();
+
+    // Last, as it changes the working directory and the whole game state
+    if (data.replay_file) {
+        run_replay_benchmark();
+    }
+
+    if (data.format == OUTPUT_CSV) {
+        print_csv();
+    } else {
+        print_json();
+    }
+    return 0;
+}
@@ -0,0 +1,39 @@
+#include "game/system.h"
+
+#include "SDL.h"
+
+#include <stdlib.h>
+
+// The benchmark has no window, so the system functions normally provided by platform/augustus.c do nothing
+
+int system_supports_select_folder_dialog(void)
+{
+    return 0;
+}
+
+const char *system_show_select_folder_dialog(const char *title, const char *default_path)
+{
+    return 0;
+}
+
+void system_exit(void)
+{
+    exit(0);
+}
+
+void system_resize(int width, int height)
+{
+}
+
+void system_center(void)
+{
+}
+
+void system_set_fullscreen(int fullscreen)
+{
+}
+
+uint64_t system_get_ticks(void)
+{
+    return SDL_GetTicks();
+}
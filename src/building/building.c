@@ -9,16 +9,20 @@
 #include "building/distribution.h"
 #include "building/industry.h"
 #include "building/granary.h"
+#include "building/house_evolution.h"
+#include "building/house_service.h"
 #include "building/menu.h"
 #include "building/monument.h"
 #include "building/properties.h"
 #include "building/rotation.h"
+#include "building/spatial.h"
 #include "building/state.h"
 #include "building/storage.h"
 #include "building/type.h"
 #include "building/variant.h"
 #include "building/warehouse.h"
 #include "city/buildings.h"
+#include "city/culture.h"
 #include "city/finance.h"
 #include "city/population.h"
 #include "city/warning.h"
@@ -30,6 +34,7 @@
 #include "figure/formation_legion.h"
 #include "figuretype/missile.h"
 #include "game/difficulty.h"
+#include "game/replay.h"
 #include "game/save_version.h"
 #include "game/undo.h"
 #include "map/building.h"
@@ -53,6 +58,8 @@ static struct {
     array(building) buildings;
     building *first_of_type[BUILDING_TYPE_MAX];
     building *last_of_type[BUILDING_TYPE_MAX];
+    building_hot_data *hot;
+    unsigned int hot_capacity;
 } data;
 
 static struct {
@@ -66,6 +73,58 @@ building *building_get(unsigned int id)
     return array_item(data.buildings, id);
 }
 
+const building_hot_data *building_get_hot_data(void)
+{
+    return data.hot;
+}
+
+static int ensure_hot_data_capacity(unsigned int size)
+{
+    if (size <= data.hot_capacity) {
+        return 1;
+    }
+    unsigned int new_capacity = ((size - 1) / BUILDING_ARRAY_SIZE_STEP + 1) * BUILDING_ARRAY_SIZE_STEP;
+    building_hot_data *hot = realloc(data.hot, new_capacity * sizeof(building_hot_data));
+    if (!hot) {
+        return 0;
+    }
+    memset(&hot[data.hot_capacity], 0, (new_capacity - data.hot_capacity) * sizeof(building_hot_data));
+    data.hot = hot;
+    data.hot_capacity = new_capacity;
+    return 1;
+}
+
+static void update_hot_data(const building *b)
+{
+    data.hot[b->id].type = b->type;
+    data.hot[b->id].state = b->state;
+}
+
+static void rebuild_hot_data(void)
+{
+    if (data.hot) {
+        memset(data.hot, 0, data.hot_capacity * sizeof(building_hot_data));
+    }
+    if (!ensure_hot_data_capacity(data.buildings.size)) {
+        log_error("Unable to allocate enough memory for the building hot data. The game will now crash.", 0, 0);
+        return;
+    }
+    building *b;
+    array_foreach(data.buildings, b)
+    {
+        update_hot_data(b);
+    }
+}
+
+void building_set_state(building *b, unsigned char state)
+{
+    b->state = state;
+    if (b->id < data.hot_capacity) {
+        data.hot[b->id].state = state;
+    }
+    city_culture_update_building(b);
+}
+
 int building_can_repair_type(building_type type)
 {
     if (building_monument_is_limited(type) || type == BUILDING_AQUEDUCT || building_is_fort(type)) {
@@ -212,14 +271,14 @@ building *building_create(building_type type, int x, int y)
 {
     building *b;
     array_new_item_after_index(data.buildings, 1, b);
-    if (!b) {
+    if (!b || !ensure_hot_data_capacity(data.buildings.size)) {
         city_warning_show(WARNING_DATA_LIMIT_REACHED, NEW_WARNING_SLOT);
         return array_first(data.buildings);
     }
 
     const building_properties *props = building_properties_for_type(type);
 
-    b->state = BUILDING_STATE_CREATED;
+    building_set_state(b, BUILDING_STATE_CREATED);
     b->faction_id = 1;
     b->type = type;
     b->size = props->size;
@@ -288,6 +347,11 @@ building *building_create(building_type type, int x, int y)
     b->fire_proof = props->fire_proof;
     b->is_close_to_water = building_is_close_to_water(b);
 
+    update_hot_data(b);
+    building_spatial_update(b);
+    house_service_track(b);
+    city_culture_update_building(b);
+
     return b;
 }
 
@@ -299,15 +363,22 @@ void building_change_type(building *b, building_type type)
     remove_adjacent_types(b);
     b->type = type;
     fill_adjacent_types(b);
+    update_hot_data(b);
+    building_spatial_update(b);
+    house_service_track(b);
+    city_culture_update_building(b);
 }
 
 static void building_delete(building *b)
 {
     building_clear_related_data(b);
     remove_adjacent_types(b);
+    building_spatial_remove(b);
     int id = b->id;
     memset(b, 0, sizeof(building));
     b->id = id;
+    update_hot_data(b);
+    city_culture_update_building(b);
 
     array_trim(data.buildings);
 }
@@ -338,6 +409,11 @@ building *building_restore_from_undo(building *to_restore)
         data.buildings.size = b->id + 1;
     }
     fill_adjacent_types(b);
+    if (ensure_hot_data_capacity(data.buildings.size)) {
+        update_hot_data(b);
+    }
+    building_spatial_update(b);
+    house_service_track(b);
     return b;
 }
 
@@ -362,8 +438,9 @@ int building_is_still_burning(building *b)
     int grid_offset = hot ? b->data.rubble.og_grid_offset : b->grid_offset;
     int size = hot ? b->data.rubble.og_size : b->size;
     grid_slice *b_area = map_grid_get_grid_slice_square(grid_offset, size);
-    for (int i = 0; i < b_area->size; i++) {
-        int offset = b_area->grid_offsets[i];
+    grid_slice_iterator it = map_grid_slice_iterate(b_area);
+    while (map_grid_slice_next(&it)) {
+        int offset = it.grid_offset;
         if (map_has_figure_at(offset)) {  // also check for prefects on the tile - their presence prevents rebuilding
             return 1;
         }
@@ -509,12 +586,12 @@ static int warehouse_repair(building *b)
     new_building->subtype.orientation = og_orientation;
     map_building_set_rubble_grid_building_id(standard_grid_offset, 0, 3); // remove rubble marker
     building_data_transfer_paste(new_building, 1);
-    new_building->state = BUILDING_STATE_CREATED;
+    building_set_state(new_building, BUILDING_STATE_CREATED);
     building_data_transfer_restore_and_clear_backup();
     figure_create_explosion_cloud(
         map_grid_offset_to_x(standard_grid_offset), map_grid_offset_to_y(standard_grid_offset), 3, 1);
 
-    b->state = BUILDING_STATE_DELETED_BY_GAME; // mark old building as deleted
+    building_set_state(b, BUILDING_STATE_DELETED_BY_GAME); // mark old building as deleted
     game_undo_disable(); // not accounting for undoing repairs
     return full_cost;
 }
@@ -575,8 +652,9 @@ int building_repair(building *b)
         success = building_construction_fill_vacant_lots(grid_slice);
     } else if (type_to_place == BUILDING_WALL || type_to_place == BUILDING_TOWER) {
         wall = 1;
-        for (int i = 0; i < grid_slice->size; i++) {
-            success = building_construction_place_wall(grid_slice->grid_offsets[i]);
+        grid_slice_iterator it = map_grid_slice_iterate(grid_slice);
+        while (map_grid_slice_next(&it)) {
+            success = building_construction_place_wall(it.grid_offset);
             placement_cost += model_get_building(BUILDING_WALL)->cost * success;
             if (!success) {
                 break; // force failure if any wall/tower placement failed
@@ -615,39 +693,61 @@ int building_repair(building *b)
     new_building->subtype.orientation = og_orientation;
     map_building_set_rubble_grid_building_id(grid_offset, 0, size); // remove rubble marker
     building_data_transfer_paste(new_building, 1);
-    new_building->state = BUILDING_STATE_CREATED;
+    building_set_state(new_building, BUILDING_STATE_CREATED);
     building_data_transfer_restore_and_clear_backup();
     figure_create_explosion_cloud(new_building->x, new_building->y, og_size, 1);
     if (wall) {
         map_tiles_update_all_walls(); // towers affect wall connections
     }
-    b->state = BUILDING_STATE_DELETED_BY_GAME; // mark old building as deleted
+    building_set_state(b, BUILDING_STATE_DELETED_BY_GAME); // mark old building as deleted
     game_undo_disable(); // not accounting for undoing repairs
     return full_cost;
 }
 
+static void update_area_after_removal(int x, int y, int size, int wall_recalc, int road_recalc, int aqueduct_recalc)
+{
+    if (wall_recalc) {
+        map_tiles_update_area_walls(x, y, size + 2);
+    }
+    if (aqueduct_recalc) {
+        map_tiles_update_region_aqueducts(x - 1, y - 1, x + size, y + size);
+    }
+    if (road_recalc) {
+        map_tiles_update_area_roads(x, y, size + 2);
+        map_tiles_update_area_highways(x - 1, y - 1, size + 2);
+    }
+}
+
 void building_update_state(void)
 {
     int land_recalc = 0;
-    int wall_recalc = 0;
-    int road_recalc = 0;
-    int aqueduct_recalc = 0;
+    int bridge_removed = 0;
     building *b;
     array_foreach(data.buildings, b)
     {
+        if (data.hot[array_index].state == BUILDING_STATE_UNUSED) {
+            continue;
+        }
         if (b->state == BUILDING_STATE_CREATED) {
-            b->state = BUILDING_STATE_IN_USE;
+            building_set_state(b, BUILDING_STATE_IN_USE);
         }
         if (b->state == BUILDING_STATE_IN_USE && b->house_size) {
             continue;
         }
         if (b->state == BUILDING_STATE_UNDO || b->state == BUILDING_STATE_DELETED_BY_PLAYER) {
+            int wall_recalc = 0;
+            int road_recalc = 0;
+            int aqueduct_recalc = 0;
             if (b->type == BUILDING_TOWER || b->type == BUILDING_GATEHOUSE) {
                 wall_recalc = 1;
                 road_recalc = 1;
             } else if (b->type == BUILDING_RESERVOIR) {
                 aqueduct_recalc = 1;
-            } else if (b->type == BUILDING_GRANARY || building_type_is_bridge(b->type)) {
+            } else if (building_type_is_bridge(b->type)) {
+                // A bridge has size 1 but spans many tiles, and its tiles are already gone,
+                // so the roads at its far end can only be found by refreshing all of them
+                bridge_removed = 1;
+            } else if (b->type == BUILDING_GRANARY) {
                 road_recalc = 1;
             } else if ((b->type >= BUILDING_GRAND_TEMPLE_CERES && b->type <= BUILDING_GRAND_TEMPLE_VENUS) ||
                 b->type == BUILDING_PANTHEON || b->type == BUILDING_LIGHTHOUSE) {
@@ -661,14 +761,19 @@ void building_update_state(void)
                 road_recalc = 1;
             }
             land_recalc = 1;
+            int x = b->x;
+            int y = b->y;
+            int size = b->size;
             building_delete(b);
+            // Only the tiles around the removed building can change their connections
+            update_area_after_removal(x, y, size, wall_recalc, road_recalc, aqueduct_recalc);
         } else if (b->state == BUILDING_STATE_RUBBLE) {
             if (b->house_size) {
                 city_population_remove_home_removed(b->house_population);
                 b->house_population = 0;
             }
             if (building_is_fort(b->type) || b->type == BUILDING_FORT_GROUND) {
-                b->state = BUILDING_STATE_DELETED_BY_GAME;
+                building_set_state(b, BUILDING_STATE_DELETED_BY_GAME);
                 map_building_tiles_remove(b->id, b->x, b->y);
                 map_building_set_rubble_grid_building_id(b->grid_offset, 0, b->size);
             }
@@ -688,16 +793,10 @@ void building_update_state(void)
             }
         }
     }
-    if (wall_recalc) {
-        map_tiles_update_all_walls();
-    }
-    if (aqueduct_recalc) {
-        map_tiles_update_all_aqueducts(0);
-    }
     if (land_recalc) {
         map_routing_update_land();
     }
-    if (road_recalc) {
+    if (bridge_removed) {
         map_tiles_update_all_roads();
         map_tiles_update_all_highways();
     }
@@ -708,7 +807,7 @@ void building_update_desirability(void)
     building *b;
     array_foreach(data.buildings, b)
     {
-        if (b->state != BUILDING_STATE_IN_USE) {
+        if (data.hot[array_index].state != BUILDING_STATE_IN_USE) {
             continue;
         }
 
@@ -736,6 +835,7 @@ void building_update_desirability(void)
         }
 
         b->desirability = (int8_t) desirability;
+        city_culture_update_building(b);
     }
 }
 
@@ -874,11 +974,12 @@ int building_is_fort(building_type type)
 
 int building_mothball_toggle(building *b)
 {
+    game_replay_record_action(REPLAY_ACTION_MOTHBALL, b->id, 0, 0);
     if (b->state == BUILDING_STATE_IN_USE) {
-        b->state = BUILDING_STATE_MOTHBALLED;
+        building_set_state(b, BUILDING_STATE_MOTHBALLED);
         b->num_workers = 0;
     } else if (b->state == BUILDING_STATE_MOTHBALLED) {
-        b->state = BUILDING_STATE_IN_USE;
+        building_set_state(b, BUILDING_STATE_IN_USE);
     }
     return b->state;
 }
@@ -887,11 +988,11 @@ int building_mothball_set(building *b, int mothball)
 {
     if (mothball) {
         if (b->state == BUILDING_STATE_IN_USE) {
-            b->state = BUILDING_STATE_MOTHBALLED;
+            building_set_state(b, BUILDING_STATE_MOTHBALLED);
             b->num_workers = 0;
         }
     } else if (b->state == BUILDING_STATE_MOTHBALLED) {
-        b->state = BUILDING_STATE_IN_USE;
+        building_set_state(b, BUILDING_STATE_IN_USE);
     }
     return b->state;
 
@@ -985,6 +1086,11 @@ void building_clear_all(void)
         !array_next(data.buildings)) { // Ignore first building
         log_error("Unable to allocate enough memory for the building array. The game will now crash.", 0, 0);
     }
+    rebuild_hot_data();
+    building_spatial_clear();
+    house_service_reset_tracking();
+    building_house_reset_evolution_cache();
+    city_culture_reset_counters();
 
     extra.created_sequence = 0;
     extra.incorrect_houses = 0;
@@ -1045,6 +1151,10 @@ void building_load_state(buffer *buf, buffer *sequence, buffer *corrupt_houses,
 
     memset(data.first_of_type, 0, sizeof(data.first_of_type));
     memset(data.last_of_type, 0, sizeof(data.last_of_type));
+    building_spatial_clear();
+    house_service_reset_tracking();
+    building_house_reset_evolution_cache();
+    city_culture_reset_counters();
 
     int highest_id_in_use = 0;
 
@@ -1054,6 +1164,7 @@ void building_load_state(buffer *buf, buffer *sequence, buffer *corrupt_houses,
         if (b->state != BUILDING_STATE_UNUSED) {
             highest_id_in_use = i;
             fill_adjacent_types(b);
+            building_spatial_update(b);
         }
     }
 
@@ -1064,6 +1175,7 @@ void building_load_state(buffer *buf, buffer *sequence, buffer *corrupt_houses,
     }
 
     data.buildings.size = highest_id_in_use + 1;
+    rebuild_hot_data();
 
     extra.created_sequence = buffer_read_i32(sequence);
 
@@ -205,8 +205,32 @@ typedef struct building {
     unsigned char accepted_goods[RESOURCE_MAX];
 } building;
 
+/**
+ * Compact copy of the building fields read by full building scans, indexed by building id.
+ * Scans can check these to skip buildings without pulling the whole building struct into the cache.
+ */
+typedef struct {
+    unsigned short type;
+    unsigned char state;
+} building_hot_data;
+
 building *building_get(unsigned int id);
 
+/**
+ * Gets the hot data array for all buildings, valid for ids up to building_count()
+ * @return The hot data array, indexed by building id
+ * @note The array may be reallocated when a building is created, so get it again after creating buildings
+ */
+const building_hot_data *building_get_hot_data(void);
+
+/**
+ * Changes the state of a building. Always use this instead of setting b->state directly,
+ * so that the hot data stays in sync.
+ * @param b The building
+ * @param state The new state, one of BUILDING_STATE_*
+ */
+void building_set_state(building *b, unsigned char state);
+
 int building_dist(int x, int y, int w, int h, building *b);
 
 void building_get_from_buffer(buffer *buf, int id, building *b, int includes_building_size, int save_version,
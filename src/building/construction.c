@@ -23,6 +23,7 @@
 #include "core/config.h"
 #include "core/image.h"
 #include "figure/formation.h"
+#include "game/replay.h"
 #include "game/undo.h"
 #include "graphics/window.h"
 #include "map/aqueduct.h"
@@ -671,6 +672,7 @@ int building_construction_in_progress(void)
 
 void building_construction_start(int x, int y, int grid_offset)
 {
+    game_replay_set_construction_start(x, y);
     if (data.type == BUILDING_HIGHWAY) {
         building_construction_offset_start_from_orientation(&x, &y, 2);
         grid_offset = map_grid_offset(x, y);
@@ -796,6 +798,7 @@ void building_construction_update(int x, int y, int grid_offset)
 {
     building_type type = building_construction_type();
     if (grid_offset) {
+        game_replay_set_construction_end(x, y);
         if (type == BUILDING_HIGHWAY) {
             building_construction_offset_start_from_orientation(&x, &y, 2);
             grid_offset = map_grid_offset(x, y);
@@ -984,7 +987,7 @@ figure_type building_construction_nearby_enemy_type(grid_slice *slice)
         return FIGURE_NONE;
     }
 
-    for (int i = 1; i < figure_count(); i++) {
+    for (unsigned int i = figure_next_live_id(0); i; i = figure_next_live_id(i)) {
         figure *f = figure_get(i);
         if (config_get(CONFIG_GP_CH_WOLVES_BLOCK)) {
             if (f->state != FIGURE_STATE_ALIVE || (!figure_is_enemy(f) && f->type != FIGURE_WOLF)) {
@@ -997,8 +1000,9 @@ figure_type building_construction_nearby_enemy_type(grid_slice *slice)
         int distance = f->type == FIGURE_WOLF ? 6 : 12;
 
         // Check if figure is within distance of any tile in the grid slice
-        for (int j = 0; j < slice->size; j++) {
-            int grid_offset = slice->grid_offsets[j];
+        grid_slice_iterator it = map_grid_slice_iterate(slice);
+        while (map_grid_slice_next(&it)) {
+            int grid_offset = it.grid_offset;
             int tile_x = map_grid_offset_to_x(grid_offset);
             int tile_y = map_grid_offset_to_y(grid_offset);
 
@@ -1037,6 +1041,7 @@ void building_construction_place(void)
     if (!type) {
         return;
     }
+    game_replay_record_construction(type);
 
     if (city_finance_out_of_money()) {
         if (type == BUILDING_WELL && building_count_total(BUILDING_WELL) < 5) {
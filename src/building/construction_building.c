@@ -12,6 +12,7 @@
 #include "building/monument.h"
 #include "building/properties.h"
 #include "building/rotation.h"
+#include "building/spatial.h"
 #include "building/storage.h"
 #include "building/variant.h"
 #include "city/buildings.h"
@@ -73,8 +74,9 @@ static void add_fort(int type, building *fort)
 int building_construction_prepare_terrain(grid_slice *grid_slice, clear_mode clear_mode, cost_calculation cost)
 {
     int total_cost = 0;
-    for (int i = 0; i < grid_slice->size; i++) {
-        int g_offset = grid_slice->grid_offsets[i];
+    grid_slice_iterator it = map_grid_slice_iterate(grid_slice);
+    while (map_grid_slice_next(&it)) {
+        int g_offset = it.grid_offset;
         int terrain_mask_to_remove = 0;
         switch (clear_mode) { //ugly but efficient
             case CLEAR_MODE_FORCE:
@@ -107,9 +109,10 @@ int building_construction_prepare_terrain(grid_slice *grid_slice, clear_mode cle
 static int check_gatehouse_tiles(int grid_offset)
 {
     grid_slice *slice = map_grid_get_grid_slice_square(grid_offset, 2);
-    for (int i = 0; i < slice->size; i++) {
-        if (map_terrain_is(slice->grid_offsets[i], TERRAIN_BUILDING)) {
-            if (map_terrain_is(slice->grid_offsets[i], TERRAIN_WALL)) {
+    grid_slice_iterator it = map_grid_slice_iterate(slice);
+    while (map_grid_slice_next(&it)) {
+        if (map_terrain_is(it.grid_offset, TERRAIN_BUILDING)) {
+            if (map_terrain_is(it.grid_offset, TERRAIN_WALL)) {
                 continue;
             } else {
                 return 0;
@@ -181,6 +184,7 @@ static void add_warehouse(building *b, int orientation)
     b->x = b->x + x_offset[tower];
     b->y = b->y + y_offset[tower];
     b->grid_offset = map_grid_offset(b->x, b->y);
+    building_spatial_update(b);
     game_undo_adjust_building(b);
 
     building_get(prev)->next_part_building_id = 0;
@@ -406,8 +410,9 @@ int building_construction_is_warehouse_corner(int tile_no)
 int building_construction_fill_vacant_lots(grid_slice *area)
 {
     int items_placed = 0;
-    for (int i = 0; i < area->size; i++) {
-        int grid_offset = area->grid_offsets[i];
+    grid_slice_iterator it = map_grid_slice_iterate(area);
+    while (map_grid_slice_next(&it)) {
+        int grid_offset = it.grid_offset;
         int x = map_grid_offset_to_x(grid_offset);
         int y = map_grid_offset_to_y(grid_offset);
         int success = building_construction_place_building(BUILDING_HOUSE_VACANT_LOT, x, y, 1);
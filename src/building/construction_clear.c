@@ -8,6 +8,7 @@
 #include "core/string.h"
 #include "figure/roamer_preview.h"
 #include "figuretype/migrant.h"
+#include "game/replay.h"
 #include "game/undo.h"
 #include "graphics/color.h"
 #include "graphics/window.h"
@@ -36,6 +37,7 @@ static struct {
     int repair_confirmed;
     int repair_cost;
     int repairable_buildings[1000];
+    void (*pending)(int accepted, int checked);
 } confirm;
 static int repair_land_confirmed(int measure_only, int x_start, int y_start, int x_end, int y_end, int *buildings_count);
 static building *get_deletable_building(int grid_offset)
@@ -133,7 +135,7 @@ static int clear_land_confirmed(int measure_only, int x_start, int y_start, int
                     items_placed++;
                     game_undo_add_building(b);
                 }
-                b->state = BUILDING_STATE_DELETED_BY_PLAYER;
+                building_set_state(b, BUILDING_STATE_DELETED_BY_PLAYER);
                 b->is_deleted = 1;
                 building *space = b;
                 for (int i = 0; i < 9; i++) {
@@ -142,7 +144,7 @@ static int clear_land_confirmed(int measure_only, int x_start, int y_start, int
                     }
                     space = building_get(space->prev_part_building_id);
                     game_undo_add_building(space);
-                    space->state = BUILDING_STATE_DELETED_BY_PLAYER;
+                    building_set_state(space, BUILDING_STATE_DELETED_BY_PLAYER);
                 }
                 space = b;
                 for (int i = 0; i < 9; i++) {
@@ -151,7 +153,7 @@ static int clear_land_confirmed(int measure_only, int x_start, int y_start, int
                         break;
                     }
                     game_undo_add_building(space);
-                    space->state = BUILDING_STATE_DELETED_BY_PLAYER;
+                    building_set_state(space, BUILDING_STATE_DELETED_BY_PLAYER);
                 }
             } else if (map_terrain_is(grid_offset, TERRAIN_AQUEDUCT)) {
                 map_terrain_remove(grid_offset, TERRAIN_CLEARABLE & ~TERRAIN_HIGHWAY);
@@ -183,13 +185,13 @@ static int clear_land_confirmed(int measure_only, int x_start, int y_start, int
                                     rubble_building->type == BUILDING_BURNING_RUIN) {
                                 int ruins_left = map_building_ruins_left(rubble_id);
                                 if (!ruins_left) { //dont remove buildings until their last rubble is gone
-                                    rubble_building->state = BUILDING_STATE_DELETED_BY_GAME;
+                                    building_set_state(rubble_building, BUILDING_STATE_DELETED_BY_GAME);
                                 }
                             } else if (rubble_building->state == BUILDING_STATE_UNUSED) {
                                 // intentional fallthrough - unused buildings are corrupt if they exist on the grid. 
                                 // dont change state, just remove reference on the grid - addressed after if {} block 
                             } else {
-                                rubble_building->state = BUILDING_STATE_DELETED_BY_GAME;
+                                building_set_state(rubble_building, BUILDING_STATE_DELETED_BY_GAME);
                             }
                         }
                         map_building_set_rubble_grid_building_id(grid_offset, 0, 1); // remove rubble marker
@@ -234,8 +236,20 @@ static int clear_land_confirmed(int measure_only, int x_start, int y_start, int
     return items_placed;
 }
 
+static void confirmation_answered(int accepted)
+{
+    confirm.pending = 0;
+    game_replay_record_action(REPLAY_ACTION_CLEAR_CONFIRMATION, accepted, 0, 0);
+}
+
+static void ask_confirmation(void (*callback)(int accepted, int checked))
+{
+    confirm.pending = callback;
+}
+
 static void confirm_delete_fort(int accepted, int checked)
 {
+    confirmation_answered(accepted);
     if (accepted == 1) {
         confirm.fort_confirmed = 1;
     } else {
@@ -246,6 +260,7 @@ static void confirm_delete_fort(int accepted, int checked)
 
 static void confirm_delete_bridge(int accepted, int checked)
 {
+    confirmation_answered(accepted);
     if (accepted == 1) {
         confirm.bridge_confirmed = 1;
     } else {
@@ -256,6 +271,7 @@ static void confirm_delete_bridge(int accepted, int checked)
 
 static void confirm_delete_monument(int accepted, int checked)
 {
+    confirmation_answered(accepted);
     if (accepted == 1) {
         confirm.monument_confirmed = 1;
     } else {
@@ -266,6 +282,7 @@ static void confirm_delete_monument(int accepted, int checked)
 
 static void confirm_repair_buildings(int accepted, int checked)
 {
+    confirmation_answered(accepted);
     if (accepted == 1) {
         confirm.repair_confirmed = 1;
     } else {
@@ -276,8 +293,16 @@ static void confirm_repair_buildings(int accepted, int checked)
     }
 }
 
+void building_construction_clear_confirm(int accepted)
+{
+    if (confirm.pending) {
+        confirm.pending(accepted, 0);
+    }
+}
+
 int building_construction_clear_land(int measure_only, int x_start, int y_start, int x_end, int y_end)
 {
+    confirm.pending = 0;
     confirm.fort_confirmed = 0;
     confirm.bridge_confirmed = 0;
     confirm.monument_confirmed = 0;
@@ -319,14 +344,25 @@ int building_construction_clear_land(int measure_only, int x_start, int y_start,
     confirm.y_start = y_start;
     confirm.x_end = x_end;
     confirm.y_end = y_end;
+    // A replay plays back the recorded answer instead of showing the dialog
     if (ask_confirm_fort) {
-        window_popup_dialog_show(POPUP_DIALOG_DELETE_FORT, confirm_delete_fort, 2);
+        ask_confirmation(confirm_delete_fort);
+        if (!game_replay_is_playing()) {
+            window_popup_dialog_show(POPUP_DIALOG_DELETE_FORT, confirm_delete_fort, 2);
+        }
         return -1;
     } else if (ask_confirm_monument) {
-        window_popup_dialog_show_confirmation(translation_for(TR_CONFIRM_DELETE_MONUMENT), 0, 0, confirm_delete_monument);
+        ask_confirmation(confirm_delete_monument);
+        if (!game_replay_is_playing()) {
+            window_popup_dialog_show_confirmation(translation_for(TR_CONFIRM_DELETE_MONUMENT), 0, 0,
+                confirm_delete_monument);
+        }
         return -1;
     } else if (ask_confirm_bridge) {
-        window_popup_dialog_show(POPUP_DIALOG_DELETE_BRIDGE, confirm_delete_bridge, 2);
+        ask_confirmation(confirm_delete_bridge);
+        if (!game_replay_is_playing()) {
+            window_popup_dialog_show(POPUP_DIALOG_DELETE_BRIDGE, confirm_delete_bridge, 2);
+        }
         return -1;
     } else {
         return clear_land_confirmed(measure_only, x_start, y_start, x_end, y_end);
@@ -359,8 +395,9 @@ static int repair_land_confirmed(int measure_only, int x_start, int y_start, int
     int repairable_buildings = 0;
     int repair_cost = 0;
     // Measure phase - count buildings and calculate cost
-    for (int i = 0; i < slice->size; i++) {
-        int grid_offset = slice->grid_offsets[i];
+    grid_slice_iterator it = map_grid_slice_iterate(slice);
+    while (map_grid_slice_next(&it)) {
+        int grid_offset = it.grid_offset;
         if (measure_only) {
             map_property_mark_deleted(grid_offset);
         }
@@ -399,6 +436,7 @@ static int repair_land_confirmed(int measure_only, int x_start, int y_start, int
 
 int building_construction_repair_land(int measure_only, int x_start, int y_start, int x_end, int y_end, int *buildings_count)
 {
+    confirm.pending = 0;
     confirm.repair_confirmed = 0;
     memset(confirm.repairable_buildings, 0, sizeof(confirm.repairable_buildings)); // reset the array
     if (measure_only) {
@@ -436,7 +474,10 @@ int building_construction_repair_land(int measure_only, int x_start, int y_start
         big_buffer[offset] = '\0';
         const uint8_t *pointer = big_buffer;
 
-        window_popup_dialog_show_confirmation(custom_text, pointer, 0, confirm_repair_buildings);
+        ask_confirmation(confirm_repair_buildings);
+        if (!game_replay_is_playing()) {
+            window_popup_dialog_show_confirmation(custom_text, pointer, 0, confirm_repair_buildings);
+        }
         return repair_cost;
     } else {
         return 0;// No buildings to repair, return 0 cost
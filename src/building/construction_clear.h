@@ -17,4 +17,10 @@ color_t building_construction_clear_color(void);
 
 int building_construction_repair_land(int measure_only, int x_start, int y_start, int x_end, int y_end, int *buildings_count);
 
+/**
+ * Answers the confirmation asked by the last clear or repair, if it is still waiting for one
+ * @param accepted 1 if the player accepted
+ */
+void building_construction_clear_confirm(int accepted);
+
 #endif // BUILDING_CONSTRUCTION_CLEAR_H
@@ -1,6 +1,7 @@
 #include "distribution.h"
 
 #include "building/properties.h"
+#include "building/spatial.h"
 #include "building/storage.h"
 #include "building/warehouse.h"
 #include "city/resource.h"
@@ -175,6 +176,54 @@ static int is_food_needed(const resource_storage_info info[RESOURCE_MAX])
     return 0;
 }
 
+typedef struct {
+    resource_storage_info *info;
+    building_type type;
+    int permission;
+    int road_network;
+    int x;
+    int y;
+    int w;
+    int h;
+} storage_search;
+
+static void check_granary(building *b, void *userdata)
+{
+    storage_search *search = userdata;
+    // Looter walkers have no type
+    if (search->type && is_invalid_destination(b, search->permission, search->road_network)) {
+        return;
+    }
+    int distance = building_dist(search->x, search->y, search->w, search->h, b);
+
+    for (int r = RESOURCE_MIN_FOOD; r < RESOURCE_MAX_FOOD; r++) {
+        if (search->info[r].needed) {
+            update_food_resource(search->info, r, b, distance);
+        }
+    }
+}
+
+static void check_warehouse(building *b, void *userdata)
+{
+    storage_search *search = userdata;
+    if (search->type && is_invalid_destination(b, search->permission, search->road_network)) {
+        return;
+    }
+    int distance = building_dist(search->x, search->y, search->w, search->h, b);
+
+    for (resource_type r = RESOURCE_MIN_NON_FOOD; r < RESOURCE_MAX_NON_FOOD; r++) {
+        if (resource_is_storable(r) && search->info[r].needed) {
+            update_good_resource(search->info, r, b, distance);
+        }
+    }
+}
+
+static int storage_search_range(building_type storage_type, int w, int h, int max_distance)
+{
+    // Distances are measured between the edges of both areas, while the spatial index uses the building's corner
+    return max_distance + (w > h ? w : h) + building_properties_for_type(storage_type)->size;
+}
+
 static int get_resource_storages(resource_storage_info info[RESOURCE_MAX],
     building_type type, int road_network, int x, int y, int w, int h, int max_distance)
 {
@@ -183,34 +232,15 @@ static int get_resource_storages(resource_storage_info info[RESOURCE_MAX],
         info[r].building_id = 0;
     }
 
-    int permission = building_storage_get_permission_from_building_type(type);
+    storage_search search = {
+        info, type, building_storage_get_permission_from_building_type(type), road_network, x, y, w, h
+    };
     if (is_food_needed(info)) {
-        for (building *b = building_first_of_type(BUILDING_GRANARY); b; b = b->next_of_type) {
-            // Looter walkers have no type
-            if (type && is_invalid_destination(b, permission, road_network)) {
-                continue;
-            }
-            int distance = building_dist(x, y, w, h, b);
-
-            for (int r = RESOURCE_MIN_FOOD; r < RESOURCE_MAX_FOOD; r++) {
-                if (info[r].needed) {
-                    update_food_resource(info, r, b, distance);
-                }
-            }
-        }
-    }
-    for (building *b = building_first_of_type(BUILDING_WAREHOUSE); b; b = b->next_of_type) {
-        if (type && is_invalid_destination(b, permission, road_network)) {
-            continue;
-        }
-        int distance = building_dist(x, y, w, h, b);
-
-        for (resource_type r = RESOURCE_MIN_NON_FOOD; r < RESOURCE_MAX_NON_FOOD; r++) {
-            if (resource_is_storable(r) && info[r].needed) {
-                update_good_resource(info, r, b, distance);
-            }
-        }
+        building_spatial_foreach_in_range(BUILDING_GRANARY, x, y,
+            storage_search_range(BUILDING_GRANARY, w, h, max_distance), check_granary, &search);
     }
+    building_spatial_foreach_in_range(BUILDING_WAREHOUSE, x, y,
+        storage_search_range(BUILDING_WAREHOUSE, w, h, max_distance), check_warehouse, &search);
 
     for (resource_type r = RESOURCE_MIN; r < RESOURCE_MAX; r++) {
         if (info[r].building_id) {
@@ -2,6 +2,7 @@
 
 #include "building/building.h"
 #include "building/monument.h"
+#include "city/culture.h"
 
 static const building_type ENTERTAINMENT_BUILDINGS[] = {
     BUILDING_THEATER,
@@ -32,6 +33,7 @@ void building_entertainment_run_shows(void)
                 ++shows;
             }
             b->data.entertainment.num_shows = shows;
+            city_culture_update_building(b);
         }
     }
 }
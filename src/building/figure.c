@@ -16,6 +16,7 @@
 #include "building/temple.h"
 #include "building/warehouse.h"
 #include "city/buildings.h"
+#include "city/culture.h"
 #include "city/data_private.h"
 #include "city/entertainment.h"
 #include "city/games.h"
@@ -472,6 +473,7 @@ static void set_amphitheater_graphic(building *b)
         return;
     }
     b->upgrade_level = b->desirability > 45;
+    city_culture_update_building(b);
     map_building_tiles_add(b->id, b->x, b->y, b->size, building_image_get(b), TERRAIN_BUILDING);
 }
 
@@ -525,6 +527,7 @@ static void set_theater_graphic(building *b)
         return;
     }
     b->upgrade_level = b->desirability > 45;
+    city_culture_update_building(b);
     map_building_tiles_add(b->id, b->x, b->y, b->size, building_image_get(b), TERRAIN_BUILDING);
 }
 
@@ -631,6 +634,7 @@ static void set_arena_graphic(building *b)
         return;
     }
     b->upgrade_level = b->desirability > 45;
+    city_culture_update_building(b);
     map_building_tiles_add(b->id, b->x, b->y, b->size, building_image_get(b), TERRAIN_BUILDING);
 }
 
@@ -954,6 +958,7 @@ static void set_school_graphic(building *b)
         return;
     }
     b->upgrade_level = b->desirability > 40;
+    city_culture_update_building(b);
     map_building_tiles_add(b->id, b->x, b->y, b->size, building_image_get(b), TERRAIN_BUILDING);
 }
 
@@ -1005,6 +1010,7 @@ static void set_library_graphic(building *b)
         return;
     }
     b->upgrade_level = b->desirability > 50;
+    city_culture_update_building(b);
     map_building_tiles_add(b->id, b->x, b->y, b->size, building_image_get(b), TERRAIN_BUILDING);
 }
 
@@ -1036,6 +1042,7 @@ static void set_academy_graphic(building *b)
         return;
     }
     b->upgrade_level = b->desirability >= 60;
+    city_culture_update_building(b);
     map_building_tiles_add(b->id, b->x, b->y, b->size, building_image_get(b), TERRAIN_BUILDING);
 }
 
@@ -1193,6 +1200,7 @@ static void set_tavern_graphic(building *b)
         return;
     }
     b->upgrade_level = b->desirability > 45;
+    city_culture_update_building(b);
     map_building_tiles_add(b->id, b->x, b->y, b->size, building_image_get(b), TERRAIN_BUILDING);
 }
 
@@ -1982,12 +1990,16 @@ void building_figure_generate(void)
     int patrician_generated = 0;
     calculate_houses_needed_per_beggar();
     for (int i = 1; i < building_count(); i++) {
+        const building_hot_data *hot = &building_get_hot_data()[i];
+        if (hot->state == BUILDING_STATE_UNUSED || hot->type == BUILDING_WAREHOUSE_SPACE) {
+            continue;
+        }
         building *b = building_get(i);
         if (b->state != BUILDING_STATE_IN_USE) {
             b->show_on_problem_overlay = 1;
             continue;
         }
-        if (b->type == BUILDING_WAREHOUSE_SPACE || (b->type == BUILDING_HIPPODROME && b->prev_part_building_id) ||
+        if ((b->type == BUILDING_HIPPODROME && b->prev_part_building_id) ||
             building_monument_is_unfinished_monument(b)) {
             continue;
         }
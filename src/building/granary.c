@@ -2,6 +2,7 @@
 
 #include "building/destruction.h"
 #include "building/properties.h"
+#include "building/spatial.h"
 #include "building/storage.h"
 #include "building/warehouse.h"
 #include "city/finance.h"
@@ -447,6 +448,36 @@ building *building_granary_get_granary_needing_food(building *source, int resour
     return 0;
 }
 
+typedef struct {
+    int resource;
+    int road_network_id;
+    int *understaffed;
+} storing_search;
+
+static int can_store_in_granary(building *b, void *userdata)
+{
+    storing_search *search = userdata;
+    return b->road_network_id == search->road_network_id &&
+        building_granary_accepts_storage(b, search->resource, search->understaffed);
+}
+
+static int granary_has_room(building *b, void *userdata)
+{
+    storing_search *search = userdata;
+    if (b->state != BUILDING_STATE_IN_USE || b->has_plague) {
+        return 0;
+    }
+    if (!b->has_road_access || b->distance_from_entry <= 0 || b->road_network_id != search->road_network_id) {
+        return 0;
+    }
+    int pct_workers = calc_percentage(b->num_workers, model_get_building(b->type)->laborers);
+    if (pct_workers < 100) {
+        return 0;
+    }
+    const building_storage *s = building_storage_get(b->storage_id);
+    return building_granary_maximum_receptible_amount(b, search->resource) && !s->empty_all;
+}
+
 int building_granary_for_storing(int x, int y, int resource, int road_network_id,
     int force_on_stockpile, int *understaffed, map_point *dst)
 {
@@ -459,20 +490,10 @@ int building_granary_for_storing(int x, int y, int resource, int road_network_id
     if (city_resource_is_stockpiled(resource) && !force_on_stockpile) {
         return 0;
     }
-    int min_dist = INFINITE;
-    int min_building_id = 0;
-    for (building *b = building_first_of_type(BUILDING_GRANARY); b; b = b->next_of_type) {
-        if (b->road_network_id != road_network_id ||
-            !building_granary_accepts_storage(b, resource, understaffed)) {
-            continue;
-        }
-        // there is room
-        int dist = calc_maximum_distance(b->x + 1, b->y + 1, x, y);
-        if (dist < min_dist) {
-            min_dist = dist;
-            min_building_id = b->id;
-        }
-    }
+    // Distances are measured to the center of the granary, so shift the point instead
+    storing_search search = { resource, road_network_id, understaffed };
+    int min_building_id = building_spatial_find_closest(BUILDING_GRANARY, x - 1, y - 1, INFINITE - 1,
+        can_store_in_granary, &search, 0);
     // deliver to center of granary
     building *min = building_get(min_building_id);
     map_point_store_result(min->x + 1, min->y + 1, dst);
@@ -491,31 +512,9 @@ int building_getting_granary_for_storing(int x, int y, int resource, int road_ne
     if (city_resource_is_stockpiled(resource)) {
         return 0;
     }
-    int min_dist = INFINITE;
-    int min_building_id = 0;
-    for (building *b = building_first_of_type(BUILDING_GRANARY); b; b = b->next_of_type) {
-        if (b->state != BUILDING_STATE_IN_USE || b->has_plague) {
-            continue;
-        }
-        if (!b->has_road_access || b->distance_from_entry <= 0 || b->road_network_id != road_network_id) {
-            continue;
-        }
-        int pct_workers = calc_percentage(b->num_workers, model_get_building(b->type)->laborers);
-        if (pct_workers < 100) {
-            continue;
-        }
-        const building_storage *s = building_storage_get(b->storage_id);
-        if (!building_granary_maximum_receptible_amount(b, resource) || s->empty_all) {
-            continue;
-        } else {
-            // there is room
-            int dist = calc_maximum_distance(b->x + 1, b->y + 1, x, y);
-            if (dist < min_dist) {
-                min_dist = dist;
-                min_building_id = b->id;
-            }
-        }
-    }
+    storing_search search = { resource, road_network_id, 0 };
+    int min_building_id = building_spatial_find_closest(BUILDING_GRANARY, x - 1, y - 1, INFINITE - 1,
+        granary_has_room, &search, 0);
     building *min = building_get(min_building_id);
     map_point_store_result(min->x + 1, min->y + 1, dst);
     return min_building_id;
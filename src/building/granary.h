@@ -158,7 +158,7 @@ building *building_granary_get_granary_needing_food(building *source, int resour
  * @param resource The resource type
  * @param road_network_id The road network ID that the destination granary must be on
  * @param force_on_stockpile Whether to force delivery even if the resource is stockpiled
- * @param understaffed Pointer to an integer that will be incremented if the selected granary is understaffed
+ * @param understaffed Pointer to an integer that will be incremented for each understaffed granary that was considered
  * @param dst Pointer to a map_point struct where the destination coordinates will be stored
  * @return ID of the granary, or 0 if none found
  */
@@ -1,6 +1,8 @@
 #include "house.h"
 
 #include "building/image.h"
+#include "building/spatial.h"
+#include "city/culture.h"
 #include "city/population.h"
 #include "core/config.h"
 #include "core/image.h"
@@ -18,19 +20,19 @@
 
 #define MAX_DIR 4
 
-#define OFFSET(x,y) (x + GRID_SIZE * y)
-
-static const int HOUSE_TILE_OFFSETS[] = {
-    OFFSET(0,0), OFFSET(1,0), OFFSET(0,1), OFFSET(1,1), // 2x2
-    OFFSET(2,0), OFFSET(2,1), OFFSET(2,2), OFFSET(1,2), OFFSET(0,2), // 3x3
-    OFFSET(3,0), OFFSET(3,1), OFFSET(3,2), OFFSET(3,3), OFFSET(2,3), OFFSET(1,3), OFFSET(0,3) // 4x4
+static const struct {
+    int x;
+    int y;
+} HOUSE_TILES[] = {
+    {0,0}, {1,0}, {0,1}, {1,1}, // 2x2
+    {2,0}, {2,1}, {2,2}, {1,2}, {0,2}, // 3x3
+    {3,0}, {3,1}, {3,2}, {3,3}, {2,3}, {1,3}, {0,3} // 4x4
 };
 
 static const struct {
     int x;
     int y;
-    int offset;
-} EXPAND_DIRECTION_DELTA[MAX_DIR] = { {0, 0, 0}, {-1, -1, -GRID_SIZE - 1}, {-1, 0, -1}, {0, -1, -GRID_SIZE} };
+} EXPAND_DIRECTION_DELTA[MAX_DIR] = { {0, 0}, {-1, -1}, {-1, 0}, {0, -1} };
 
 static struct {
     int x;
@@ -40,6 +42,16 @@ static struct {
     int population;
 } merge_data;
 
+static int house_tile_offset(int index)
+{
+    return map_grid_delta(HOUSE_TILES[index].x, HOUSE_TILES[index].y);
+}
+
+static int expand_direction_offset(int dir)
+{
+    return map_grid_delta(EXPAND_DIRECTION_DELTA[dir].x, EXPAND_DIRECTION_DELTA[dir].y);
+}
+
 void building_house_change_to(building *house, building_type type)
 {
     building_change_type(house, type);
@@ -58,9 +70,9 @@ static void create_vacant_lot(int x, int y)
 void building_house_vacant_lot_mark_draw(int building_id)
 {
     grid_slice *slice = map_grid_get_grid_slice_house(building_id, 0);
-    for (int i = 0; i < slice->size; i++) {
-        int grid_offset = slice->grid_offsets[i];
-        map_property_mark_draw_tile(grid_offset);
+    grid_slice_iterator it = map_grid_slice_iterate(slice);
+    while (map_grid_slice_next(&it)) {
+        map_property_mark_draw_tile(it.grid_offset);
     }
 }
 
@@ -92,7 +104,7 @@ static void prepare_for_merge(unsigned int building_id, int num_tiles)
     merge_data.sentiment = 0;
     int grid_offset = map_grid_offset(merge_data.x, merge_data.y);
     for (int i = 0; i < num_tiles; i++) {
-        int house_offset = grid_offset + HOUSE_TILE_OFFSETS[i];
+        int house_offset = grid_offset + house_tile_offset(i);
         if (map_terrain_is(house_offset, TERRAIN_BUILDING)) {
             building *house = building_get(map_building_at(house_offset));
             if (house->id != building_id && house->house_size) {
@@ -102,7 +114,7 @@ static void prepare_for_merge(unsigned int building_id, int num_tiles)
                     merge_data.inventory[r] += house->resources[r];
                 }
                 house->house_population = 0;
-                house->state = BUILDING_STATE_DELETED_BY_GAME;
+                building_set_state(house, BUILDING_STATE_DELETED_BY_GAME);
             }
         }
     }
@@ -126,14 +138,16 @@ static void merge(building *b)
     b->x = merge_data.x;
     b->y = merge_data.y;
     b->grid_offset = map_grid_offset(b->x, b->y);
+    building_spatial_update(b);
+    city_culture_update_building(b);
     b->house_is_merged = 1;
     map_building_tiles_add(b->id, b->x, b->y, 2, building_image_get(b), TERRAIN_BUILDING);
     if (config_get(CONFIG_GP_CH_HOUSING_PRE_MERGE_VACANT_LOTS)) {
         if (b->type == BUILDING_HOUSE_VACANT_LOT && b->house_population == 0) {
             grid_slice *slice = map_grid_get_grid_slice_house(b->id, 0);
-            for (int i = 0; i < slice->size; i++) {
-                int offset = slice->grid_offsets[i];
-                map_property_mark_draw_tile(offset); // re-mark the tiles for redraw
+            grid_slice_iterator it = map_grid_slice_iterate(slice);
+            while (map_grid_slice_next(&it)) {
+                map_property_mark_draw_tile(it.grid_offset); // re-mark the tiles for redraw
             }
         }
     }
@@ -152,7 +166,7 @@ void building_house_merge(building *house)
     }
     int num_house_tiles = 0;
     for (int i = 0; i < 4; i++) {
-        int tile_offset = house->grid_offset + HOUSE_TILE_OFFSETS[i];
+        int tile_offset = house->grid_offset + house_tile_offset(i);
         if (map_terrain_is(tile_offset, TERRAIN_BUILDING)) {
             building *other_house = building_get(map_building_at(tile_offset));
             if (other_house->id == house->id) {
@@ -176,10 +190,10 @@ int building_house_can_expand(building *house, int num_tiles)
 {
     // merge with other houses
     for (int dir = 0; dir < MAX_DIR; dir++) {
-        int base_offset = EXPAND_DIRECTION_DELTA[dir].offset + house->grid_offset;
+        int base_offset = expand_direction_offset(dir) + house->grid_offset;
         int ok_tiles = 0;
         for (int i = 0; i < num_tiles; i++) {
-            int tile_offset = base_offset + HOUSE_TILE_OFFSETS[i];
+            int tile_offset = base_offset + house_tile_offset(i);
             if (map_terrain_is(tile_offset, TERRAIN_BUILDING)) {
                 building *other_house = building_get(map_building_at(tile_offset));
                 if (other_house->id == house->id) {
@@ -199,10 +213,10 @@ int building_house_can_expand(building *house, int num_tiles)
     }
     // merge with houses and empty terrain
     for (int dir = 0; dir < MAX_DIR; dir++) {
-        int base_offset = EXPAND_DIRECTION_DELTA[dir].offset + house->grid_offset;
+        int base_offset = expand_direction_offset(dir) + house->grid_offset;
         int ok_tiles = 0;
         for (int i = 0; i < num_tiles; i++) {
-            int tile_offset = base_offset + HOUSE_TILE_OFFSETS[i];
+            int tile_offset = base_offset + house_tile_offset(i);
             if (!map_terrain_is(tile_offset, TERRAIN_NOT_CLEAR)) {
                 ok_tiles++;
             } else if (map_terrain_is(tile_offset, TERRAIN_BUILDING)) {
@@ -224,10 +238,10 @@ int building_house_can_expand(building *house, int num_tiles)
     }
     // merge with houses, empty terrain and gardens
     for (int dir = 0; dir < MAX_DIR; dir++) {
-        int base_offset = EXPAND_DIRECTION_DELTA[dir].offset + house->grid_offset;
+        int base_offset = expand_direction_offset(dir) + house->grid_offset;
         int ok_tiles = 0;
         for (int i = 0; i < num_tiles; i++) {
-            int tile_offset = base_offset + HOUSE_TILE_OFFSETS[i];
+            int tile_offset = base_offset + house_tile_offset(i);
             if (!map_terrain_is(tile_offset, TERRAIN_NOT_CLEAR)) {
                 ok_tiles++;
             } else if (map_terrain_is(tile_offset, TERRAIN_BUILDING)) {
@@ -292,6 +306,7 @@ static void create_splitted_house_tile(building *main_house, building_type type,
     }
     copy_house_data(house, main_house);
     house->distance_from_entry = 0;
+    city_culture_update_building(house);
     map_building_tiles_add(house->id, house->x, house->y, 1,
         building_image_get(house), TERRAIN_BUILDING);
 }
@@ -320,6 +335,7 @@ static void split_size2(building *house, building_type new_type)
         house->resources[i] = inventory_per_tile[i] + inventory_remainder[i];
     }
     house->distance_from_entry = 0;
+    city_culture_update_building(house);
 
     map_building_tiles_add(house->id, house->x, house->y, house->size,
         building_image_get(house), TERRAIN_BUILDING);
@@ -354,6 +370,7 @@ static void split_size3(building *house)
         house->resources[i] = inventory_per_tile[i] + inventory_remainder[i];
     }
     house->distance_from_entry = 0;
+    city_culture_update_building(house);
 
     map_building_tiles_add(house->id, house->x, house->y, house->size,
         building_image_get(house), TERRAIN_BUILDING);
@@ -371,7 +388,7 @@ static void split(building *house, int num_tiles)
 {
     int grid_offset = map_grid_offset(merge_data.x, merge_data.y);
     for (int i = 0; i < num_tiles; i++) {
-        int tile_offset = grid_offset + HOUSE_TILE_OFFSETS[i];
+        int tile_offset = grid_offset + house_tile_offset(i);
         if (map_terrain_is(tile_offset, TERRAIN_BUILDING)) {
             building *other_house = building_get(map_building_at(tile_offset));
             if (other_house->id != house->id && other_house->house_size) {
@@ -406,6 +423,8 @@ void building_house_expand_to_large_insula(building *house)
     house->x = merge_data.x;
     house->y = merge_data.y;
     house->grid_offset = map_grid_offset(house->x, house->y);
+    building_spatial_update(house);
+    city_culture_update_building(house);
     map_building_tiles_add(house->id, house->x, house->y, house->size, building_image_get(house), TERRAIN_BUILDING);
 }
 
@@ -426,6 +445,8 @@ void building_house_expand_to_large_villa(building *house)
     house->x = merge_data.x;
     house->y = merge_data.y;
     house->grid_offset = map_grid_offset(house->x, house->y);
+    building_spatial_update(house);
+    city_culture_update_building(house);
     map_building_tiles_add(house->id, house->x, house->y, house->size, building_image_get(house), TERRAIN_BUILDING);
 }
 
@@ -446,6 +467,8 @@ void building_house_expand_to_large_palace(building *house)
     house->x = merge_data.x;
     house->y = merge_data.y;
     house->grid_offset = map_grid_offset(house->x, house->y);
+    building_spatial_update(house);
+    city_culture_update_building(house);
     map_building_tiles_add(house->id, house->x, house->y, house->size, building_image_get(house), TERRAIN_BUILDING);
 }
 
@@ -506,6 +529,7 @@ void building_house_desize_patrician(building *house)
     house->is_close_to_water = building_is_close_to_water(house);
     house->house_is_merged = 0;
     house->distance_from_entry = 0;
+    city_culture_update_building(house);
 
     // Add the new smaller building tiles
     map_building_tiles_add(house->id, house->x, house->y, house->size, building_image_get(house), TERRAIN_BUILDING);
@@ -535,6 +559,7 @@ void building_house_devolve_from_large_villa(building *house)
         house->resources[i] = inventory_per_tile[i] + inventory_remainder[i];
     }
     house->distance_from_entry = 0;
+    city_culture_update_building(house);
 
     map_building_tiles_add(house->id, house->x, house->y, house->size,
         building_image_get(house), TERRAIN_BUILDING);
@@ -576,6 +601,7 @@ void building_house_devolve_from_large_palace(building *house)
         house->resources[i] = inventory_per_tile[i] + inventory_remainder[i];
     }
     house->distance_from_entry = 0;
+    city_culture_update_building(house);
 
     map_building_tiles_add(house->id, house->x, house->y, house->size, building_image_get(house), TERRAIN_BUILDING);
 
@@ -610,13 +636,14 @@ void building_house_check_for_corruption(building *house)
                     house->grid_offset = grid_offset;
                     house->x = map_grid_offset_to_x(grid_offset);
                     house->y = map_grid_offset_to_y(grid_offset);
+                    building_spatial_update(house);
                     building_totals_add_corrupted_house(0);
                     return;
                 }
             }
         }
         building_totals_add_corrupted_house(1);
-        house->state = BUILDING_STATE_RUBBLE;
+        building_set_state(house, BUILDING_STATE_RUBBLE);
     }
 }
 
@@ -626,6 +653,7 @@ void building_house_restore_population_after_undo(building *house)
         figure *homeless = figure_get(house->figure_id);
         if (homeless->building_id == house->id) {
             house->house_population = homeless->migrant_num_people;
+            city_culture_update_building(house);
             city_population_add_homeless(homeless->migrant_num_people);
             figure_delete(homeless);
         }
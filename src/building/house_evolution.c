@@ -7,18 +7,27 @@
 #include "city/resource.h"
 #include "core/calc.h"
 #include "core/config.h"
+#include "core/log.h"
 #include "core/time.h"
 #include "game/resource.h"
 #include "game/time.h"
 #include "game/undo.h"
 #include "map/building.h"
 #include "map/grid.h"
+#include "map/random.h"
 #include "map/routing_terrain.h"
 #include "map/terrain.h"
 #include "map/tiles.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 #define DEVOLVE_DELAY 2
 #define DEVOLVE_DELAY_WITH_VENUS 20
+#define NOT_EVALUATED 2
+#define CACHE_SIZE_STEP 1000
+#define MISSING_DEMANDS (sizeof(((house_demands *) 0)->missing) / sizeof(int))
+#define REQUIRING_DEMANDS (sizeof(((house_demands *) 0)->requiring) / sizeof(int))
 
 typedef enum {
     EVOLVE = 1,
@@ -27,6 +36,52 @@ typedef enum {
 } evolve_status;
 
 static int active_devolve_delay;
+static int evaluated_status;
+
+// Everything the evolve callbacks look at, so that houses whose inputs did not change are not evaluated again
+typedef struct {
+    unsigned char type;
+    unsigned char has_population;
+    unsigned char can_merge;
+    unsigned char has_water_access;
+    unsigned char has_well_access;
+    unsigned char has_latrines_access;
+    unsigned char has_pantheon_access;
+    unsigned char entertainment;
+    unsigned char education;
+    unsigned char health;
+    unsigned char num_gods;
+    unsigned char barber;
+    unsigned char bathhouse;
+    unsigned char devolve_delay;
+    unsigned char pottery;
+    unsigned char oil;
+    unsigned char furniture;
+    unsigned char wine;
+    signed char desirability;
+    unsigned int food_types;
+} house_inputs;
+
+typedef struct {
+    int pantheon_bonus_active;
+    int multiple_wine_available;
+    int all_houses_merge;
+    int premerge_vacant_lots;
+    unsigned int model_generation;
+} global_inputs;
+
+typedef struct {
+    int is_stable;
+    house_inputs inputs;
+    unsigned char missing[MISSING_DEMANDS];
+    unsigned char requiring[REQUIRING_DEMANDS];
+} cached_evolution;
+
+static struct {
+    cached_evolution *items;
+    unsigned int size;
+    global_inputs globals;
+} cache;
 
 static int check_evolve_desirability(building *house, int bonus)
 {
@@ -203,6 +258,7 @@ static int check_requirements(building *house, house_demands *demands)
     } else if (status == EVOLVE) {
         status = has_required_goods_and_services(house, 1, bonus, demands);
     }
+    evaluated_status = status;
     return status;
 }
 
@@ -511,6 +567,8 @@ static int evolve_luxury_palace(building *house, house_demands *demands)
     if (!has_required_goods_and_services(house, 0, bonus, demands)) {
         status = DEVOLVE;
     }
+    // The luxury palace cannot evolve any further, so it is also stable when it would evolve
+    evaluated_status = status == DEVOLVE ? DEVOLVE : NONE;
     if (!has_devolve_delay(house, status) && status == DEVOLVE) {
         building_house_change_to(house, BUILDING_HOUSE_LARGE_PALACE);
     }
@@ -569,6 +627,144 @@ static int (*evolve_callback[])(building *, house_demands *) = {
     evolve_small_palace, evolve_medium_palace, evolve_large_palace, evolve_luxury_palace
 };
 
+static int can_merge(const building *house)
+{
+    if (house->type > BUILDING_HOUSE_MEDIUM_INSULA || house->house_is_merged) {
+        return 0;
+    }
+    if (house->type == BUILDING_HOUSE_SMALL_TENT && !cache.globals.premerge_vacant_lots &&
+        house->house_population <= 0) {
+        return 0;
+    }
+    return cache.globals.all_houses_merge || (map_random_get(house->grid_offset) & 7) < 5;
+}
+
+static unsigned char clamp_to_byte(int value)
+{
+    return (unsigned char) calc_bound(value, 0, 255);
+}
+
+static void get_house_inputs(const building *house, house_inputs *inputs)
+{
+    memset(inputs, 0, sizeof(house_inputs));
+    inputs->type = house->type - BUILDING_HOUSE_VACANT_LOT;
+    inputs->has_population = house->house_population > 0;
+    inputs->can_merge = can_merge(house);
+    inputs->has_water_access = house->has_water_access;
+    inputs->has_well_access = house->has_well_access;
+    inputs->has_latrines_access = house->has_latrines_access;
+    inputs->has_pantheon_access = house->house_pantheon_access;
+    inputs->entertainment = house->data.house.entertainment;
+    inputs->education = house->data.house.education;
+    inputs->health = house->data.house.health;
+    inputs->num_gods = house->data.house.num_gods;
+    inputs->barber = house->data.house.barber;
+    inputs->bathhouse = house->data.house.bathhouse;
+    inputs->devolve_delay = house->data.house.devolve_delay;
+    inputs->pottery = clamp_to_byte(house->resources[RESOURCE_POTTERY]);
+    inputs->oil = clamp_to_byte(house->resources[RESOURCE_OIL]);
+    inputs->furniture = clamp_to_byte(house->resources[RESOURCE_FURNITURE]);
+    inputs->wine = clamp_to_byte(house->resources[RESOURCE_WINE]);
+    inputs->desirability = house->desirability;
+    for (resource_type r = RESOURCE_MIN_FOOD; r < RESOURCE_MAX_FOOD; r++) {
+        if (house->resources[r] && resource_is_inventory(r)) {
+            inputs->food_types |= 1u << (r - RESOURCE_MIN_FOOD);
+        }
+    }
+}
+
+static int update_global_inputs(void)
+{
+    global_inputs globals;
+    globals.pantheon_bonus_active = building_monument_pantheon_module_is_active(PANTHEON_MODULE_2_HOUSING_EVOLUTION);
+    globals.multiple_wine_available = city_resource_multiple_wine_available();
+    globals.all_houses_merge = config_get(CONFIG_GP_CH_ALL_HOUSES_MERGE);
+    globals.premerge_vacant_lots = config_get(CONFIG_GP_CH_HOUSING_PRE_MERGE_VACANT_LOTS);
+    globals.model_generation = model_data_generation();
+    int changed = memcmp(&globals, &cache.globals, sizeof(global_inputs)) != 0;
+    cache.globals = globals;
+    return changed;
+}
+
+static cached_evolution *get_cached_evolution(unsigned int building_id)
+{
+    if (building_id >= cache.size) {
+        unsigned int new_size = (building_id / CACHE_SIZE_STEP + 1) * CACHE_SIZE_STEP;
+        cached_evolution *items = realloc(cache.items, new_size * sizeof(cached_evolution));
+        if (!items) {
+            log_error("Unable to allocate memory for the house evolution cache. The game will now crash.", 0, 0);
+            return 0;
+        }
+        memset(&items[cache.size], 0, (new_size - cache.size) * sizeof(cached_evolution));
+        cache.items = items;
+        cache.size = new_size;
+    }
+    return &cache.items[building_id];
+}
+
+static void store_demands(cached_evolution *cached, const house_demands *before, const house_demands *after)
+{
+    const int *missing_before = &before->missing.well;
+    const int *missing_after = &after->missing.well;
+    for (unsigned int i = 0; i < MISSING_DEMANDS; i++) {
+        cached->missing[i] = missing_after[i] - missing_before[i];
+    }
+    const int *requiring_before = &before->requiring.school;
+    const int *requiring_after = &after->requiring.school;
+    for (unsigned int i = 0; i < REQUIRING_DEMANDS; i++) {
+        cached->requiring[i] = requiring_after[i] - requiring_before[i];
+    }
+}
+
+static void restore_demands(const cached_evolution *cached, house_demands *demands)
+{
+    int *missing = &demands->missing.well;
+    for (unsigned int i = 0; i < MISSING_DEMANDS; i++) {
+        missing[i] += cached->missing[i];
+    }
+    int *requiring = &demands->requiring.school;
+    for (unsigned int i = 0; i < REQUIRING_DEMANDS; i++) {
+        requiring[i] += cached->requiring[i];
+    }
+}
+
+static int evolve(building *b, house_demands *demands, int full_sweep)
+{
+    cached_evolution *cached = get_cached_evolution(b->id);
+    if (!cached) {
+        return evolve_callback[b->type - BUILDING_HOUSE_VACANT_LOT](b, demands);
+    }
+    house_inputs inputs;
+    get_house_inputs(b, &inputs);
+    if (!full_sweep && cached->is_stable && memcmp(&inputs, &cached->inputs, sizeof(house_inputs)) == 0) {
+        restore_demands(cached, demands);
+        return 0;
+    }
+    house_demands before = *demands;
+    building_type type = b->type;
+    evaluated_status = NOT_EVALUATED;
+
+    int has_expanded = evolve_callback[b->type - BUILDING_HOUSE_VACANT_LOT](b, demands);
+
+    // A house is stable when evaluating it again with the same inputs would do nothing but add the same demands
+    cached->is_stable = !has_expanded && b->type == type && b->state == BUILDING_STATE_IN_USE &&
+        (evaluated_status == NONE || evaluated_status == NOT_EVALUATED) && !inputs.can_merge &&
+        !b->data.house.devolve_delay;
+    if (cached->is_stable) {
+        get_house_inputs(b, &cached->inputs);
+        store_demands(cached, &before, demands);
+    }
+    return has_expanded;
+}
+
+void building_house_reset_evolution_cache(void)
+{
+    free(cache.items);
+    cache.items = 0;
+    cache.size = 0;
+    memset(&cache.globals, 0, sizeof(global_inputs));
+}
+
 void building_house_process_evolve_and_consume_goods(void)
 {
     city_houses_reset_demands();
@@ -580,6 +776,8 @@ void building_house_process_evolve_and_consume_goods(void)
     } else {
         active_devolve_delay = DEVOLVE_DELAY;
     }
+    // Re-evaluate every house once a month, in case something the inputs do not cover has changed
+    int full_sweep = update_global_inputs() || game_time_day() == 0;
 
     time_millis last_update = time_get_millis();
 
@@ -592,7 +790,7 @@ void building_house_process_evolve_and_consume_goods(void)
             }
             building_house_check_for_corruption(b);
             if (!b->has_plague) {
-                has_expanded |= evolve_callback[b->type - BUILDING_HOUSE_VACANT_LOT](b, demands);
+                has_expanded |= evolve(b, demands, full_sweep);
             }
             // 1x1 houses only consume half of the goods
             if (game_time_day() == 0 || (game_time_day() == 7 && b->house_size > 1)) {
@@ -8,6 +8,11 @@
  */
 void building_house_process_evolve_and_consume_goods(void);
 
+/**
+ * Forgets which houses did not need to be evaluated again, must be called when the buildings are reloaded
+ */
+void building_house_reset_evolution_cache(void);
+
 /**
  * Determine the text to show for evolution of a house, stored in house->evolve_text_id
  * @param house House to determine text for
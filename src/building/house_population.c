@@ -3,6 +3,7 @@
 #include "building/list.h"
 #include "building/monument.h"
 #include "building/properties.h"
+#include "city/culture.h"
 #include "city/labor.h"
 #include "city/message.h"
 #include "city/migration.h"
@@ -27,6 +28,7 @@ int house_population_add_to_city(int num_people)
                 ++added;
                 ++b->house_population;
                 b->house_population_room = max_people - b->house_population;
+                city_culture_update_building(b);
             }
         }
     }
@@ -47,6 +49,7 @@ int house_population_remove_from_city(int num_people)
             if (b->house_population > 0) {
                 ++removed;
                 --b->house_population;
+                city_culture_update_building(b);
             }
         }
     }
@@ -239,9 +242,10 @@ void house_population_evict_overcrowded(void)
             figure_create_homeless(b, num_people_to_evict);
             if (num_people_to_evict < b->house_population) {
                 b->house_population -= num_people_to_evict;
+                city_culture_update_building(b);
             } else {
                 // house has been removed
-                b->state = BUILDING_STATE_UNDO;
+                building_set_state(b, BUILDING_STATE_UNDO);
             }
         }
     }
@@ -3,6 +3,28 @@
 #include "building/building.h"
 #include "building/monument.h"
 #include "city/culture.h"
+#include "core/log.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_DAYS_SINCE_OFFERING 125
+#define HOUSES_SIZE_STEP 500
+
+static struct {
+    unsigned int *ids;
+    unsigned int size;
+    unsigned int capacity;
+    unsigned char *is_tracked;
+    unsigned int tracked_capacity;
+    int is_valid;
+    struct {
+        int venus_module2;
+        int completed_colosseum;
+        int completed_hippodrome;
+        int is_valid;
+    } aggregate_inputs;
+} data;
 
 static void decay(unsigned char *value)
 {
@@ -13,59 +35,167 @@ static void decay(unsigned char *value)
     }
 }
 
-void house_service_decay_culture(void)
+static int ensure_tracked_capacity(unsigned int id)
+{
+    if (id < data.tracked_capacity) {
+        return 1;
+    }
+    unsigned int new_capacity = (id / HOUSES_SIZE_STEP + 1) * HOUSES_SIZE_STEP;
+    unsigned char *is_tracked = realloc(data.is_tracked, new_capacity * sizeof(unsigned char));
+    if (!is_tracked) {
+        return 0;
+    }
+    memset(&is_tracked[data.tracked_capacity], 0, (new_capacity - data.tracked_capacity) * sizeof(unsigned char));
+    data.is_tracked = is_tracked;
+    data.tracked_capacity = new_capacity;
+    return 1;
+}
+
+static void add_house(unsigned int id)
+{
+    if (!ensure_tracked_capacity(id)) {
+        log_error("Unable to allocate enough memory for the house service list. The game will now crash.", 0, 0);
+        return;
+    }
+    if (data.is_tracked[id]) {
+        return;
+    }
+    if (data.size >= data.capacity) {
+        unsigned int new_capacity = data.capacity + HOUSES_SIZE_STEP;
+        unsigned int *ids = realloc(data.ids, new_capacity * sizeof(unsigned int));
+        if (!ids) {
+            log_error("Unable to allocate enough memory for the house service list. The game will now crash.", 0, 0);
+            return;
+        }
+        data.ids = ids;
+        data.capacity = new_capacity;
+    }
+    data.ids[data.size++] = id;
+    data.is_tracked[id] = 1;
+}
+
+static void ensure_tracked_houses(void)
 {
+    if (data.is_valid) {
+        return;
+    }
+    data.is_valid = 1;
     for (building_type type = BUILDING_HOUSE_SMALL_TENT; type <= BUILDING_HOUSE_LUXURY_PALACE; type++) {
         for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
-            if (b->state != BUILDING_STATE_IN_USE || !b->house_size) {
-                continue;
-            }
-            decay(&b->data.house.theater);
-            decay(&b->data.house.amphitheater_actor);
-            decay(&b->data.house.amphitheater_gladiator);
-            decay(&b->data.house.colosseum_gladiator);
-            decay(&b->data.house.colosseum_lion);
-            decay(&b->house_arena_gladiator);
-            decay(&b->house_arena_lion);
-            decay(&b->house_tavern_food_access);
-            decay(&b->house_tavern_wine_access);
-            decay(&b->data.house.hippodrome);
-            decay(&b->data.house.school);
-            decay(&b->data.house.library);
-            decay(&b->data.house.academy);
-            decay(&b->data.house.barber);
-            decay(&b->data.house.clinic);
-            decay(&b->data.house.bathhouse);
-            decay(&b->data.house.hospital);
-            decay(&b->data.house.temple_ceres);
-            decay(&b->data.house.temple_neptune);
-            decay(&b->data.house.temple_mercury);
-            decay(&b->data.house.temple_mars);
-            decay(&b->data.house.temple_venus);
-            decay(&b->house_pantheon_access);
-            if (b->days_since_offering < 125) {
-                ++b->days_since_offering;
-            }
+            add_house(b->id);
         }
     }
 }
 
+void house_service_track(building *b)
+{
+    if (data.is_valid && building_is_house(b->type)) {
+        add_house(b->id);
+    }
+}
+
+void house_service_reset_tracking(void)
+{
+    if (data.is_tracked) {
+        memset(data.is_tracked, 0, data.tracked_capacity * sizeof(unsigned char));
+    }
+    data.size = 0;
+    data.is_valid = 0;
+    data.aggregate_inputs.is_valid = 0;
+}
+
+static int is_serviced_house(const building *b)
+{
+    return b->state == BUILDING_STATE_IN_USE && b->house_size && building_is_house(b->type);
+}
+
+static int has_no_services_left(const building *b)
+{
+    return !b->data.house.theater && !b->data.house.amphitheater_actor && !b->data.house.amphitheater_gladiator &&
+        !b->data.house.colosseum_gladiator && !b->data.house.colosseum_lion && !b->house_arena_gladiator &&
+        !b->house_arena_lion && !b->house_tavern_food_access && !b->house_tavern_wine_access &&
+        !b->data.house.hippodrome && !b->data.house.school && !b->data.house.library && !b->data.house.academy &&
+        !b->data.house.barber && !b->data.house.clinic && !b->data.house.bathhouse && !b->data.house.hospital &&
+        !b->data.house.temple_ceres && !b->data.house.temple_neptune && !b->data.house.temple_mercury &&
+        !b->data.house.temple_mars && !b->data.house.temple_venus && !b->house_pantheon_access &&
+        !b->house_tax_coverage && b->days_since_offering >= MAX_DAYS_SINCE_OFFERING;
+}
+
+static void remove_untracked_houses(void)
+{
+    unsigned int kept = 0;
+    for (unsigned int i = 0; i < data.size; i++) {
+        unsigned int id = data.ids[i];
+        building *b = building_get(id);
+        // Houses that are not in use yet, or have been merged away and have no size, still have a house type
+        // and can come back into use with their service values intact, so they stay on the list until those
+        // values have decayed
+        if (b->state == BUILDING_STATE_UNUSED || !building_is_house(b->type) ||
+            (is_serviced_house(b) && has_no_services_left(b))) {
+            data.is_tracked[id] = 0;
+        } else {
+            data.ids[kept++] = id;
+        }
+    }
+    data.size = kept;
+}
+
+void house_service_decay_culture(void)
+{
+    ensure_tracked_houses();
+    for (unsigned int i = 0; i < data.size; i++) {
+        building *b = building_get(data.ids[i]);
+        if (!is_serviced_house(b)) {
+            continue;
+        }
+        decay(&b->data.house.theater);
+        decay(&b->data.house.amphitheater_actor);
+        decay(&b->data.house.amphitheater_gladiator);
+        decay(&b->data.house.colosseum_gladiator);
+        decay(&b->data.house.colosseum_lion);
+        decay(&b->house_arena_gladiator);
+        decay(&b->house_arena_lion);
+        decay(&b->house_tavern_food_access);
+        decay(&b->house_tavern_wine_access);
+        decay(&b->data.house.hippodrome);
+        decay(&b->data.house.school);
+        decay(&b->data.house.library);
+        decay(&b->data.house.academy);
+        decay(&b->data.house.barber);
+        decay(&b->data.house.clinic);
+        decay(&b->data.house.bathhouse);
+        decay(&b->data.house.hospital);
+        decay(&b->data.house.temple_ceres);
+        decay(&b->data.house.temple_neptune);
+        decay(&b->data.house.temple_mercury);
+        decay(&b->data.house.temple_mars);
+        decay(&b->data.house.temple_venus);
+        decay(&b->house_pantheon_access);
+        if (b->days_since_offering < MAX_DAYS_SINCE_OFFERING) {
+            ++b->days_since_offering;
+        }
+        city_culture_update_building(b);
+    }
+}
+
 void house_service_decay_tax_collector(void)
 {
-    for (building_type type = BUILDING_HOUSE_SMALL_TENT; type <= BUILDING_HOUSE_LUXURY_PALACE; type++) {
-        for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
-            if (b->state == BUILDING_STATE_IN_USE && b->house_tax_coverage) {
-                b->house_tax_coverage--;
-            }
+    ensure_tracked_houses();
+    for (unsigned int i = 0; i < data.size; i++) {
+        building *b = building_get(data.ids[i]);
+        if (b->state == BUILDING_STATE_IN_USE && building_is_house(b->type) && b->house_tax_coverage) {
+            b->house_tax_coverage--;
         }
     }
 }
 
 void house_service_decay_houses_covered(void)
 {
+    const building_hot_data *hot = building_get_hot_data();
     for (int i = 1; i < building_count(); i++) {
-        building *b = building_get(i);
-        if (b->state != BUILDING_STATE_UNUSED && b->type != BUILDING_TOWER && b->type != BUILDING_WATCHTOWER) {
+        if (hot[i].state != BUILDING_STATE_UNUSED && hot[i].type != BUILDING_TOWER &&
+            hot[i].type != BUILDING_WATCHTOWER) {
+            building *b = building_get(i);
             if (b->houses_covered <= 1) {
                 b->houses_covered = 0;
             } else {
@@ -75,107 +205,131 @@ void house_service_decay_houses_covered(void)
     }
 }
 
-void house_service_calculate_culture_aggregates(void)
+static void calculate_aggregates(building *b)
 {
-    int venus_module2 = building_monument_gt_module_is_active(VENUS_MODULE_2_DESIRABILITY_ENTERTAINMENT);
-    int completed_colosseum = building_monument_working(BUILDING_COLOSSEUM);
-    int completed_hippodrome = building_monument_working(BUILDING_HIPPODROME);
+    int arena_total = 0;
+    int colosseum_total = 0;
 
-    for (building_type type = BUILDING_HOUSE_SMALL_TENT; type <= BUILDING_HOUSE_LUXURY_PALACE; type++) {
-        for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
-            if (b->state != BUILDING_STATE_IN_USE || !b->house_size) {
-                continue;
-            }
-            int arena_total = 0;
-            int colosseum_total = 0;
+    // Entertainment
+    b->data.house.entertainment = 0;
 
-            // Entertainment
-            b->data.house.entertainment = 0;
+    if (b->data.house.theater) {
+        b->data.house.entertainment += 10;
+    }
 
-            if (b->data.house.theater) {
-                b->data.house.entertainment += 10;
-            }
+    if (b->house_tavern_wine_access) {
+        b->data.house.entertainment += 10;
+        if (b->house_tavern_food_access) {
+            b->data.house.entertainment += 5;
+        }
+    }
 
-            if (b->house_tavern_wine_access) {
-                b->data.house.entertainment += 10;
-                if (b->house_tavern_food_access) {
-                    b->data.house.entertainment += 5;
-                }
-            }
+    if (b->data.house.amphitheater_actor) {
+        if (b->data.house.amphitheater_gladiator) {
+            b->data.house.entertainment += 15;
+        } else {
+            b->data.house.entertainment += 10;
+        }
+    }
 
-            if (b->data.house.amphitheater_actor) {
-                if (b->data.house.amphitheater_gladiator) {
-                    b->data.house.entertainment += 15;
-                } else {
-                    b->data.house.entertainment += 10;
-                }
-            }
+    if (b->house_arena_gladiator) {
+        arena_total = b->house_arena_lion ? 20 : 10;
+    }
 
-            if (b->house_arena_gladiator) {
-                arena_total = b->house_arena_lion ? 20 : 10;
-            }
+    if (b->data.house.colosseum_gladiator) {
+        colosseum_total = b->data.house.colosseum_lion ? 25 : 15;
+    }
 
-            if (b->data.house.colosseum_gladiator) {
-                colosseum_total = b->data.house.colosseum_lion ? 25 : 15;
-            }
+    b->data.house.entertainment += arena_total > colosseum_total ? arena_total : colosseum_total;
 
-            b->data.house.entertainment += arena_total > colosseum_total ? arena_total : colosseum_total;
+    if (b->data.house.hippodrome) {
+        b->data.house.entertainment += 30;
+    }
 
-            if (b->data.house.hippodrome) {
-                b->data.house.entertainment += 30;
-            }
+    if (data.aggregate_inputs.completed_hippodrome) {
+        b->data.house.entertainment += 5;
+    }
 
-            if (completed_hippodrome) {
-                b->data.house.entertainment += 5;
-            }
+    if (data.aggregate_inputs.completed_colosseum) {
+        b->data.house.entertainment += 5;
+    }
 
-            if (completed_colosseum) {
-                b->data.house.entertainment += 5;
-            }
+    // Venus Module 2 Entertainment Bonus
+    if (data.aggregate_inputs.venus_module2 && b->data.house.temple_venus) {
+        b->data.house.entertainment += 10;
+    }
 
-            // Venus Module 2 Entertainment Bonus
-            if (venus_module2 && b->data.house.temple_venus) {
-                b->data.house.entertainment += 10;
+    // Education
+    b->data.house.education = 0;
+    if (b->data.house.school || b->data.house.library) {
+        b->data.house.education = 1;
+        if (b->data.house.school && b->data.house.library) {
+            b->data.house.education = 2;
+            if (b->data.house.academy) {
+                b->data.house.education = 3;
             }
+        }
+    }
 
-            // Education
-            b->data.house.education = 0;
-            if (b->data.house.school || b->data.house.library) {
-                b->data.house.education = 1;
-                if (b->data.house.school && b->data.house.library) {
-                    b->data.house.education = 2;
-                    if (b->data.house.academy) {
-                        b->data.house.education = 3;
-                    }
-                }
-            }
+    // religion
+    b->data.house.num_gods = 0;
+    if (b->data.house.temple_ceres) {
+        ++b->data.house.num_gods;
+    }
+    if (b->data.house.temple_neptune) {
+        ++b->data.house.num_gods;
+    }
+    if (b->data.house.temple_mercury) {
+        ++b->data.house.num_gods;
+    }
+    if (b->data.house.temple_mars) {
+        ++b->data.house.num_gods;
+    }
+    if (b->data.house.temple_venus) {
+        ++b->data.house.num_gods;
+    }
 
-            // religion
-            b->data.house.num_gods = 0;
-            if (b->data.house.temple_ceres) {
-                ++b->data.house.num_gods;
-            }
-            if (b->data.house.temple_neptune) {
-                ++b->data.house.num_gods;
-            }
-            if (b->data.house.temple_mercury) {
-                ++b->data.house.num_gods;
-            }
-            if (b->data.house.temple_mars) {
-                ++b->data.house.num_gods;
-            }
-            if (b->data.house.temple_venus) {
-                ++b->data.house.num_gods;
-            }
+    // health
+    b->data.house.health = 0;
+    if (b->data.house.clinic) {
+        ++b->data.house.health;
+    }
+    if (b->data.house.hospital) {
+        ++b->data.house.health;
+    }
+    city_culture_update_building(b);
+}
+
+void house_service_calculate_culture_aggregates(void)
+{
+    int venus_module2 = building_monument_gt_module_is_active(VENUS_MODULE_2_DESIRABILITY_ENTERTAINMENT);
+    int completed_colosseum = building_monument_working(BUILDING_COLOSSEUM);
+    int completed_hippodrome = building_monument_working(BUILDING_HIPPODROME);
 
-            // health
-            b->data.house.health = 0;
-            if (b->data.house.clinic) {
-                ++b->data.house.health;
+    ensure_tracked_houses();
+    if (!data.aggregate_inputs.is_valid || data.aggregate_inputs.venus_module2 != venus_module2 ||
+        data.aggregate_inputs.completed_colosseum != completed_colosseum ||
+        data.aggregate_inputs.completed_hippodrome != completed_hippodrome) {
+        data.aggregate_inputs.venus_module2 = venus_module2;
+        data.aggregate_inputs.completed_colosseum = completed_colosseum;
+        data.aggregate_inputs.completed_hippodrome = completed_hippodrome;
+        data.aggregate_inputs.is_valid = 1;
+        // Houses without services also get the monument bonuses, so all of them need to be updated
+        for (building_type type = BUILDING_HOUSE_SMALL_TENT; type <= BUILDING_HOUSE_LUXURY_PALACE; type++) {
+            for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
+                if (is_serviced_house(b)) {
+                    calculate_aggregates(b);
+                }
             }
-            if (b->data.house.hospital) {
-                ++b->data.house.health;
+        }
+    } else {
+        for (unsigned int i = 0; i < data.size; i++) {
+            building *b = building_get(data.ids[i]);
+            if (is_serviced_house(b)) {
+                calculate_aggregates(b);
             }
         }
     }
+    // Houses without any services left keep their aggregates until they are serviced again
+    remove_untracked_houses();
 }
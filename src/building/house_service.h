@@ -1,6 +1,21 @@
 #ifndef BUILDING_HOUSE_SERVICE_H
 #define BUILDING_HOUSE_SERVICE_H
 
+#include "building/building.h"
+
+/**
+ * Makes sure the services of a house decay and its culture aggregates get updated.
+ * Must be called whenever a house is created or a walker provides a service to it.
+ * Houses without any services left are not visited by the daily updates until they are tracked again.
+ * @param b The building, ignored if it is not a house
+ */
+void house_service_track(building *b);
+
+/**
+ * Rebuilds the list of tracked houses on the next update, must be called when the buildings are reloaded
+ */
+void house_service_reset_tracking(void);
+
 void house_service_decay_culture(void);
 
 void house_service_decay_tax_collector(void);
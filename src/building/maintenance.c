@@ -4,6 +4,7 @@
 #include "building/destruction.h"
 #include "building/list.h"
 #include "building/monument.h"
+#include "building/spatial.h"
 #include "city/buildings.h"
 #include "city/map.h"
 #include "city/message.h"
@@ -46,18 +47,19 @@ void building_maintenance_update_burning_ruins(void)
     int recalculate_terrain = 0;
     building_list_burning_clear();
     for (int i = 1; i < building_count(); i++) {
-        building *b = building_get(i);
-        if ((b->state != BUILDING_STATE_IN_USE && b->state != BUILDING_STATE_MOTHBALLED) ||
-            b->type != BUILDING_BURNING_RUIN) {
+        const building_hot_data *hot = &building_get_hot_data()[i];
+        if ((hot->state != BUILDING_STATE_IN_USE && hot->state != BUILDING_STATE_MOTHBALLED) ||
+            hot->type != BUILDING_BURNING_RUIN) {
             continue;
         }
+        building *b = building_get(i);
         if (b->fire_duration < 0) {
             b->fire_duration = 0;
         }
         b->fire_duration++;
         if (b->fire_duration > 32) {
             game_undo_disable();
-            b->state = BUILDING_STATE_RUBBLE;
+            building_set_state(b, BUILDING_STATE_RUBBLE);
             map_building_tiles_set_rubble(i, b->x, b->y, b->size);
             recalculate_terrain = 1;
             continue;
@@ -114,34 +116,30 @@ void building_maintenance_update_burning_ruins(void)
     }
 }
 
-int building_maintenance_get_closest_burning_ruin(int x, int y, int *distance)
+static int is_free_burning_ruin(building *b, void *userdata)
 {
-    int min_free_building_id = 0;
-    int min_occupied_building_id = 0;
-    int min_occupied_dist = *distance = 10000;
+    return (b->state == BUILDING_STATE_IN_USE || b->state == BUILDING_STATE_MOTHBALLED) &&
+        !b->has_plague && b->distance_from_entry && !b->figure_id4;
+}
 
-    int burning_size = building_list_burning_size();
-    for (int i = 0; i < burning_size; i++) {
-        int building_id = building_list_burning_item(i);
-        building *b = building_get(building_id);
-        if ((b->state == BUILDING_STATE_IN_USE || b->state == BUILDING_STATE_MOTHBALLED) &&
-            b->type == BUILDING_BURNING_RUIN && !b->has_plague && b->distance_from_entry) {
-            int dist = calc_maximum_distance(x, y, b->x, b->y);
-            if (b->figure_id4) {
-                if (dist < min_occupied_dist) {
-                    min_occupied_dist = dist;
-                    min_occupied_building_id = building_id;
-                }
-            } else if (dist < *distance) {
-                *distance = dist;
-                min_free_building_id = building_id;
-            }
+static int is_occupied_burning_ruin(building *b, void *userdata)
+{
+    return (b->state == BUILDING_STATE_IN_USE || b->state == BUILDING_STATE_MOTHBALLED) &&
+        !b->has_plague && b->distance_from_entry && b->figure_id4;
+}
+
+int building_maintenance_get_closest_burning_ruin(int x, int y, int *distance)
+{
+    *distance = 10000;
+    int min_free_building_id = building_spatial_find_closest(BUILDING_BURNING_RUIN, x, y, 9999,
+        is_free_burning_ruin, 0, distance);
+    if (!min_free_building_id) {
+        min_free_building_id = building_spatial_find_closest(BUILDING_BURNING_RUIN, x, y, 2,
+            is_occupied_burning_ruin, 0, 0);
+        if (min_free_building_id) {
+            *distance = 2;
         }
     }
-    if (!min_free_building_id && min_occupied_dist <= 2) {
-        min_free_building_id = min_occupied_building_id;
-        *distance = 2;
-    }
     return min_free_building_id;
 }
 
@@ -178,8 +176,11 @@ void building_maintenance_check_fire_collapse(void)
         return; // skip fire/collapse checks in very early game to avoid frustrating the player
     }
     for (int i = 1; i < building_count(); i++) {
+        if (building_get_hot_data()[i].state != BUILDING_STATE_IN_USE) {
+            continue;
+        }
         building *b = building_get(i);
-        if (b->state != BUILDING_STATE_IN_USE || b->fire_proof || b->state == BUILDING_STATE_RUBBLE) {
+        if (b->fire_proof) {
             continue;
         }
         if (b->type == BUILDING_HIPPODROME && b->prev_part_building_id) {
@@ -241,10 +242,10 @@ void building_maintenance_check_rome_access(void)
     map_routing_calculate_distances(entry_point->x, entry_point->y);
     int problem_grid_offset = 0;
     for (int i = 1; i < building_count(); i++) {
-        building *b = building_get(i);
-        if (b->state != BUILDING_STATE_IN_USE) {
+        if (building_get_hot_data()[i].state != BUILDING_STATE_IN_USE) {
             continue;
         }
+        building *b = building_get(i);
         int road_grid_offset = -1;
         int x_road = 0;
         int y_road = 0;
@@ -259,7 +260,7 @@ void building_maintenance_check_rome_access(void)
                         b->house_population = 0;
                         b->house_unreachable_ticks = 0;
                     }
-                    b->state = BUILDING_STATE_UNDO;
+                    building_set_state(b, BUILDING_STATE_UNDO);
                 }
             } else {
                 int distance = map_routing_distance(map_grid_offset(x_road, y_road));
@@ -279,7 +280,7 @@ void building_maintenance_check_rome_access(void)
                     b->house_unreachable_ticks++;
                     if (b->house_unreachable_ticks > 8) {
                         b->house_unreachable_ticks = 0;
-                        b->state = BUILDING_STATE_UNDO;
+                        building_set_state(b, BUILDING_STATE_UNDO);
                     }
                 }
                 b->road_access_x = x_road;
@@ -3,6 +3,7 @@
 #include "assets/assets.h"
 #include "building/image.h"
 #include "building/properties.h"
+#include "city/culture.h"
 #include "city/finance.h"
 #include "city/message.h"
 #include "city/resource.h"
@@ -366,6 +367,7 @@ void building_monument_set_phase(building *b, int phase)
         return;
     }
     b->monument.phase = phase;
+    city_culture_update_building(b);
     map_building_tiles_add(b->id, b->x, b->y, b->size, building_image_get(b), TERRAIN_BUILDING);
     if (b->monument.phase != MONUMENT_FINISHED) {
         for (int resource = 0; resource < RESOURCE_MAX; resource++) {
@@ -793,10 +795,10 @@ int building_monument_is_construction_halted(building *b)
 int building_monument_toggle_construction_halted(building *b)
 {
     if (b->state == BUILDING_STATE_MOTHBALLED) {
-        b->state = BUILDING_STATE_IN_USE;
+        building_set_state(b, BUILDING_STATE_IN_USE);
         return 0;
     } else {
-        b->state = BUILDING_STATE_MOTHBALLED;
+        building_set_state(b, BUILDING_STATE_MOTHBALLED);
         return 1;
     }
 }
@@ -10,6 +10,7 @@
 #include <stdlib.h>
 
 static model_building buildings[BUILDING_TYPE_MAX];
+static unsigned int model_generation;
 
 // PROPERTIES
 
@@ -2242,6 +2243,7 @@ void model_reset(void)
             buildings[type] = NOTHING;
         }
     }
+    model_data_changed();
 }
 
 void model_save_model_data(buffer *buf)
@@ -2258,6 +2260,17 @@ void model_load_model_data(buffer *buf)
     int buf_size = sizeof(model_building) * BUILDING_TYPE_MAX;
 
     buffer_read_raw(buf, buildings, buf_size);
+    model_data_changed();
+}
+
+void model_data_changed(void)
+{
+    model_generation++;
+}
+
+unsigned int model_data_generation(void)
+{
+    return model_generation;
 }
 
 const model_house *model_get_house(house_level level)
@@ -60,6 +60,17 @@ void model_reset(void);
 void model_save_model_data(buffer *buf);
 void model_load_model_data(buffer *buf);
 
+/**
+ * Must be called after changing the model data, so that the results derived from it are recalculated
+ */
+void model_data_changed(void);
+
+/**
+ * Gets a number that changes every time the model data changes
+ * @return The model data generation
+ */
+unsigned int model_data_generation(void);
+
 /**
  * Gets the model for a building
  * @param type Building type
@@ -2,10 +2,12 @@
 
 #include "building/building.h"
 #include "building/type.h"
+#include "game/replay.h"
 
 void building_roadblock_set_permission(roadblock_permission p, building *b)
 {
     if (building_type_is_roadblock(b->type)) {
+        game_replay_record_action(REPLAY_ACTION_ROADBLOCK_PERMISSION, p, b->id, 0);
         int permission_bit = 1 << p;
         b->data.roadblock.exceptions ^= permission_bit;
     }
@@ -47,6 +49,7 @@ int building_type_is_roadblock(building_type type)
 void building_roadblock_accept_none(building *b)
 {
     if (building_type_is_roadblock(b->type)) {
+        game_replay_record_action(REPLAY_ACTION_ROADBLOCK_ACCEPT_NONE, b->id, 0, 0);
         b->data.roadblock.exceptions = 0;
     }
 }
@@ -54,6 +57,7 @@ void building_roadblock_accept_none(building *b)
 void building_roadblock_accept_all(building *b)
 {
     if (building_type_is_roadblock(b->type)) {
+        game_replay_record_action(REPLAY_ACTION_ROADBLOCK_ACCEPT_ALL, b->id, 0, 0);
         b->data.roadblock.exceptions = ROADBLOCK_PERMISSION_ALL;
     }
 }
@@ -131,6 +131,18 @@ int building_rotation_get_rotation(void)
     return data.rotation;
 }
 
+int building_rotation_get_extra_rotation(void)
+{
+    return data.extra_rotation;
+}
+
+void building_rotation_set_state(int rotation, int extra_rotation, int road_orientation)
+{
+    data.rotation = rotation;
+    data.extra_rotation = extra_rotation;
+    data.road_orientation = road_orientation;
+}
+
 int building_rotation_get_rotation_with_limit(int limit)
 {
     return data.extra_rotation % limit;
@@ -10,6 +10,8 @@ int building_rotation_get_building_orientation(int);
 int building_rotation_get_delta_with_rotation(int default_delta);
 void building_rotation_get_offset_with_rotation(int offset, int rotation, int *x, int *y);
 int building_rotation_get_rotation(void);
+int building_rotation_get_extra_rotation(void);
+void building_rotation_set_state(int rotation, int extra_rotation, int road_orientation);
 
 int building_rotation_get_rotation_with_limit(int limit);
 
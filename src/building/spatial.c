@@ -0,0 +1,248 @@
+#include "spatial.h"
+
+#include "core/calc.h"
+#include "core/log.h"
+#include "map/grid.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define BUCKET_SHIFT 3
+#define BUCKET_SIZE (1 << BUCKET_SHIFT)
+#define BUCKETS_PER_SIDE ((GRID_SIZE_MAX + BUCKET_SIZE - 1) / BUCKET_SIZE)
+#define TOTAL_BUCKETS (BUCKETS_PER_SIDE * BUCKETS_PER_SIDE)
+
+#define ENTRIES_SIZE_STEP 2000
+#define FOUND_SIZE_STEP 100
+
+typedef struct {
+    unsigned int prev;
+    unsigned int next;
+    unsigned short bucket;
+    unsigned char type;
+    unsigned char indexed;
+} spatial_entry;
+
+typedef struct {
+    building_type type;
+    int x;
+    int y;
+    building_spatial_filter filter;
+    void *userdata;
+    unsigned int best_id;
+    int best_distance;
+} closest_search;
+
+static struct {
+    unsigned int *first_in_bucket[BUILDING_TYPE_MAX];
+    unsigned int total[BUILDING_TYPE_MAX];
+    spatial_entry *entries;
+    unsigned int entries_capacity;
+    struct {
+        unsigned int *items;
+        unsigned int size;
+        unsigned int capacity;
+    } found;
+} data;
+
+static int to_bucket_coordinate(int value)
+{
+    return calc_bound(value, 0, GRID_SIZE_MAX - 1) >> BUCKET_SHIFT;
+}
+
+static int ensure_entries_capacity(unsigned int id)
+{
+    if (id < data.entries_capacity) {
+        return 1;
+    }
+    unsigned int new_capacity = (id / ENTRIES_SIZE_STEP + 1) * ENTRIES_SIZE_STEP;
+    spatial_entry *entries = realloc(data.entries, new_capacity * sizeof(spatial_entry));
+    if (!entries) {
+        return 0;
+    }
+    memset(&entries[data.entries_capacity], 0, (new_capacity - data.entries_capacity) * sizeof(spatial_entry));
+    data.entries = entries;
+    data.entries_capacity = new_capacity;
+    return 1;
+}
+
+void building_spatial_remove(building *b)
+{
+    if (b->id >= data.entries_capacity || !data.entries[b->id].indexed) {
+        return;
+    }
+    spatial_entry *entry = &data.entries[b->id];
+    if (entry->prev) {
+        data.entries[entry->prev].next = entry->next;
+    } else {
+        data.first_in_bucket[entry->type][entry->bucket] = entry->next;
+    }
+    if (entry->next) {
+        data.entries[entry->next].prev = entry->prev;
+    }
+    data.total[entry->type]--;
+    memset(entry, 0, sizeof(spatial_entry));
+}
+
+void building_spatial_update(building *b)
+{
+    building_spatial_remove(b);
+    if (!b->id || b->type == BUILDING_NONE || b->state == BUILDING_STATE_UNUSED) {
+        return;
+    }
+    if (!ensure_entries_capacity(b->id)) {
+        log_error("Unable to allocate enough memory for the building spatial index. The game will now crash.", 0, 0);
+        return;
+    }
+    if (!data.first_in_bucket[b->type]) {
+        data.first_in_bucket[b->type] = calloc(TOTAL_BUCKETS, sizeof(unsigned int));
+        if (!data.first_in_bucket[b->type]) {
+            log_error("Unable to allocate enough memory for the building spatial index. The game will now crash.", 0, 0);
+            return;
+        }
+    }
+    int bucket = to_bucket_coordinate(b->y) * BUCKETS_PER_SIDE + to_bucket_coordinate(b->x);
+    unsigned int *first = &data.first_in_bucket[b->type][bucket];
+    spatial_entry *entry = &data.entries[b->id];
+    entry->prev = 0;
+    entry->next = *first;
+    entry->bucket = bucket;
+    entry->type = b->type;
+    entry->indexed = 1;
+    if (*first) {
+        data.entries[*first].prev = b->id;
+    }
+    *first = b->id;
+    data.total[b->type]++;
+}
+
+void building_spatial_clear(void)
+{
+    for (int type = 0; type < BUILDING_TYPE_MAX; type++) {
+        if (data.first_in_bucket[type]) {
+            memset(data.first_in_bucket[type], 0, TOTAL_BUCKETS * sizeof(unsigned int));
+        }
+    }
+    memset(data.total, 0, sizeof(data.total));
+    if (data.entries) {
+        memset(data.entries, 0, data.entries_capacity * sizeof(spatial_entry));
+    }
+}
+
+static void search_bucket(closest_search *search, int bucket_x, int bucket_y)
+{
+    unsigned int id = data.first_in_bucket[search->type][bucket_y * BUCKETS_PER_SIDE + bucket_x];
+    while (id) {
+        building *b = building_get(id);
+        int distance = calc_maximum_distance(search->x, search->y, b->x, b->y);
+        if ((distance < search->best_distance || (distance == search->best_distance && id < search->best_id)) &&
+            (!search->filter || search->filter(b, search->userdata))) {
+            search->best_distance = distance;
+            search->best_id = id;
+        }
+        id = data.entries[id].next;
+    }
+}
+
+int building_spatial_find_closest(building_type type, int x, int y, int max_distance,
+    building_spatial_filter filter, void *userdata, int *distance)
+{
+    if (!data.total[type] || max_distance < 0) {
+        return 0;
+    }
+    closest_search search = { type, x, y, filter, userdata, 0, 0 };
+    // A distance of max_distance must still be accepted, so start one above it
+    search.best_distance = calc_bound(max_distance, 0, 2 * GRID_SIZE_MAX) + 1;
+
+    int center_x = to_bucket_coordinate(x);
+    int center_y = to_bucket_coordinate(y);
+    int max_ring = BUCKETS_PER_SIDE - 1;
+
+    for (int ring = 0; ring <= max_ring; ring++) {
+        // Any building in this ring or further out is at least this far away
+        int min_ring_distance = ring ? (ring - 1) * BUCKET_SIZE + 1 : 0;
+        if (min_ring_distance > search.best_distance ||
+            (!search.best_id && min_ring_distance >= search.best_distance)) {
+            break;
+        }
+        int min_x = center_x - ring;
+        int max_x = center_x + ring;
+        int min_y = center_y - ring;
+        int max_y = center_y + ring;
+        for (int bucket_y = min_y; bucket_y <= max_y; bucket_y++) {
+            if (bucket_y < 0 || bucket_y >= BUCKETS_PER_SIDE) {
+                continue;
+            }
+            int step = (bucket_y == min_y || bucket_y == max_y) ? 1 : max_x - min_x;
+            for (int bucket_x = min_x; bucket_x <= max_x; bucket_x += step) {
+                if (bucket_x >= 0 && bucket_x < BUCKETS_PER_SIDE) {
+                    search_bucket(&search, bucket_x, bucket_y);
+                }
+            }
+        }
+    }
+    if (search.best_id && distance) {
+        *distance = search.best_distance;
+    }
+    return search.best_id;
+}
+
+static int compare_ids(const void *a, const void *b)
+{
+    unsigned int id_a = *(const unsigned int *) a;
+    unsigned int id_b = *(const unsigned int *) b;
+    return (id_a > id_b) - (id_a < id_b);
+}
+
+static int add_found(unsigned int id)
+{
+    if (data.found.size >= data.found.capacity) {
+        unsigned int new_capacity = data.found.capacity + FOUND_SIZE_STEP;
+        unsigned int *items = realloc(data.found.items, new_capacity * sizeof(unsigned int));
+        if (!items) {
+            return 0;
+        }
+        data.found.items = items;
+        data.found.capacity = new_capacity;
+    }
+    data.found.items[data.found.size++] = id;
+    return 1;
+}
+
+void building_spatial_foreach_in_range(building_type type, int x, int y, int range,
+    building_spatial_callback callback, void *userdata)
+{
+    if (!data.total[type] || range < 0) {
+        return;
+    }
+    if (range >= GRID_SIZE_MAX) {
+        // The whole map is in range, the type list is already sorted by id
+        for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
+            callback(b, userdata);
+        }
+        return;
+    }
+    int min_x = to_bucket_coordinate(x - range);
+    int max_x = to_bucket_coordinate(x + range);
+    int min_y = to_bucket_coordinate(y - range);
+    int max_y = to_bucket_coordinate(y + range);
+    data.found.size = 0;
+    for (int bucket_y = min_y; bucket_y <= max_y; bucket_y++) {
+        for (int bucket_x = min_x; bucket_x <= max_x; bucket_x++) {
+            unsigned int id = data.first_in_bucket[type][bucket_y * BUCKETS_PER_SIDE + bucket_x];
+            while (id) {
+                building *b = building_get(id);
+                if (calc_maximum_distance(x, y, b->x, b->y) <= range && !add_found(id)) {
+                    log_error("Unable to allocate enough memory for the building spatial query. The game will now crash.",
+                        0, 0);
+                    return;
+                }
+                id = data.entries[id].next;
+            }
+        }
+    }
+    qsort(data.found.items, data.found.size, sizeof(unsigned int), compare_ids);
+    for (unsigned int i = 0; i < data.found.size; i++) {
+        callback(building_get(data.found.items[i]), userdata);
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef BUILDING_SPATIAL_H
+#define BUILDING_SPATIAL_H
+
+#include "building/building.h"
+#include "building/type.h"
+
+/**
+ * @file
+ * Per building type spatial buckets for nearest building and range queries
+ */
+
+/**
+ * Filter for spatial queries
+ * @param b The candidate building
+ * @param userdata The userdata passed to the query
+ * @return 1 if the building can be returned by the query, 0 otherwise
+ */
+typedef int (*building_spatial_filter)(building *b, void *userdata);
+
+/**
+ * Callback for buildings found by a range query
+ * @param b The building
+ * @param userdata The userdata passed to the query
+ */
+typedef void (*building_spatial_callback)(building *b, void *userdata);
+
+/**
+ * Adds a building to the index, or moves it to the right bucket if it is already indexed.
+ * Must be called whenever a building is created, changes type or changes its position.
+ * @param b The building
+ */
+void building_spatial_update(building *b);
+
+/**
+ * Removes a building from the index
+ * @param b The building
+ */
+void building_spatial_remove(building *b);
+
+/**
+ * Clears the index
+ */
+void building_spatial_clear(void);
+
+/**
+ * Finds the building of the given type closest to the given point, measured from the building's x/y.
+ * Ties are resolved in favour of the lowest building id, like a scan of the building type list would.
+ * @param type The building type to look for
+ * @param x The x coordinate of the point
+ * @param y The y coordinate of the point
+ * @param max_distance The maximum distance a building can be from the point
+ * @param filter Only buildings for which the filter returns 1 are considered, can be 0
+ * @param userdata Passed to the filter
+ * @param distance Set to the distance to the returned building, if one was found
+ * @return The id of the closest building, or 0 if there is none
+ */
+int building_spatial_find_closest(building_type type, int x, int y, int max_distance,
+    building_spatial_filter filter, void *userdata, int *distance);
+
+/**
+ * Calls the callback for every building of the given type whose x/y is within range of the given point,
+ * in ascending building id order
+ * @param type The building type to look for
+ * @param x The x coordinate of the point
+ * @param y The y coordinate of the point
+ * @param range The maximum distance a building can be from the point
+ * @param callback The callback to call
+ * @param userdata Passed to the callback
+ */
+void building_spatial_foreach_in_range(building_type type, int x, int y, int range,
+    building_spatial_callback callback, void *userdata);
+
+#endif // BUILDING_SPATIAL_H
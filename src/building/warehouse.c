@@ -6,6 +6,7 @@
 #include "building/industry.h"
 #include "building/monument.h"
 #include "building/properties.h"
+#include "building/spatial.h"
 #include "building/storage.h"
 #include "city/finance.h"
 #include "city/resource.h"
@@ -616,23 +617,28 @@ int building_warehouse_accepts_storage(building *warehouse, int resource, int *u
     return 0;
 }
 
+typedef struct {
+    unsigned int src_building_id;
+    int resource;
+    int road_network_id;
+    int *understaffed;
+} storing_search;
+
+static int can_store_in_warehouse(building *b, void *userdata)
+{
+    storing_search *search = userdata;
+    return b->id != search->src_building_id &&
+        (search->road_network_id == -1 || b->road_network_id == search->road_network_id) &&
+        building_warehouse_accepts_storage(b, search->resource, search->understaffed) &&
+        building_warehouse_maximum_receptible_amount(b, search->resource) > 0;
+}
+
 int building_warehouse_for_storing(int src_building_id, int x, int y, int resource, int road_network_id,
     int *understaffed, map_point *dst)
 {
-    int min_dist = INFINITE;
-    int min_building_id = 0;
-    for (building *b = building_first_of_type(BUILDING_WAREHOUSE); b; b = b->next_of_type) {
-        if (b->id == (unsigned int) src_building_id || (road_network_id != -1 && b->road_network_id != road_network_id) ||
-            !building_warehouse_accepts_storage(b, resource, understaffed) ||
-            (building_warehouse_maximum_receptible_amount(b, resource) <= 0)) {
-            continue;
-        }
-        int dist = calc_maximum_distance(b->x, b->y, x, y);
-        if (dist < min_dist) {
-            min_dist = dist;
-            min_building_id = b->id;
-        }
-    }
+    storing_search search = { src_building_id, resource, road_network_id, understaffed };
+    int min_building_id = building_spatial_find_closest(BUILDING_WAREHOUSE, x, y, INFINITE - 1,
+        can_store_in_warehouse, &search, 0);
     building *b = building_get(min_building_id);
     if (b->has_road_access == 1) {
         map_point_store_result(b->x, b->y, dst);
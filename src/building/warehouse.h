@@ -221,7 +221,7 @@ int building_warehouse_for_getting(building *src, int resource, map_point *dst);
  * @param y The y-coordinate of the source position
  * @param resource The resource type
  * @param road_network_id The road network ID of the source position, must be matched
- * @param understaffed Pointer to an integer that will be incremented if the selected warehouse is understaffed
+ * @param understaffed Pointer to an integer that will be incremented for each understaffed warehouse that was considered
  * @param dst Pointer to the destination map point
  * @return ID of the warehouse, or 0 if none found
  */
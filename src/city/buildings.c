@@ -1,5 +1,6 @@
 #include "buildings.h"
 
+#include "building/spatial.h"
 #include "city/data_private.h"
 #include "core/calc.h"
 
@@ -116,52 +117,56 @@ void city_buildings_main_native_meeting_center(int *x, int *y)
     *y = native_meeting->y;
 }
 
-int city_buildings_get_closest_plague(int x, int y, int *distance)
+static int is_free_plague_building(building *b, void *userdata)
+{
+    return b->state == BUILDING_STATE_IN_USE && b->has_plague && b->distance_from_entry && !b->figure_id4;
+}
+
+static int is_occupied_plague_building(building *b, void *userdata)
+{
+    return b->state == BUILDING_STATE_IN_USE && b->has_plague && b->distance_from_entry && b->figure_id4;
+}
+
+static int find_closest_plague_of_type(building_type type, int x, int y, building_spatial_filter filter,
+    int *min_building_id, int *min_dist)
+{
+    // Only a strictly closer building replaces one found for a previous type
+    int dist;
+    int building_id = building_spatial_find_closest(type, x, y, *min_dist - 1, filter, 0, &dist);
+    if (building_id) {
+        *min_building_id = building_id;
+        *min_dist = dist;
+    }
+    return building_id;
+}
+
+static int find_closest_plague(int x, int y, building_spatial_filter filter, int *min_dist)
 {
-    int min_free_building_id = 0;
-    int min_occupied_building_id = 0;
-    int min_occupied_dist = *distance = 10000;
+    int min_building_id = 0;
 
     // Find closest in houses
     for (building_type type = BUILDING_HOUSE_SMALL_TENT; type <= BUILDING_HOUSE_LUXURY_PALACE; type++) {
-        for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
-            if (b->state == BUILDING_STATE_IN_USE && b->has_plague && b->distance_from_entry) {
-                int dist = calc_maximum_distance(x, y, b->x, b->y);
-                if (b->figure_id4) {
-                    if (dist < min_occupied_dist) {
-                        min_occupied_dist = dist;
-                        min_occupied_building_id = b->id;
-                    }
-                } else if (dist < *distance) {
-                    *distance = dist;
-                    min_free_building_id = b->id;
-                }
-            }
-        }
+        find_closest_plague_of_type(type, x, y, filter, &min_building_id, min_dist);
     }
 
     // Find closest in buildings (docks, granaries or warehouses)
     for (size_t i = 0 ; i < NUM_PLAGUE_BUILDINGS; i++) {
-        building_type type = PLAGUE_BUILDINGS[i];
-        for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
-            if (b->state == BUILDING_STATE_IN_USE && b->has_plague && b->distance_from_entry) {
-                int dist = calc_maximum_distance(x, y, b->x, b->y);
-                if (b->figure_id4) {
-                    if (dist < min_occupied_dist) {
-                        min_occupied_dist = dist;
-                        min_occupied_building_id = b->id;
-                    }
-                } else if (dist < *distance) {
-                    *distance = dist;
-                    min_free_building_id = b->id;
-                }
-            }
-        }
+        find_closest_plague_of_type(PLAGUE_BUILDINGS[i], x, y, filter, &min_building_id, min_dist);
     }
+    return min_building_id;
+}
 
-    if (!min_free_building_id && min_occupied_dist <= 2) {
-        min_free_building_id = min_occupied_building_id;
-        *distance = 2;
+int city_buildings_get_closest_plague(int x, int y, int *distance)
+{
+    *distance = 10000;
+    int min_free_building_id = find_closest_plague(x, y, is_free_plague_building, distance);
+
+    if (!min_free_building_id) {
+        int min_occupied_dist = 3;
+        min_free_building_id = find_closest_plague(x, y, is_occupied_plague_building, &min_occupied_dist);
+        if (min_free_building_id) {
+            *distance = 2;
+        }
     }
     return min_free_building_id;
 }
@@ -1,7 +1,6 @@
 #include "culture.h"
 
 #include "building/building.h"
-#include "building/count.h"
 #include "building/monument.h"
 #include "city/constants.h"
 #include "city/data_private.h"
@@ -9,6 +8,10 @@
 #include "city/festival.h"
 #include "city/population.h"
 #include "core/calc.h"
+#include "core/log.h"
+
+#include <stdlib.h>
+#include <string.h>
 
 #define LARARIUM_COVERAGE 10
 #define SHRINE_COVERAGE 50
@@ -19,6 +22,21 @@
 #define PANTHEON_COVERAGE 1500
 #define GRAND_TEMPLE_COVERAGE 5000
 
+#define BUILDINGS_SIZE_STEP 500
+
+#define COUNTED_TOTAL 1
+#define COUNTED_ACTIVE 2
+#define COUNTED_UPGRADED 4
+
+static const building_type GOD_TEMPLES[5][4] = {
+    { BUILDING_SHRINE_CERES, BUILDING_SMALL_TEMPLE_CERES, BUILDING_LARGE_TEMPLE_CERES, BUILDING_GRAND_TEMPLE_CERES },
+    { BUILDING_SHRINE_NEPTUNE, BUILDING_SMALL_TEMPLE_NEPTUNE, BUILDING_LARGE_TEMPLE_NEPTUNE,
+        BUILDING_GRAND_TEMPLE_NEPTUNE },
+    { BUILDING_SHRINE_MERCURY, BUILDING_SMALL_TEMPLE_MERCURY, BUILDING_LARGE_TEMPLE_MERCURY,
+        BUILDING_GRAND_TEMPLE_MERCURY },
+    { BUILDING_SHRINE_MARS, BUILDING_SMALL_TEMPLE_MARS, BUILDING_LARGE_TEMPLE_MARS, BUILDING_GRAND_TEMPLE_MARS },
+    { BUILDING_SHRINE_VENUS, BUILDING_SMALL_TEMPLE_VENUS, BUILDING_LARGE_TEMPLE_VENUS, BUILDING_GRAND_TEMPLE_VENUS }
+};
 
 static struct {
     int theater;
@@ -35,6 +53,249 @@ static struct {
     int arena;
 } coverage;
 
+typedef struct {
+    building_type type;
+    unsigned char venue;
+    unsigned char shows;
+    unsigned char no_shows_weighted;
+    unsigned char is_house;
+    unsigned char entertainment;
+    unsigned char num_gods;
+    unsigned char education;
+    unsigned char health;
+    int desirability;
+    int venus_population;
+} counted_building;
+
+typedef struct {
+    int total;
+    int active;
+    int upgraded;
+    int shows;
+    int no_shows_weighted;
+} venue_counts;
+
+static struct {
+    counted_building *buildings;
+    unsigned int capacity;
+    int is_valid;
+    venue_counts venues[BUILDING_TYPE_MAX];
+    struct {
+        int count;
+        int entertainment;
+        int religion;
+        int education;
+        int health;
+        int desirability;
+        int venus_population;
+    } houses;
+} counters;
+
+static city_culture_snapshot snapshot;
+
+static int is_counted_venue(building_type type)
+{
+    switch (type) {
+        case BUILDING_TAVERN:
+        case BUILDING_THEATER:
+        case BUILDING_AMPHITHEATER:
+        case BUILDING_ARENA:
+        case BUILDING_SCHOOL:
+        case BUILDING_LIBRARY:
+        case BUILDING_ACADEMY:
+        case BUILDING_HOSPITAL:
+        case BUILDING_LARARIUM:
+        case BUILDING_ORACLE:
+        case BUILDING_SMALL_MAUSOLEUM:
+        case BUILDING_NYMPHAEUM:
+        case BUILDING_LARGE_MAUSOLEUM:
+        case BUILDING_PANTHEON:
+            return 1;
+        default:
+            break;
+    }
+    for (god_type god = GOD_CERES; god <= GOD_VENUS; god++) {
+        for (int i = 0; i < 4; i++) {
+            if (GOD_TEMPLES[god][i] == type) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static void count_shows(const building *b, counted_building *counted)
+{
+    if (b->state != BUILDING_STATE_IN_USE) {
+        return;
+    }
+    int has_show1 = b->data.entertainment.days1 != 0;
+    int has_show2 = b->data.entertainment.days2 != 0;
+    switch (b->type) {
+        case BUILDING_THEATER:
+            counted->shows = has_show1;
+            counted->no_shows_weighted = !has_show1;
+            break;
+        case BUILDING_AMPHITHEATER:
+            counted->shows = has_show1 + has_show2;
+            counted->no_shows_weighted = 2 * (!has_show1 + !has_show2);
+            break;
+        case BUILDING_ARENA:
+        case BUILDING_COLOSSEUM:
+            counted->shows = has_show1 + has_show2;
+            counted->no_shows_weighted = 3 * (!has_show1 + !has_show2);
+            break;
+        case BUILDING_HIPPODROME:
+            counted->shows = has_show1;
+            counted->no_shows_weighted = has_show1 ? 0 : 100;
+            break;
+        default:
+            break;
+    }
+}
+
+static void count_venue(building *b, counted_building *counted)
+{
+    if (b != building_main(b)) {
+        return;
+    }
+    if (b->state == BUILDING_STATE_IN_USE || b->state == BUILDING_STATE_CREATED) {
+        counted->venue |= COUNTED_TOTAL;
+        if (b->upgrade_level > 0) {
+            counted->venue |= COUNTED_UPGRADED;
+        }
+    }
+    if (building_is_active(b)) {
+        counted->venue |= COUNTED_ACTIVE;
+    }
+}
+
+static void count_house(const building *b, counted_building *counted)
+{
+    if (b->state != BUILDING_STATE_IN_USE || !b->house_size ||
+        b->type < BUILDING_HOUSE_SMALL_TENT || b->type > BUILDING_HOUSE_LUXURY_PALACE) {
+        return;
+    }
+    counted->is_house = 1;
+    counted->entertainment = b->data.house.entertainment;
+    counted->num_gods = b->data.house.num_gods;
+    counted->education = b->data.house.education;
+    counted->health = b->data.house.health;
+    counted->desirability = b->desirability;
+    counted->venus_population = b->data.house.temple_venus ? b->house_population : 0;
+}
+
+static void add_counted(const counted_building *counted, int sign)
+{
+    venue_counts *venue = &counters.venues[counted->type];
+    venue->total += sign * ((counted->venue & COUNTED_TOTAL) != 0);
+    venue->active += sign * ((counted->venue & COUNTED_ACTIVE) != 0);
+    venue->upgraded += sign * ((counted->venue & COUNTED_UPGRADED) != 0);
+    venue->shows += sign * counted->shows;
+    venue->no_shows_weighted += sign * counted->no_shows_weighted;
+    if (counted->is_house) {
+        counters.houses.count += sign;
+        counters.houses.entertainment += sign * counted->entertainment;
+        counters.houses.religion += sign * counted->num_gods;
+        counters.houses.education += sign * counted->education;
+        counters.houses.health += sign * counted->health;
+        counters.houses.desirability += sign * counted->desirability;
+        counters.houses.venus_population += sign * counted->venus_population;
+    }
+}
+
+static int ensure_capacity(unsigned int id)
+{
+    if (id < counters.capacity) {
+        return 1;
+    }
+    unsigned int new_capacity = (id / BUILDINGS_SIZE_STEP + 1) * BUILDINGS_SIZE_STEP;
+    counted_building *buildings = realloc(counters.buildings, new_capacity * sizeof(counted_building));
+    if (!buildings) {
+        log_error("Unable to allocate enough memory for the culture counters. The game will now crash.", 0, 0);
+        return 0;
+    }
+    memset(&buildings[counters.capacity], 0, (new_capacity - counters.capacity) * sizeof(counted_building));
+    counters.buildings = buildings;
+    counters.capacity = new_capacity;
+    return 1;
+}
+
+static void update_building(building *b)
+{
+    if (!ensure_capacity(b->id)) {
+        return;
+    }
+    counted_building *counted = &counters.buildings[b->id];
+    add_counted(counted, -1);
+    memset(counted, 0, sizeof(counted_building));
+    counted->type = b->type;
+    if (is_counted_venue(b->type)) {
+        count_venue(b, counted);
+    }
+    count_shows(b, counted);
+    count_house(b, counted);
+    add_counted(counted, 1);
+}
+
+static void ensure_counters(void)
+{
+    if (counters.is_valid) {
+        return;
+    }
+    counters.is_valid = 1;
+    if (counters.buildings) {
+        memset(counters.buildings, 0, counters.capacity * sizeof(counted_building));
+    }
+    memset(counters.venues, 0, sizeof(counters.venues));
+    memset(&counters.houses, 0, sizeof(counters.houses));
+    for (int i = 1; i < building_count(); i++) {
+        building *b = building_get(i);
+        if (b->state != BUILDING_STATE_UNUSED) {
+            update_building(b);
+        }
+    }
+}
+
+void city_culture_update_building(building *b)
+{
+    if (counters.is_valid && b->id) {
+        update_building(b);
+    }
+}
+
+void city_culture_reset_counters(void)
+{
+    counters.is_valid = 0;
+}
+
+static int count_active(building_type type)
+{
+    return counters.venues[type].active;
+}
+
+static int count_total(building_type type)
+{
+    return counters.venues[type].total;
+}
+
+static int count_upgraded(building_type type)
+{
+    return counters.venues[type].upgraded;
+}
+
+int city_culture_venue_shows(building_type type)
+{
+    ensure_counters();
+    return counters.venues[type].shows;
+}
+
+int city_culture_venue_no_shows_weighted(building_type type)
+{
+    ensure_counters();
+    return counters.venues[type].no_shows_weighted;
+}
+
 int city_culture_coverage_tavern(void)
 {
     return coverage.tavern;
@@ -117,6 +378,7 @@ static int top(int input)
 
 void city_culture_update_coverage(void)
 {
+    ensure_counters();
     int population = city_data.population.population;
 
     // entertainment
@@ -138,71 +400,24 @@ void city_culture_update_coverage(void)
     }
 
     // religion
-    int oracles = building_count_active(BUILDING_ORACLE);
-    int larariums = building_count_total(BUILDING_LARARIUM);
-    int nymphaeums = building_count_active(BUILDING_NYMPHAEUM);
-    int small_mausoleums = building_count_active(BUILDING_SMALL_MAUSOLEUM);
-    int large_mausoleums = building_count_active(BUILDING_LARGE_MAUSOLEUM);
-    coverage.religion[GOD_CERES] = top(calc_percentage(
-        LARARIUM_COVERAGE * larariums +
-        ORACLE_COVERAGE * oracles +
-        ORACLE_COVERAGE * small_mausoleums +
-        LARGE_ORACLE_COVERAGE * nymphaeums +
-        LARGE_ORACLE_COVERAGE * large_mausoleums +
-        SHRINE_COVERAGE * building_count_active(BUILDING_SHRINE_CERES) +
-        SMALL_TEMPLE_COVERAGE * building_count_active(BUILDING_SMALL_TEMPLE_CERES) +
-        LARGE_TEMPLE_COVERAGE * building_count_active(BUILDING_LARGE_TEMPLE_CERES) +
-        PANTHEON_COVERAGE * building_count_active(BUILDING_PANTHEON) +
-        GRAND_TEMPLE_COVERAGE * building_count_active(BUILDING_GRAND_TEMPLE_CERES),
-        population));
-    coverage.religion[GOD_NEPTUNE] = top(calc_percentage(
-        LARARIUM_COVERAGE * larariums +
-        ORACLE_COVERAGE * oracles +
-        ORACLE_COVERAGE * small_mausoleums +
-        LARGE_ORACLE_COVERAGE * nymphaeums +
-        LARGE_ORACLE_COVERAGE * large_mausoleums +
-        SHRINE_COVERAGE * building_count_active(BUILDING_SHRINE_NEPTUNE) +
-        SMALL_TEMPLE_COVERAGE * building_count_active(BUILDING_SMALL_TEMPLE_NEPTUNE) +
-        LARGE_TEMPLE_COVERAGE * building_count_active(BUILDING_LARGE_TEMPLE_NEPTUNE) +
-        PANTHEON_COVERAGE * building_count_active(BUILDING_PANTHEON) +
-        GRAND_TEMPLE_COVERAGE * building_count_active(BUILDING_GRAND_TEMPLE_NEPTUNE),
-        population));
-    coverage.religion[GOD_MERCURY] = top(calc_percentage(
-        LARARIUM_COVERAGE * larariums +
-        ORACLE_COVERAGE * oracles +
-        ORACLE_COVERAGE * small_mausoleums +
-        LARGE_ORACLE_COVERAGE * nymphaeums +
-        LARGE_ORACLE_COVERAGE * large_mausoleums +
-        SHRINE_COVERAGE * building_count_active(BUILDING_SHRINE_MERCURY) +
-        SMALL_TEMPLE_COVERAGE * building_count_active(BUILDING_SMALL_TEMPLE_MERCURY) +
-        LARGE_TEMPLE_COVERAGE * building_count_active(BUILDING_LARGE_TEMPLE_MERCURY) +
-        PANTHEON_COVERAGE * building_count_active(BUILDING_PANTHEON) +
-        GRAND_TEMPLE_COVERAGE * building_count_active(BUILDING_GRAND_TEMPLE_MERCURY),
-        population));
-    coverage.religion[GOD_MARS] = top(calc_percentage(
-        LARARIUM_COVERAGE * larariums +
+    int oracles = count_active(BUILDING_ORACLE);
+    int shared_religion_coverage =
+        LARARIUM_COVERAGE * count_total(BUILDING_LARARIUM) +
         ORACLE_COVERAGE * oracles +
-        ORACLE_COVERAGE * small_mausoleums +
-        LARGE_ORACLE_COVERAGE * nymphaeums +
-        LARGE_ORACLE_COVERAGE * large_mausoleums +
-        SHRINE_COVERAGE * building_count_active(BUILDING_SHRINE_MARS) +
-        SMALL_TEMPLE_COVERAGE * building_count_active(BUILDING_SMALL_TEMPLE_MARS) +
-        LARGE_TEMPLE_COVERAGE * building_count_active(BUILDING_LARGE_TEMPLE_MARS) +
-        PANTHEON_COVERAGE * building_count_active(BUILDING_PANTHEON) +
-        GRAND_TEMPLE_COVERAGE * building_count_active(BUILDING_GRAND_TEMPLE_MARS),
-        population));
-    coverage.religion[GOD_VENUS] = top(calc_percentage(
-        LARARIUM_COVERAGE * larariums +
-        ORACLE_COVERAGE * oracles +
-        ORACLE_COVERAGE * small_mausoleums +
-        LARGE_ORACLE_COVERAGE * nymphaeums +
-        LARGE_ORACLE_COVERAGE * large_mausoleums +
-        SHRINE_COVERAGE * building_count_active(BUILDING_SHRINE_VENUS) +
-        SMALL_TEMPLE_COVERAGE * building_count_active(BUILDING_SMALL_TEMPLE_VENUS) +
-        LARGE_TEMPLE_COVERAGE * building_count_active(BUILDING_LARGE_TEMPLE_VENUS) +
-        PANTHEON_COVERAGE * building_count_active(BUILDING_PANTHEON) +
-        GRAND_TEMPLE_COVERAGE * building_count_active(BUILDING_GRAND_TEMPLE_VENUS),
-        population));
+        ORACLE_COVERAGE * count_active(BUILDING_SMALL_MAUSOLEUM) +
+        LARGE_ORACLE_COVERAGE * count_active(BUILDING_NYMPHAEUM) +
+        LARGE_ORACLE_COVERAGE * count_active(BUILDING_LARGE_MAUSOLEUM) +
+        PANTHEON_COVERAGE * count_active(BUILDING_PANTHEON);
+    for (god_type god = GOD_CERES; god <= GOD_VENUS; god++) {
+        const building_type *temples = GOD_TEMPLES[god];
+        coverage.religion[god] = top(calc_percentage(
+            shared_religion_coverage +
+            SHRINE_COVERAGE * count_active(temples[0]) +
+            SMALL_TEMPLE_COVERAGE * count_active(temples[1]) +
+            LARGE_TEMPLE_COVERAGE * count_active(temples[2]) +
+            GRAND_TEMPLE_COVERAGE * count_active(temples[3]),
+            population));
+    }
     coverage.oracle = top(calc_percentage(ORACLE_COVERAGE * oracles, population));
 
     city_data.culture.religion_coverage =
@@ -225,41 +440,23 @@ void city_culture_update_coverage(void)
 
     // health
     coverage.hospital = top(calc_percentage(
-        HOSPITAL_COVERAGE * building_count_active(BUILDING_HOSPITAL), population));
+        HOSPITAL_COVERAGE * count_active(BUILDING_HOSPITAL), population));
+}
+
+static int house_average(int total)
+{
+    return counters.houses.count ? total / counters.houses.count : 0;
 }
 
 void city_culture_calculate(void)
 {
-    city_data.culture.average_entertainment = 0;
-    city_data.culture.average_religion = 0;
-    city_data.culture.average_education = 0;
-    city_data.culture.average_health = 0;
-    city_data.culture.average_desirability = 0;
-    city_data.culture.population_with_venus_access = 0; //venus
-
-    int num_houses = 0;
-    for (building_type type = BUILDING_HOUSE_SMALL_TENT; type <= BUILDING_HOUSE_LUXURY_PALACE; type++) {
-        for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
-            if (b->state == BUILDING_STATE_IN_USE && b->house_size) {
-                num_houses++;
-                city_data.culture.average_entertainment += b->data.house.entertainment;
-                city_data.culture.average_religion += b->data.house.num_gods;
-                city_data.culture.average_education += b->data.house.education;
-                city_data.culture.average_health += b->data.house.health;
-                city_data.culture.average_desirability += b->desirability;
-                if (b->data.house.temple_venus) {
-                    city_data.culture.population_with_venus_access += b->house_population;
-                }
-            }
-        }
-    }
-    if (num_houses) {
-        city_data.culture.average_entertainment /= num_houses;
-        city_data.culture.average_religion /= num_houses;
-        city_data.culture.average_education /= num_houses;
-        city_data.culture.average_health /= num_houses;
-        city_data.culture.average_desirability /= num_houses;
-    }
+    ensure_counters();
+    city_data.culture.average_entertainment = house_average(counters.houses.entertainment);
+    city_data.culture.average_religion = house_average(counters.houses.religion);
+    city_data.culture.average_education = house_average(counters.houses.education);
+    city_data.culture.average_health = house_average(counters.houses.health);
+    city_data.culture.average_desirability = house_average(counters.houses.desirability);
+    city_data.culture.population_with_venus_access = counters.houses.venus_population;
 
     city_entertainment_calculate_shows();
     city_festival_calculate_costs();
@@ -267,37 +464,83 @@ void city_culture_calculate(void)
 
 int city_culture_get_theatre_person_coverage(void)
 {
-    return THEATER_COVERAGE * building_count_active(BUILDING_THEATER) + THEATER_UPGRADE_BONUS_COVERAGE * building_count_upgraded(BUILDING_THEATER);;
+    ensure_counters();
+    return THEATER_COVERAGE * count_active(BUILDING_THEATER) +
+        THEATER_UPGRADE_BONUS_COVERAGE * count_upgraded(BUILDING_THEATER);
 }
 
 int city_culture_get_school_person_coverage(void)
 {
-    return SCHOOL_COVERAGE * building_count_active(BUILDING_SCHOOL) + SCHOOL_UPGRADE_BONUS_COVERAGE * building_count_upgraded(BUILDING_SCHOOL);
+    ensure_counters();
+    return SCHOOL_COVERAGE * count_active(BUILDING_SCHOOL) +
+        SCHOOL_UPGRADE_BONUS_COVERAGE * count_upgraded(BUILDING_SCHOOL);
 }
 
 int city_culture_get_library_person_coverage(void)
 {
-    return LIBRARY_COVERAGE * building_count_active(BUILDING_LIBRARY) + LIBRARY_UPGRADE_BONUS_COVERAGE * building_count_upgraded(BUILDING_LIBRARY);;
+    ensure_counters();
+    return LIBRARY_COVERAGE * count_active(BUILDING_LIBRARY) +
+        LIBRARY_UPGRADE_BONUS_COVERAGE * count_upgraded(BUILDING_LIBRARY);
 }
 
 int city_culture_get_academy_person_coverage(void)
 {
-    return ACADEMY_COVERAGE * building_count_active(BUILDING_ACADEMY) + ACADEMY_UPGRADE_BONUS_COVERAGE * building_count_upgraded(BUILDING_ACADEMY);
+    ensure_counters();
+    return ACADEMY_COVERAGE * count_active(BUILDING_ACADEMY) +
+        ACADEMY_UPGRADE_BONUS_COVERAGE * count_upgraded(BUILDING_ACADEMY);
 }
 
 int city_culture_get_tavern_person_coverage(void)
 {
-    return TAVERN_COVERAGE * building_count_active(BUILDING_TAVERN) + TAVERN_UPGRADE_BONUS_COVERAGE * building_count_upgraded(BUILDING_TAVERN);
+    ensure_counters();
+    return TAVERN_COVERAGE * count_active(BUILDING_TAVERN) +
+        TAVERN_UPGRADE_BONUS_COVERAGE * count_upgraded(BUILDING_TAVERN);
 }
 
 int city_culture_get_ampitheatre_person_coverage(void)
 {
-    return AMPHITHEATER_COVERAGE * building_count_active(BUILDING_AMPHITHEATER) + AMPHITHEATER_UPGRADE_BONUS_COVERAGE * building_count_upgraded(BUILDING_AMPHITHEATER);
+    ensure_counters();
+    return AMPHITHEATER_COVERAGE * count_active(BUILDING_AMPHITHEATER) +
+        AMPHITHEATER_UPGRADE_BONUS_COVERAGE * count_upgraded(BUILDING_AMPHITHEATER);
 }
 
 int city_culture_get_arena_person_coverage(void)
 {
-    return ARENA_COVERAGE * building_count_active(BUILDING_ARENA) + ARENA_UPGRADE_BONUS_COVERAGE * building_count_upgraded(BUILDING_ARENA);
+    ensure_counters();
+    return ARENA_COVERAGE * count_active(BUILDING_ARENA) +
+        ARENA_UPGRADE_BONUS_COVERAGE * count_upgraded(BUILDING_ARENA);
+}
+
+static void snapshot_venue(city_culture_venue *venue, building_type type, int people_covered, int people)
+{
+    venue->total = count_total(type);
+    venue->active = count_active(type);
+    venue->shows = counters.venues[type].shows;
+    venue->people_covered = people_covered;
+    venue->coverage = top(calc_percentage(people_covered, people));
+}
+
+const city_culture_snapshot *city_culture_get_snapshot(void)
+{
+    ensure_counters();
+    int population = city_data.population.population;
+    snapshot_venue(&snapshot.tavern, BUILDING_TAVERN, city_culture_get_tavern_person_coverage(), population);
+    snapshot_venue(&snapshot.theater, BUILDING_THEATER, city_culture_get_theatre_person_coverage(), population);
+    snapshot_venue(&snapshot.amphitheater, BUILDING_AMPHITHEATER,
+        city_culture_get_ampitheatre_person_coverage(), population);
+    snapshot_venue(&snapshot.arena, BUILDING_ARENA, city_culture_get_arena_person_coverage(), population);
+    snapshot_venue(&snapshot.school, BUILDING_SCHOOL,
+        city_culture_get_school_person_coverage(), city_population_school_age());
+    snapshot_venue(&snapshot.library, BUILDING_LIBRARY, city_culture_get_library_person_coverage(), population);
+    snapshot_venue(&snapshot.academy, BUILDING_ACADEMY,
+        city_culture_get_academy_person_coverage(), city_population_academy_age());
+    snapshot_venue(&snapshot.hospital, BUILDING_HOSPITAL,
+        HOSPITAL_COVERAGE * count_active(BUILDING_HOSPITAL), population);
+    snapshot.average_entertainment = house_average(counters.houses.entertainment);
+    snapshot.average_religion = house_average(counters.houses.religion);
+    snapshot.average_education = house_average(counters.houses.education);
+    snapshot.average_health = house_average(counters.houses.health);
+    return &snapshot;
 }
 
 
@@ -1,6 +1,7 @@
 #ifndef CITY_CULTURE_H
 #define CITY_CULTURE_H
 
+#include "building/building.h"
 #include "city/constants.h"
 #include "core/buffer.h"
 
@@ -20,6 +21,51 @@
 #define ACADEMY_UPGRADE_BONUS_COVERAGE 50
 #define HOSPITAL_COVERAGE 1500
 
+typedef struct {
+    int total;
+    int active;
+    int shows;
+    int people_covered;
+    int coverage;
+} city_culture_venue;
+
+typedef struct {
+    city_culture_venue tavern;
+    city_culture_venue theater;
+    city_culture_venue amphitheater;
+    city_culture_venue arena;
+    city_culture_venue school;
+    city_culture_venue library;
+    city_culture_venue academy;
+    city_culture_venue hospital;
+    int average_entertainment;
+    int average_religion;
+    int average_education;
+    int average_health;
+} city_culture_snapshot;
+
+/**
+ * Updates the culture counters after a building changed.
+ * Must be called whenever the state, type, workers, upgrade or shows of a building change,
+ * and for houses also their size, population, desirability or services.
+ * @param b The building
+ */
+void city_culture_update_building(building *b);
+
+/**
+ * Rebuilds the culture counters on the next use, must be called when the buildings are reloaded
+ */
+void city_culture_reset_counters(void);
+
+/**
+ * Gets the current culture values without changing the city, cheap enough to be called every frame
+ * @return The venues, their coverage and the house averages as they are right now
+ */
+const city_culture_snapshot *city_culture_get_snapshot(void);
+
+int city_culture_venue_shows(building_type type);
+int city_culture_venue_no_shows_weighted(building_type type);
+
 void city_culture_update_coverage(void);
 
 int city_culture_coverage_tavern(void);
@@ -1,6 +1,6 @@
 #include "entertainment.h"
 
-#include "building/building.h"
+#include "city/culture.h"
 #include "city/data_private.h"
 
 int city_entertainment_theater_shows(void)
@@ -45,85 +45,20 @@ int city_entertainment_venue_needing_shows(void)
 
 void city_entertainment_calculate_shows(void)
 {
-    city_data.entertainment.theater_shows = 0;
-    city_data.entertainment.theater_no_shows_weighted = 0;
-    city_data.entertainment.amphitheater_shows = 0;
-    city_data.entertainment.amphitheater_no_shows_weighted = 0;
-    city_data.entertainment.arena_shows = 0;
-    city_data.entertainment.arena_no_shows_weighted = 0;
-    city_data.entertainment.colosseum_shows = 0;
-    city_data.entertainment.colosseum_no_shows_weighted = 0;
-    city_data.entertainment.hippodrome_shows = 0;
-    city_data.entertainment.hippodrome_no_shows_weighted = 0;
+    city_data.entertainment.theater_shows = city_culture_venue_shows(BUILDING_THEATER);
+    city_data.entertainment.theater_no_shows_weighted = city_culture_venue_no_shows_weighted(BUILDING_THEATER);
+    city_data.entertainment.amphitheater_shows = city_culture_venue_shows(BUILDING_AMPHITHEATER);
+    city_data.entertainment.amphitheater_no_shows_weighted =
+        city_culture_venue_no_shows_weighted(BUILDING_AMPHITHEATER);
+    city_data.entertainment.arena_shows = city_culture_venue_shows(BUILDING_ARENA);
+    city_data.entertainment.arena_no_shows_weighted = city_culture_venue_no_shows_weighted(BUILDING_ARENA);
+    city_data.entertainment.colosseum_shows = city_culture_venue_shows(BUILDING_COLOSSEUM);
+    city_data.entertainment.colosseum_no_shows_weighted = city_culture_venue_no_shows_weighted(BUILDING_COLOSSEUM);
+    city_data.entertainment.hippodrome_shows = city_culture_venue_shows(BUILDING_HIPPODROME);
+    city_data.entertainment.hippodrome_no_shows_weighted =
+        city_culture_venue_no_shows_weighted(BUILDING_HIPPODROME);
     city_data.entertainment.venue_needing_shows = 0;
 
-    for (building *b = building_first_of_type(BUILDING_THEATER); b; b = b->next_of_type) {
-        if (b->state != BUILDING_STATE_IN_USE) {
-            continue;
-        }
-        if (b->data.entertainment.days1) {
-            city_data.entertainment.theater_shows++;
-        } else {
-            city_data.entertainment.theater_no_shows_weighted++;
-        }
-    }
-    for (building *b = building_first_of_type(BUILDING_AMPHITHEATER); b; b = b->next_of_type) {
-        if (b->state != BUILDING_STATE_IN_USE) {
-            continue;
-        }
-        if (b->data.entertainment.days1) {
-            city_data.entertainment.amphitheater_shows++;
-        } else {
-            city_data.entertainment.amphitheater_no_shows_weighted += 2;
-        }
-        if (b->data.entertainment.days2) {
-            city_data.entertainment.amphitheater_shows++;
-        } else {
-            city_data.entertainment.amphitheater_no_shows_weighted += 2;
-        }
-    }
-    for (building *b = building_first_of_type(BUILDING_ARENA); b; b = b->next_of_type) {
-        if (b->state != BUILDING_STATE_IN_USE) {
-            continue;
-        }
-        if (b->data.entertainment.days1) {
-            city_data.entertainment.arena_shows++;
-        } else {
-            city_data.entertainment.arena_no_shows_weighted += 3;
-        }
-        if (b->data.entertainment.days2) {
-            city_data.entertainment.arena_shows++;
-        } else {
-            city_data.entertainment.arena_no_shows_weighted += 3;
-        }
-    }
-
-    for (building *b = building_first_of_type(BUILDING_COLOSSEUM); b; b = b->next_of_type) {
-        if (b->state != BUILDING_STATE_IN_USE) {
-            continue;
-        }
-        if (b->data.entertainment.days1) {
-            city_data.entertainment.colosseum_shows++;
-        } else {
-            city_data.entertainment.colosseum_no_shows_weighted += 3;
-        }
-        if (b->data.entertainment.days2) {
-            city_data.entertainment.colosseum_shows++;
-        } else {
-            city_data.entertainment.colosseum_no_shows_weighted += 3;
-        }
-    }
-
-    for (building *b = building_first_of_type(BUILDING_HIPPODROME); b; b = b->next_of_type) {
-        if (b->state != BUILDING_STATE_IN_USE) {
-            continue;
-        }
-        if (b->data.entertainment.days1) {
-            city_data.entertainment.hippodrome_shows++;
-        } else {
-            city_data.entertainment.hippodrome_no_shows_weighted += 100;
-        }
-    }
     int worst_shows = 0;
     if (city_data.entertainment.theater_no_shows_weighted > worst_shows) {
         worst_shows = city_data.entertainment.theater_no_shows_weighted;
@@ -138,6 +138,7 @@ static int cause_disease(void)
                         }
                         if (killed_people < b->house_population) {
                             b->house_population -= killed_people;
+                            city_culture_update_building(b);
                         } else {
                             building_house_change_to_vacant_lot(b);
                         }
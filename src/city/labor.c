@@ -4,16 +4,20 @@
 #include "building/monument.h"
 #include "building/properties.h"
 #include "core/config.h"
+#include "city/culture.h"
 #include "city/data_private.h"
 #include "city/gods.h"
 #include "city/message.h"
 #include "city/population.h"
 #include "core/calc.h"
 #include "core/random.h"
+#include "game/replay.h"
 #include "game/time.h"
 #include "scenario/data.h"
 #include "scenario/property.h"
 
+#include <stdint.h>
+
 typedef enum {
     LABOR_CATEGORY_NONE = 0,
     LABOR_CATEGORY_INDUSTRY_COMMERCE,
@@ -141,6 +145,16 @@ static struct {
     {LABOR_CATEGORY_GOVERNANCE_RELIGION, 1},
 };
 
+static struct {
+    int start_water_building_id;
+    struct {
+        int has_expected_workers;
+        int has_no_workers;
+        int min_houses_covered;
+        int up_to_date;
+    } categories[LABOR_CATEGORY_MAX];
+} data = { 1 };
+
 int city_labor_unemployment_percentage(void)
 {
     return city_data.labor.unemployment_percentage;
@@ -173,6 +187,7 @@ int city_labor_wages(void)
 
 void city_labor_change_wages(int amount)
 {
+    game_replay_record_action(REPLAY_ACTION_WAGES_CHANGE, amount, 0, 0);
     city_data.labor.wages += amount;
     city_data.labor.wages = calc_bound(city_data.labor.wages, 0, 100);
 }
@@ -269,6 +284,30 @@ static int should_have_workers(building *b, int category, int check_access)
     return 1;
 }
 
+static void check_workers_for_full_staffing(building *b, int category)
+{
+    // When a category is fully staffed, every building gets either all of its workers or none
+    int expected_workers;
+    if (category == LABOR_CATEGORY_WATER) {
+        expected_workers = building_get_laborers(b->type);
+    } else if (b->type == BUILDING_LATRINES) {
+        expected_workers = model_get_building(b->type)->laborers;
+    } else if (b->houses_covered > 0 && should_have_workers(b, category, 0)) {
+        expected_workers = model_get_building(b->type)->laborers;
+        if (b->houses_covered < data.categories[category - 1].min_houses_covered) {
+            data.categories[category - 1].min_houses_covered = b->houses_covered;
+        }
+    } else {
+        expected_workers = 0;
+    }
+    if (b->num_workers != expected_workers) {
+        data.categories[category - 1].has_expected_workers = 0;
+    }
+    if (b->num_workers) {
+        data.categories[category - 1].has_no_workers = 0;
+    }
+}
+
 static void calculate_workers_needed_per_category(void)
 {
     for (int cat = 0; cat < LABOR_CATEGORY_MAX; cat++) {
@@ -276,14 +315,21 @@ static void calculate_workers_needed_per_category(void)
         city_data.labor.categories[cat].total_houses_covered = 0;
         city_data.labor.categories[cat].workers_allocated = 0;
         city_data.labor.categories[cat].workers_needed = 0;
+        data.categories[cat].has_expected_workers = 1;
+        data.categories[cat].has_no_workers = 1;
+        data.categories[cat].min_houses_covered = 0x7fffffff;
     }
+    const building_hot_data *hot = building_get_hot_data();
     for (int i = 1; i < building_count(); i++) {
-        building *b = building_get(i);
-        if (b->state != BUILDING_STATE_IN_USE) {
+        if (hot[i].state != BUILDING_STATE_IN_USE) {
             continue;
         }
+        building *b = building_get(i);
         int category = CATEGORY_FOR_BUILDING_TYPE[b->type];
         b->labor_category = category - 1;
+        if (category != LABOR_CATEGORY_NONE) {
+            check_workers_for_full_staffing(b, category);
+        }
         if (!should_have_workers(b, category, 1)) {
             continue;
         }
@@ -390,12 +436,38 @@ static void check_employment(void)
     }
 }
 
+static void find_up_to_date_categories(void)
+{
+    for (int i = 0; i < LABOR_CATEGORY_MAX; i++) {
+        const labor_category_data *category = &city_data.labor.categories[i];
+        if (i == LABOR_CATEGORY_WATER - 1) {
+            if (!category->workers_needed || category->workers_allocated != category->workers_needed) {
+                data.categories[i].up_to_date = 0;
+            } else if (calc_percentage(100, category->buildings) > 0) {
+                data.categories[i].up_to_date = data.categories[i].has_expected_workers;
+            } else {
+                data.categories[i].up_to_date = data.categories[i].has_no_workers;
+            }
+        } else {
+            // Buildings with very little coverage get no workers at all in large categories
+            data.categories[i].up_to_date = data.categories[i].has_expected_workers &&
+                category->workers_allocated >= category->workers_needed &&
+                category->total_houses_covered <= 10000 * (int64_t) data.categories[i].min_houses_covered;
+        }
+    }
+}
+
+static int category_is_up_to_date(int category)
+{
+    return data.categories[category - 1].up_to_date;
+}
+
 static void set_building_worker_weight(void)
 {
     int water_per_10k_per_building = calc_percentage(100, city_data.labor.categories[LABOR_CATEGORY_WATER - 1].buildings);
     for (building_type type = 0; type < BUILDING_TYPE_MAX; type++) {
         int cat = CATEGORY_FOR_BUILDING_TYPE[type];
-        if (cat == LABOR_CATEGORY_NONE) {
+        if (cat == LABOR_CATEGORY_NONE || category_is_up_to_date(cat)) {
             continue;
         }
         for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
@@ -419,7 +491,10 @@ static void set_building_worker_weight(void)
 
 static void allocate_workers_to_water(void)
 {
-    static int start_building_id = 1;
+    if (category_is_up_to_date(LABOR_CATEGORY_WATER)) {
+        data.start_water_building_id = 1;
+        return;
+    }
     labor_category_data *water_cat = &city_data.labor.categories[LABOR_CATEGORY_WATER - 1];
 
     int percentage_not_filled = 100 - calc_percentage(water_cat->workers_allocated, water_cat->workers_needed);
@@ -432,8 +507,8 @@ static void allocate_workers_to_water(void)
     } else {
         workers_per_building = water_cat->workers_allocated / (water_cat->buildings - buildings_to_skip);
     }
-    int building_id = start_building_id;
-    start_building_id = 0;
+    int building_id = data.start_water_building_id;
+    data.start_water_building_id = 0;
     for (int guard = 1; guard < building_count(); guard++, building_id++) {
         if (building_id >= building_count()) {
             building_id = 1;
@@ -447,10 +522,10 @@ static void allocate_workers_to_water(void)
             if (percentage_not_filled > 0) {
                 if (buildings_to_skip) {
                     --buildings_to_skip;
-                } else if (start_building_id) {
+                } else if (data.start_water_building_id) {
                     b->num_workers = workers_per_building;
                 } else {
-                    start_building_id = building_id;
+                    data.start_water_building_id = building_id;
                     b->num_workers = workers_per_building;
                 }
             } else {
@@ -458,9 +533,9 @@ static void allocate_workers_to_water(void)
             }
         }
     }
-    if (!start_building_id) {
+    if (!data.start_water_building_id) {
         // no buildings assigned or full employment
-        start_building_id = 1;
+        data.start_water_building_id = 1;
     }
 }
 
@@ -480,12 +555,16 @@ static void allocate_workers_to_non_water_buildings(void)
             // water is handled by allocate_workers_to_water(void)
             continue;
         }
+        if (category_is_up_to_date(cat)) {
+            continue;
+        }
         for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
             if (b->state != BUILDING_STATE_IN_USE) {
                 continue;
             }
             b->num_workers = 0;
             if (b->type != BUILDING_LATRINES && (!should_have_workers(b, cat, 0) || b->percentage_houses_covered <= 0)) {
+                city_culture_update_building(b);
                 continue;
             }
             
@@ -502,6 +581,7 @@ static void allocate_workers_to_non_water_buildings(void)
             } else {
                 b->num_workers = required_workers;
             }
+            city_culture_update_building(b);
         }
     }
     for (int i = 0; i < LABOR_CATEGORY_MAX; i++) {
@@ -518,7 +598,8 @@ static void allocate_workers_to_non_water_buildings(void)
     }
     for (building_type type = 0; type < BUILDING_TYPE_MAX; type++) {
         int cat = CATEGORY_FOR_BUILDING_TYPE[type];
-        if (cat == LABOR_CATEGORY_NONE || cat == LABOR_CATEGORY_WATER || cat == LABOR_CATEGORY_MILITARY) {
+        if (cat == LABOR_CATEGORY_NONE || cat == LABOR_CATEGORY_WATER || cat == LABOR_CATEGORY_MILITARY ||
+            category_is_up_to_date(cat)) {
             continue;
         }
         for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
@@ -539,6 +620,7 @@ static void allocate_workers_to_non_water_buildings(void)
                         b->num_workers += needed;
                         category_workers_needed[cat - 1] -= needed;
                     }
+                    city_culture_update_building(b);
                 }
             }
         }
@@ -554,6 +636,9 @@ static void allocate_workers_to_buildings(void)
 
 void city_labor_allocate_workers(void)
 {
+    for (int i = 0; i < LABOR_CATEGORY_MAX; i++) {
+        data.categories[i].up_to_date = 0;
+    }
     allocate_workers_to_categories();
     allocate_workers_to_buildings();
 }
@@ -562,6 +647,7 @@ void city_labor_update(void)
 {
     calculate_workers_needed_per_category();
     check_employment();
+    find_up_to_date_categories();
     allocate_workers_to_buildings();
 }
 
@@ -571,6 +657,7 @@ void city_labor_set_priority(int category, int new_priority)
     if (old_priority == new_priority) {
         return;
     }
+    game_replay_record_action(REPLAY_ACTION_LABOR_PRIORITY, category, new_priority, 0);
     int shift;
     int from_prio;
     int to_prio;
@@ -113,7 +113,7 @@ int city_trade_next_docker_export_resource(void)
 int trade_caravan_count(void)
 {
     int count = 0;
-    for (int i = 1; i < figure_count(); i++) {
+    for (unsigned int i = figure_next_live_id(0); i; i = figure_next_live_id(i)) {
         figure *f = figure_get(i);
         if (f->type == FIGURE_TRADE_CARAVAN || f->type == FIGURE_TRADE_CARAVAN_DONKEY || f->type == FIGURE_NATIVE_TRADER) {
             count++;
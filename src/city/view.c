@@ -16,6 +16,9 @@
 #define HALF_TILE_WIDTH_PIXELS 30
 #define HALF_TILE_HEIGHT_PIXELS 15
 
+#define VIEW_X_MAX_SIZE (GRID_SIZE_MAX + 3)
+#define VIEW_Y_MAX_SIZE (2 * GRID_SIZE_MAX + 1)
+
 static const int X_DIRECTION_FOR_ORIENTATION[] = {1,  1, -1, -1};
 static const int Y_DIRECTION_FOR_ORIENTATION[] = {1, -1, -1,  1};
 
@@ -41,9 +44,13 @@ static struct {
         int x_pixels;
         int y_pixels;
     } selected_tile;
-} data;
+    struct {
+        int x_max;
+        int y_max;
+    } lookup;
+} data = { .lookup = { GRID_SIZE_LEGACY + 3, 2 * GRID_SIZE_LEGACY + 1 } };
 
-static int view_to_grid_offset_lookup[VIEW_X_MAX][VIEW_Y_MAX];
+static int view_to_grid_offset_lookup[VIEW_X_MAX_SIZE][VIEW_Y_MAX_SIZE];
 
 static void check_camera_boundaries(void)
 {
@@ -53,8 +60,8 @@ static void check_camera_boundaries(void)
         return;
     }
     int grid_height = map_grid_height() * 2;
-    int x_min = (VIEW_X_MAX - map_grid_width()) / 2;
-    int y_min = (VIEW_Y_MAX - grid_height) / 2;
+    int x_min = (data.lookup.x_max - map_grid_width()) / 2;
+    int y_min = (data.lookup.y_max - grid_height) / 2;
     if (data.viewport.width_tiles >= map_grid_width() + 4) {
         data.camera.tile.x = x_min - 1 - (data.viewport.width_tiles - map_grid_width()) / 2;
         data.camera.pixel.x = TILE_WIDTH_PIXELS -
@@ -64,7 +71,7 @@ static void check_camera_boundaries(void)
             data.camera.tile.x = x_min - 1;
             data.camera.pixel.x = 0;
         }
-        int max_x_tile = VIEW_X_MAX - x_min - data.viewport.width_tiles;
+        int max_x_tile = data.lookup.x_max - x_min - data.viewport.width_tiles;
         int max_x_pixel = TILE_WIDTH_PIXELS -
             (calc_adjust_with_percentage(data.viewport.width_pixels + 2, data.scale) % TILE_WIDTH_PIXELS);
         if (data.camera.tile.x > max_x_tile || (data.camera.tile.x == max_x_tile && data.camera.pixel.x > max_x_pixel)) {
@@ -82,7 +89,7 @@ static void check_camera_boundaries(void)
             data.camera.tile.y = y_min - 1;
             data.camera.pixel.y = 0;
         }
-        int max_y_tile = (VIEW_Y_MAX - y_min - data.viewport.height_tiles) & ~1;
+        int max_y_tile = (data.lookup.y_max - y_min - data.viewport.height_tiles) & ~1;
         int max_y_pixel = TILE_HEIGHT_PIXELS -
                 (calc_adjust_with_percentage(data.viewport.height_pixels, data.scale) % TILE_HEIGHT_PIXELS);
         if (data.camera.tile.y > max_y_tile || (data.camera.tile.y == max_y_tile && data.camera.pixel.y > max_y_pixel)) {
@@ -93,10 +100,12 @@ static void check_camera_boundaries(void)
     data.camera.tile.y &= ~1;
 }
 
-static void reset_lookup(void)
+static void reset_lookup(int grid_size)
 {
-    for (int y = 0; y < VIEW_Y_MAX; y++) {
-        for (int x = 0; x < VIEW_X_MAX; x++) {
+    data.lookup.x_max = grid_size + 3;
+    data.lookup.y_max = 2 * grid_size + 1;
+    for (int y = 0; y < data.lookup.y_max; y++) {
+        for (int x = 0; x < data.lookup.x_max; x++) {
             view_to_grid_offset_lookup[x][y] = -1;
         }
     }
@@ -104,7 +113,8 @@ static void reset_lookup(void)
 
 static void calculate_lookup(void)
 {
-    reset_lookup();
+    int grid_size = map_grid_stride();
+    reset_lookup(grid_size);
     int y_view_start;
     int y_view_skip;
     int y_view_step;
@@ -114,7 +124,7 @@ static void calculate_lookup(void)
     switch (data.orientation) {
         default:
         case DIR_0_TOP:
-            x_view_start = VIEW_X_MAX - 1;
+            x_view_start = data.lookup.x_max - 1;
             x_view_skip = -1;
             x_view_step = 1;
             y_view_start = 1;
@@ -125,33 +135,33 @@ static void calculate_lookup(void)
             x_view_start = 3;
             x_view_skip = 1;
             x_view_step = 1;
-            y_view_start = VIEW_X_MAX - 3;
+            y_view_start = data.lookup.x_max - 3;
             y_view_skip = 1;
             y_view_step = -1;
             break;
         case DIR_4_BOTTOM:
-            x_view_start = VIEW_X_MAX - 1;
+            x_view_start = data.lookup.x_max - 1;
             x_view_skip = 1;
             x_view_step = -1;
-            y_view_start = VIEW_Y_MAX - 2;
+            y_view_start = data.lookup.y_max - 2;
             y_view_skip = -1;
             y_view_step = -1;
             break;
         case DIR_6_LEFT:
-            x_view_start = VIEW_Y_MAX;
+            x_view_start = data.lookup.y_max;
             x_view_skip = -1;
             x_view_step = -1;
-            y_view_start = VIEW_X_MAX - 3;
+            y_view_start = data.lookup.x_max - 3;
             y_view_skip = -1;
             y_view_step = 1;
             break;
     }
 
-    for (int y = 0; y < GRID_SIZE; y++) {
+    for (int y = 0; y < grid_size; y++) {
         int x_view = x_view_start;
         int y_view = y_view_start;
-        for (int x = 0; x < GRID_SIZE; x++) {
-            int grid_offset = x + GRID_SIZE * y;
+        for (int x = 0; x < grid_size; x++) {
+            int grid_offset = x + grid_size * y;
             if (map_image_at(grid_offset) < 6) {
                 view_to_grid_offset_lookup[x_view/2][y_view] = -1;
             } else {
@@ -167,21 +177,25 @@ static void calculate_lookup(void)
 
 void city_view_set_custom_lookup(int start_offset, int width, int height, int border_size)
 {
-    reset_lookup();
+    int grid_size = width + border_size;
+    if (grid_size <= 0 || grid_size > GRID_SIZE_MAX) {
+        grid_size = GRID_SIZE_LEGACY;
+    }
+    reset_lookup(grid_size);
 
     int start_x = border_size / 2;
-    int end_x = GRID_SIZE - start_x;
-    int start_y = (start_offset - start_x) / GRID_SIZE;
+    int end_x = grid_size - start_x;
+    int start_y = (start_offset - start_x) / grid_size;
     int end_y = start_y + height;
 
-    int x_view_start = VIEW_X_MAX - 1 - start_y;
+    int x_view_start = data.lookup.x_max - 1 - start_y;
     int y_view_start = 1 + start_y;
 
     for (int y = start_y; y < end_y; y++) {
         int x_view = x_view_start + start_x;
         int y_view = y_view_start + start_x;
         for (int x = start_x; x < end_x; x++) {
-            view_to_grid_offset_lookup[x_view / 2][y_view] = x + GRID_SIZE * y;
+            view_to_grid_offset_lookup[x_view / 2][y_view] = x + grid_size * y;
             x_view++;
             y_view++;
         }
@@ -278,14 +292,14 @@ static void adjust_for_orientation(int x, int y, int orientation, int *x_out, in
             break;
         case DIR_2_RIGHT:
             *x_out = y / 2;
-            *y_out = (VIEW_X_MAX - x) * 2;
+            *y_out = (data.lookup.x_max - x) * 2;
             break;
         case DIR_4_BOTTOM:
-            *x_out = VIEW_X_MAX - x;
-            *y_out = VIEW_Y_MAX - y;
+            *x_out = data.lookup.x_max - x;
+            *y_out = data.lookup.y_max - y;
             break;
         case DIR_6_LEFT:
-            *x_out = (VIEW_Y_MAX - y) / 2;
+            *x_out = (data.lookup.y_max - y) / 2;
             *y_out = x * 2;
             break;
     }
@@ -456,8 +470,8 @@ void city_view_scroll(int x, int y)
 void city_view_grid_offset_to_xy_view(int grid_offset, int *x_view, int *y_view)
 {
     *x_view = *y_view = 0;
-    for (int y = 0; y < VIEW_Y_MAX; y++) {
-        for (int x = 0; x < VIEW_X_MAX; x++) {
+    for (int y = 0; y < data.lookup.y_max; y++) {
+        for (int x = 0; x < data.lookup.x_max; x++) {
             if (view_to_grid_offset_lookup[x][y] == grid_offset) {
                 *x_view = x;
                 *y_view = y;
@@ -511,7 +525,7 @@ int city_view_pixels_to_view_tile(int x_pixels, int y_pixels, view_tile *tile)
     }
     tile->x = data.camera.tile.x + x_view_offset;
     tile->y = data.camera.tile.y + y_view_offset;
-    return tile->x >= 0 && tile->x < VIEW_X_MAX && tile->y >= 0 && tile->y < VIEW_Y_MAX;
+    return tile->x >= 0 && tile->x < data.lookup.x_max && tile->y >= 0 && tile->y < data.lookup.y_max;
 }
 
 void city_view_set_selected_view_tile(const view_tile *tile)
@@ -639,6 +653,12 @@ void city_view_get_viewport_size_tiles(int *width, int *height)
     *height = data.viewport.height_tiles;
 }
 
+void city_view_get_view_size_tiles(int *width, int *height)
+{
+    *width = data.lookup.x_max;
+    *height = data.lookup.y_max;
+}
+
 int city_view_is_sidebar_collapsed(void)
 {
     return data.sidebar_collapsed;
@@ -701,7 +721,7 @@ void city_view_foreach_valid_map_tile(map_callback *callback)
     int y_view = data.camera.tile.y - 8;
     int y_graphic = data.viewport.y - 9 * HALF_TILE_HEIGHT_PIXELS - data.camera.pixel.y;
     for (int y = 0; y < data.viewport.height_tiles + 21; y++) {
-        if (y_view >= 0 && y_view < VIEW_Y_MAX) {
+        if (y_view >= 0 && y_view < data.lookup.y_max) {
             int x_graphic = -(6 * TILE_WIDTH_PIXELS) - data.camera.pixel.x;
             if (odd) {
                 x_graphic += data.viewport.x - HALF_TILE_WIDTH_PIXELS;
@@ -710,7 +730,7 @@ void city_view_foreach_valid_map_tile(map_callback *callback)
             }
             int x_view = data.camera.tile.x - 6;
             for (int x = 0; x < data.viewport.width_tiles + 9; x++) {
-                if (x_view >= 0 && x_view < VIEW_X_MAX) {
+                if (x_view >= 0 && x_view < data.lookup.x_max) {
                     int grid_offset = view_to_grid_offset_lookup[x_view][y_view];
                     if (grid_offset >= 0) {
                         callback(x_graphic, y_graphic, grid_offset);
@@ -733,7 +753,7 @@ void city_view_foreach_valid_map_tile_row(map_callback *callback1, map_callback
     int y_graphic = data.viewport.y - 9 * HALF_TILE_HEIGHT_PIXELS - data.camera.pixel.y;
     int x_graphic, x_view;
     for (int y = 0; y < data.viewport.height_tiles + 21; y++) {
-        if (y_view >= 0 && y_view < VIEW_Y_MAX) {
+        if (y_view >= 0 && y_view < data.lookup.y_max) {
             if (callback1) {
                 x_graphic = -(6 * TILE_WIDTH_PIXELS) - data.camera.pixel.x;
                 if (odd) {
@@ -743,7 +763,7 @@ void city_view_foreach_valid_map_tile_row(map_callback *callback1, map_callback
                 }
                 x_view = data.camera.tile.x - 6;
                 for (int x = 0; x < data.viewport.width_tiles + 9; x++) {
-                    if (x_view >= 0 && x_view < VIEW_X_MAX) {
+                    if (x_view >= 0 && x_view < data.lookup.x_max) {
                         int grid_offset = view_to_grid_offset_lookup[x_view][y_view];
                         if (grid_offset >= 0) {
                             callback1(x_graphic, y_graphic, grid_offset);
@@ -762,7 +782,7 @@ void city_view_foreach_valid_map_tile_row(map_callback *callback1, map_callback
                 }
                 x_view = data.camera.tile.x - 6;
                 for (int x = 0; x < data.viewport.width_tiles + 9; x++) {
-                    if (x_view >= 0 && x_view < VIEW_X_MAX) {
+                    if (x_view >= 0 && x_view < data.lookup.x_max) {
                         int grid_offset = view_to_grid_offset_lookup[x_view][y_view];
                         if (grid_offset >= 0) {
                             callback2(x_graphic, y_graphic, grid_offset);
@@ -781,7 +801,7 @@ void city_view_foreach_valid_map_tile_row(map_callback *callback1, map_callback
                 }
                 x_view = data.camera.tile.x - 6;
                 for (int x = 0; x < data.viewport.width_tiles + 9; x++) {
-                    if (x_view >= 0 && x_view < VIEW_X_MAX) {
+                    if (x_view >= 0 && x_view < data.lookup.x_max) {
                         int grid_offset = view_to_grid_offset_lookup[x_view][y_view];
                         if (grid_offset >= 0) {
                             callback3(x_graphic, y_graphic, grid_offset);
@@ -901,7 +921,7 @@ void city_view_foreach_minimap_tile(
         }
         int x_abs = absolute_x - 4;
         for (int x_rel = -4; x_rel < width_tiles; x_rel++, x_abs++, x_view += 2) {
-            if (x_abs >= 0 && x_abs < VIEW_X_MAX && y_abs >= 0 && y_abs < VIEW_Y_MAX) {
+            if (x_abs >= 0 && x_abs < data.lookup.x_max && y_abs >= 0 && y_abs < data.lookup.y_max) {
                 callback(x_view, y_view, view_to_grid_offset_lookup[x_abs][y_abs]);
             }
         }
@@ -3,10 +3,6 @@
 
 #include "core/buffer.h"
 
-// TODO get rid of these
-#define VIEW_X_MAX 165
-#define VIEW_Y_MAX 325
-
 typedef struct {
     int x;
     int y;
@@ -68,6 +64,7 @@ void city_view_set_viewport(int screen_width, int screen_height);
 
 void city_view_get_viewport(int *x, int *y, int *width, int *height);
 void city_view_get_viewport_size_tiles(int *width, int *height);
+void city_view_get_view_size_tiles(int *width, int *height);
 
 int city_view_is_sidebar_collapsed(void);
 
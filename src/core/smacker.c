@@ -30,6 +30,10 @@
 // #define BLOCK_VOID 2 - not supported
 #define BLOCK_SOLID 3
 
+// Number of bits that are decoded at once when looking up a huffman code
+#define LOOKUP_BITS 8
+#define LOOKUP_SIZE (1 << LOOKUP_BITS)
+
 typedef struct {
     const uint8_t *data;
     size_t length;
@@ -46,6 +50,10 @@ typedef struct huffnode8_t {
 typedef struct hufftree8_t {
     huffnode8 nodes[512];
     int size;
+    struct {
+        huffnode8 *node;
+        uint8_t bits;
+    } lookup[LOOKUP_SIZE];
 } hufftree8;
 
 typedef struct huffnode16_t {
@@ -60,6 +68,10 @@ typedef struct hufftree16_t {
     hufftree8 *high;
     uint16_t escape_codes[3];
     huffnode16 *escape_nodes[3];
+    struct {
+        huffnode16 *node;
+        uint8_t bits;
+    } lookup[LOOKUP_SIZE];
 } hufftree16;
 
 typedef struct {
@@ -167,6 +179,29 @@ static inline int read_bit(bitstream *bs)
     return result ? 1 : 0;
 }
 
+// Returns the next LOOKUP_BITS bits without consuming them, with bits past the end of the stream being 0
+static inline unsigned int peek_bits(const bitstream *bs)
+{
+    if (bs->index >= bs->length) {
+        return 0;
+    }
+    unsigned int value = bs->data[bs->index];
+    if (bs->index + 1 < bs->length) {
+        value |= bs->data[bs->index + 1] << 8;
+    }
+    return (value >> bs->bit_index) & (LOOKUP_SIZE - 1);
+}
+
+static inline void skip_bits(bitstream *bs, int bits)
+{
+    if (bs->index >= bs->length) {
+        return;
+    }
+    int total = bs->bit_index + bits;
+    bs->index += total >> 3;
+    bs->bit_index = total & 7;
+}
+
 static inline uint8_t read_byte(bitstream *bs)
 {
     if (bs->bit_index == 0) {
@@ -202,6 +237,20 @@ static huffnode8 *build_tree8_nodes(bitstream *bs, hufftree8 *tree)
     return node;
 }
 
+static void build_tree8_lookup(hufftree8 *tree)
+{
+    for (unsigned int code = 0; code < LOOKUP_SIZE; code++) {
+        huffnode8 *node = &tree->nodes[0];
+        int bits = 0;
+        while (!node->is_leaf && bits < LOOKUP_BITS) {
+            node = node->b[(code >> bits) & 1];
+            bits++;
+        }
+        tree->lookup[code].node = node;
+        tree->lookup[code].bits = bits;
+    }
+}
+
 static hufftree8 *create_tree8(bitstream *bs)
 {
     if (read_bit(bs)) {
@@ -216,6 +265,7 @@ static hufftree8 *create_tree8(bitstream *bs)
             free(tree);
             return NULL;
         }
+        build_tree8_lookup(tree);
         return tree;
     } else {
         log_info("SMK: WARN: no 8-bit tree found", 0, 0);
@@ -230,7 +280,9 @@ static void free_tree8(hufftree8 *tree)
 
 static uint8_t lookup_tree8(bitstream *bs, hufftree8 *tree)
 {
-    huffnode8 *node = &tree->nodes[0];
+    unsigned int code = peek_bits(bs);
+    huffnode8 *node = tree->lookup[code].node;
+    skip_bits(bs, tree->lookup[code].bits);
     while (!node->is_leaf) {
         node = node->b[read_bit(bs)];
     }
@@ -304,6 +356,21 @@ static huffnode16 *build_tree16_nodes(bitstream *bs, hufftree16 *tree)
     return node;
 }
 
+static void build_tree16_lookup(hufftree16 *tree)
+{
+    // Leaves are stored as nodes rather than values, so the escape values can still change while decoding
+    for (unsigned int code = 0; code < LOOKUP_SIZE; code++) {
+        huffnode16 *node = tree->root;
+        int bits = 0;
+        while (!node->is_leaf && bits < LOOKUP_BITS) {
+            node = node->b[(code >> bits) & 1];
+            bits++;
+        }
+        tree->lookup[code].node = node;
+        tree->lookup[code].bits = bits;
+    }
+}
+
 static hufftree16 *create_tree16(bitstream *bs, hufftree8 *low, hufftree8 *high)
 {
     hufftree16 *tree = (hufftree16 *) clear_malloc(sizeof(hufftree16));
@@ -336,6 +403,7 @@ static hufftree16 *create_tree16(bitstream *bs, hufftree8 *low, hufftree8 *high)
             tree->escape_nodes[i]->value = 0;
         }
     }
+    build_tree16_lookup(tree);
     return tree;
 }
 
@@ -353,7 +421,9 @@ static uint16_t lookup_tree16(bitstream *bs, hufftree16 *tree)
     if (!tree) {
         return 0;
     }
-    huffnode16 *node = tree->root;
+    unsigned int code = peek_bits(bs);
+    huffnode16 *node = tree->lookup[code].node;
+    skip_bits(bs, tree->lookup[code].bits);
     while (!node->is_leaf) {
         node = node->b[read_bit(bs)];
     }
@@ -0,0 +1,62 @@
+#ifndef CORE_THREAD_H
+#define CORE_THREAD_H
+
+/**
+ * @file
+ * Threads and synchronization primitives, implemented by the platform.
+ */
+
+typedef struct thread_handle thread_handle;
+typedef struct thread_mutex thread_mutex;
+typedef struct thread_condition thread_condition;
+
+/**
+ * Function run by a thread
+ * @param userdata The userdata passed to thread_create
+ * @return The thread's exit value
+ */
+typedef int (*thread_function)(void *userdata);
+
+/**
+ * Starts a new thread
+ * @param function The function to run
+ * @param name The name of the thread, for debugging
+ * @param userdata Passed to the function
+ * @return The thread, or 0 if the platform could not create it
+ */
+thread_handle *thread_create(thread_function function, const char *name, void *userdata);
+
+/**
+ * Waits for the thread to finish and releases it
+ * @param thread The thread
+ */
+void thread_wait(thread_handle *thread);
+
+thread_mutex *thread_mutex_create(void);
+
+void thread_mutex_destroy(thread_mutex *mutex);
+
+void thread_mutex_lock(thread_mutex *mutex);
+
+void thread_mutex_unlock(thread_mutex *mutex);
+
+thread_condition *thread_condition_create(void);
+
+void thread_condition_destroy(thread_condition *condition);
+
+/**
+ * Waits until the condition is signaled or the timeout expires. The mutex must be locked by the caller,
+ * it is released while waiting and locked again before returning.
+ * @param condition The condition
+ * @param mutex The locked mutex
+ * @param timeout_ms The maximum time to wait, in milliseconds
+ */
+void thread_condition_wait_timeout(thread_condition *condition, thread_mutex *mutex, unsigned int timeout_ms);
+
+/**
+ * Wakes up a thread waiting on the condition
+ * @param condition The condition
+ */
+void thread_condition_signal(thread_condition *condition);
+
+#endif // CORE_THREAD_H
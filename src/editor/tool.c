@@ -26,7 +26,6 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
 
 #define TERRAIN_PAINT_MASK ~(TERRAIN_TREE | TERRAIN_ROCK | TERRAIN_WATER | TERRAIN_BUILDING |\
                             TERRAIN_SHRUB | TERRAIN_GARDEN | TERRAIN_ROAD | TERRAIN_MEADOW)
@@ -595,7 +594,7 @@ void editor_tool_set_land_selection(grid_slice *selection)
 
 void editor_tool_clear_land_selection(void)
 {
-    memset(data.land_selection, 0, sizeof(grid_slice));
+    map_grid_slice_clear(data.land_selection);
 }
 
 const map_tile *editor_tool_get_start_tile(void)
@@ -608,17 +607,14 @@ const map_tile *editor_tool_get_start_tile(void)
 
 void editor_tool_get_selection_offsets(int *start_offset, int *end_offset)
 {
-    if (!data.land_selection || data.land_selection->size == 0) {
-        if (start_offset) *start_offset = 0;
-        if (end_offset) *end_offset = 0;
-        return;
-    }
-
     // Return the first and last offsets which represent the rectangle corners
+    int first_offset = 0;
+    int last_offset = 0;
+    map_grid_slice_get_first_and_last_offsets(data.land_selection, &first_offset, &last_offset);
     if (start_offset) {
-        *start_offset = data.land_selection->grid_offsets[0];
+        *start_offset = first_offset;
     }
     if (end_offset) {
-        *end_offset = data.land_selection->grid_offsets[data.land_selection->size - 1];
+        *end_offset = last_offset;
     }
 }
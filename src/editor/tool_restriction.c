@@ -6,21 +6,7 @@
 #include "map/grid.h"
 #include "map/terrain.h"
 
-#define OFFSET(x,y) (x + GRID_SIZE * y)
-
-static const int TILE_GRID_OFFSETS[] = {
-OFFSET(0,0), OFFSET(0,1), OFFSET(1,0), OFFSET(1,1),
-OFFSET(0,2), OFFSET(2,0), OFFSET(1,2), OFFSET(2,1),
-OFFSET(2,2), OFFSET(0,3), OFFSET(3,0), OFFSET(1,3),
-OFFSET(3,1), OFFSET(2,3), OFFSET(3,2), OFFSET(3,3) };
-
-
-static const int ACCESS_RAMP_TILE_OFFSETS_BY_ORIENTATION[4][6] = {
-    {OFFSET(0,1), OFFSET(1,1), OFFSET(0,2), OFFSET(1,2), OFFSET(0,0), OFFSET(1,0)},
-    {OFFSET(0,0), OFFSET(0,1), OFFSET(-1,0), OFFSET(-1,1), OFFSET(1,0), OFFSET(1,1)},
-    {OFFSET(0,0), OFFSET(1,0), OFFSET(0,-1), OFFSET(1,-1), OFFSET(0,1), OFFSET(1,1)},
-    {OFFSET(1,0), OFFSET(1,1), OFFSET(2,0), OFFSET(2,1), OFFSET(0,0), OFFSET(0,1)},
-};
+#define OFFSET(x,y) map_grid_delta(x, y)
 
 static int is_clear_terrain(const map_tile *tile, int *warning)
 {
@@ -88,12 +74,18 @@ int editor_tool_can_place_access_ramp(const map_tile *tile, int *orientation_ind
     if (!map_grid_is_inside(tile->x, tile->y, 2)) {
         return 0;
     }
+    const int access_ramp_tile_offsets_by_orientation[4][6] = {
+        {OFFSET(0,1), OFFSET(1,1), OFFSET(0,2), OFFSET(1,2), OFFSET(0,0), OFFSET(1,0)},
+        {OFFSET(0,0), OFFSET(0,1), OFFSET(-1,0), OFFSET(-1,1), OFFSET(1,0), OFFSET(1,1)},
+        {OFFSET(0,0), OFFSET(1,0), OFFSET(0,-1), OFFSET(1,-1), OFFSET(0,1), OFFSET(1,1)},
+        {OFFSET(1,0), OFFSET(1,1), OFFSET(2,0), OFFSET(2,1), OFFSET(0,0), OFFSET(0,1)},
+    };
     for (int orientation = 0; orientation < 4; orientation++) {
         int right_tiles = 0;
         int wrong_tiles = 0;
         int top_elevation = 0;
         for (int index = 0; index < 6; index++) {
-            int tile_offset = tile->grid_offset + ACCESS_RAMP_TILE_OFFSETS_BY_ORIENTATION[orientation][index];
+            int tile_offset = tile->grid_offset + access_ramp_tile_offsets_by_orientation[orientation][index];
             int elevation = map_elevation_at(tile_offset);
             if (index < 2) {
                 if (map_terrain_is(tile_offset, TERRAIN_ELEVATION)) {
@@ -136,9 +128,15 @@ int editor_tool_can_place_access_ramp(const map_tile *tile, int *orientation_ind
 
 int editor_tool_can_place_building(const map_tile *tile, int num_tiles, int *blocked_tiles)
 {
+    const int tile_grid_offsets[] = {
+        OFFSET(0,0), OFFSET(0,1), OFFSET(1,0), OFFSET(1,1),
+        OFFSET(0,2), OFFSET(2,0), OFFSET(1,2), OFFSET(2,1),
+        OFFSET(2,2), OFFSET(0,3), OFFSET(3,0), OFFSET(1,3),
+        OFFSET(3,1), OFFSET(2,3), OFFSET(3,2), OFFSET(3,3)
+    };
     int blocked = 0;
     for (int i = 0; i < num_tiles; i++) {
-        int tile_offset = tile->grid_offset + TILE_GRID_OFFSETS[i];
+        int tile_offset = tile->grid_offset + tile_grid_offsets[i];
         int forbidden_terrain = map_terrain_get(tile_offset) & TERRAIN_NOT_CLEAR;
         if (forbidden_terrain || map_has_figure_at(tile_offset)) {
             blocked = 1;
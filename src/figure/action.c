@@ -131,7 +131,7 @@ void figure_action_handle(void)
 {
     city_figures_reset();
     city_entertainment_set_hippodrome_has_race(0);
-    for (int i = 1; i < figure_count(); i++) {
+    for (unsigned int i = figure_next_live_id(0); i; i = figure_next_live_id(i)) {
         figure *f = figure_get(i);
         if (f->state) {
             if (f->targeted_by_figure_id) {
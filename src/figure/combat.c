@@ -179,7 +179,7 @@ int figure_combat_get_target_for_soldier(int x, int y, int max_distance)
 {
     int min_figure_id = 0;
     int min_distance = 10000;
-    for (int i = 1; i < figure_count(); i++) {
+    for (unsigned int i = figure_next_live_id(0); i; i = figure_next_live_id(i)) {
         figure *f = figure_get(i);
         if (figure_is_dead(f) || f->is_ghost) {
             // Do not allow to target dead and enemies located outside of the map
@@ -201,7 +201,7 @@ int figure_combat_get_target_for_soldier(int x, int y, int max_distance)
     if (min_figure_id) {
         return min_figure_id;
     }
-    for (int i = 1; i < figure_count(); i++) {
+    for (unsigned int i = figure_next_live_id(0); i; i = figure_next_live_id(i)) {
         figure *f = figure_get(i);
         if (figure_is_dead(f)) {
             continue;
@@ -217,7 +217,7 @@ int figure_combat_get_target_for_wolf(int x, int y, int max_distance)
 {
     int min_figure_id = 0;
     int min_distance = 10000;
-    for (int i = 1; i < figure_count(); i++) {
+    for (unsigned int i = figure_next_live_id(0); i; i = figure_next_live_id(i)) {
         figure *f = figure_get(i);
         if (figure_is_dead(f) || !f->type) {
             continue;
@@ -268,7 +268,7 @@ int figure_combat_get_target_for_enemy(int x, int y)
 {
     int min_figure_id = 0;
     int min_distance = 10000;
-    for (int i = 1; i < figure_count(); i++) {
+    for (unsigned int i = figure_next_live_id(0); i; i = figure_next_live_id(i)) {
         figure *f = figure_get(i);
         if (figure_is_dead(f)) {
             continue;
@@ -285,7 +285,7 @@ int figure_combat_get_target_for_enemy(int x, int y)
         return min_figure_id;
     }
     // no 'free' soldier found, take first one
-    for (int i = 1; i < figure_count(); i++) {
+    for (unsigned int i = figure_next_live_id(0); i; i = figure_next_live_id(i)) {
         figure *f = figure_get(i);
         if (figure_is_dead(f)) {
             continue;
@@ -322,7 +322,7 @@ int figure_combat_get_missile_target_for_soldier(figure *shooter, int max_distan
     int min_distance = max_distance;
     figure *min_figure = 0;
     formation *l = formation_get(shooter->formation_id);
-    for (int i = 1; i < figure_count(); i++) {
+    for (unsigned int i = figure_next_live_id(0); i; i = figure_next_live_id(i)) {
         figure *f = figure_get(i);
         if (figure_is_dead(f) || f->is_ghost) {
             // Do not allow to target dead and enemies located outside of the map
@@ -355,7 +355,7 @@ int figure_combat_get_missile_target_for_enemy(figure *enemy, int max_distance,
 
     figure *min_figure = 0;
     int min_distance = max_distance;
-    for (int i = 1; i < figure_count(); i++) {
+    for (unsigned int i = figure_next_live_id(0); i; i = figure_next_live_id(i)) {
         figure *f = figure_get(i);
         if (figure_is_dead(f) || !f->type) {
             continue;
@@ -25,6 +25,12 @@
 static struct {
     int created_sequence;
     array(figure) figures;
+    struct {
+        unsigned int *ids;
+        unsigned int size;
+        unsigned int capacity;
+        unsigned int cursor;
+    } live;
 } data;
 
 figure *figure_get(int id)
@@ -37,11 +43,77 @@ int figure_count(void)
     return data.figures.size;
 }
 
+static unsigned int find_live_index_after(unsigned int id)
+{
+    unsigned int low = 0;
+    unsigned int high = data.live.size;
+    while (low < high) {
+        unsigned int middle = low + (high - low) / 2;
+        if (data.live.ids[middle] <= id) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+unsigned int figure_next_live_id(unsigned int id)
+{
+    unsigned int index;
+    // Fast path for the usual case of iterating without figures being added or removed in between
+    if (data.live.cursor < data.live.size && data.live.ids[data.live.cursor] == id) {
+        index = data.live.cursor + 1;
+    } else {
+        index = find_live_index_after(id);
+    }
+    if (index >= data.live.size) {
+        return 0;
+    }
+    data.live.cursor = index;
+    return data.live.ids[index];
+}
+
+static int add_live_id(unsigned int id)
+{
+    if (data.live.size >= data.live.capacity) {
+        unsigned int new_capacity = data.live.capacity + FIGURE_ARRAY_SIZE_STEP;
+        unsigned int *ids = realloc(data.live.ids, new_capacity * sizeof(unsigned int));
+        if (!ids) {
+            return 0;
+        }
+        data.live.ids = ids;
+        data.live.capacity = new_capacity;
+    }
+    unsigned int index = find_live_index_after(id);
+    memmove(&data.live.ids[index + 1], &data.live.ids[index], (data.live.size - index) * sizeof(unsigned int));
+    data.live.ids[index] = id;
+    data.live.size++;
+    return 1;
+}
+
+static void remove_live_id(unsigned int id)
+{
+    unsigned int index = find_live_index_after(id);
+    if (!index || data.live.ids[index - 1] != id) {
+        return;
+    }
+    index--;
+    memmove(&data.live.ids[index], &data.live.ids[index + 1], (data.live.size - index - 1) * sizeof(unsigned int));
+    data.live.size--;
+}
+
+static void clear_live_ids(void)
+{
+    data.live.size = 0;
+    data.live.cursor = 0;
+}
+
 figure *figure_create(figure_type type, int x, int y, direction_type dir)
 {
     figure *f = 0;
     array_new_item_after_index(data.figures, 1, f);
-    if (!f) {
+    if (!f || !add_live_id(f->id)) {
         return array_first(data.figures);
     }
 
@@ -204,6 +276,7 @@ void figure_delete(figure *f)
     int figure_id = f->id;
     memset(f, 0, sizeof(figure));
     f->id = figure_id;
+    remove_live_id(figure_id);
 
     array_trim(data.figures);
 }
@@ -309,6 +382,7 @@ void figure_init_scenario(void)
         !array_next(data.figures)) { // Ignore first figure
         log_error("Unable to create figures array. The game will now crash.", 0, 0);
     }
+    clear_live_ids();
     data.created_sequence = 0;
 }
 
@@ -642,12 +716,16 @@ void figure_load_state(buffer *list, buffer *seq, int version)
     }
 
     int highest_id_in_use = 0;
+    clear_live_ids();
 
     for (int i = 0; i < figures_to_load; i++) {
         figure *f = array_next(data.figures);
         figure_load(list, f, figure_buf_size, version);
         if (f->state) {
             highest_id_in_use = i;
+            if (!add_live_id(i)) {
+                log_error("Unable to create figures array. The game will now crash.", 0, 0);
+            }
         }
     }
     data.figures.size = highest_id_in_use + 1;
@@ -128,6 +128,14 @@ figure *figure_get(int id);
 
 int figure_count(void);
 
+/**
+ * Gets the next figure in use, in ascending id order. Figures created while iterating
+ * with a higher id than the current one are also returned, just like a plain id loop would.
+ * @param id The current figure id, or 0 to get the first figure in use
+ * @return The id of the next figure in use, or 0 if there are no more figures
+ */
+unsigned int figure_next_live_id(unsigned int id);
+
 /**
  * Creates a figure
  * @param type Figure type
@@ -2,25 +2,72 @@
 
 #include "building/industry.h"
 #include "building/properties.h"
+#include "building/roadblock.h"
 #include "building/rotation.h"
 #include "core/config.h"
+#include "core/log.h"
 #include "figure/figure.h"
 #include "figure/movement.h"
 #include "figure/route.h"
 #include "map/building.h"
 #include "map/grid.h"
 #include "map/road_access.h"
+#include "map/terrain.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 #define TOTAL_ROAMERS 4
 #define MAX_STORED_BUILDING_TYPES 2
 #define SHOWN_BUILDING_OFFSET 12
 
+#define PATH_SIZE_STEP 512
+#define STEP_SHIFT 24
+#define GRID_OFFSET_MASK ((1 << STEP_SHIFT) - 1)
+// Roamers look for roads up to 14 tiles away from their building when choosing where to go
+#define PATH_AREA_MARGIN 16
+
+enum {
+    STEP_PASS = 0,
+    STEP_EXIT = 1,
+    STEP_ENTRY = 2
+};
+
+// The tiles visited by the roamers of a building, in order, so they can be applied again without simulating
+typedef struct {
+    unsigned int *steps;
+    unsigned int size;
+    unsigned int capacity;
+    int x_min;
+    int y_min;
+    int x_max;
+    int y_max;
+} roamer_path;
+
+typedef struct {
+    int is_valid;
+    building_type type;
+    int x;
+    int y;
+    int skip_corners;
+    roamer_path path;
+} cached_roamer_path;
+
 static struct {
     grid_u8 travelled_tiles;
     building_type types[MAX_STORED_BUILDING_TYPES];
     int stored_building_types;
+    roamer_path scratch_path;
+    struct {
+        cached_roamer_path *items;
+        unsigned int size;
+    } cached;
+    grid_u32 tile_fingerprints;
+    struct {
+        int *items;
+        int width;
+        int height;
+    } changed_tiles_sum;
 } data;
 
 static figure_type building_type_to_figure_type(building_type type)
@@ -199,31 +246,47 @@ static int determine_road_access(int x, int y, int size, building_type type, map
     }
 }
 
-void figure_roamer_preview_create(building_type b_type, int x, int y)
+static void add_step(roamer_path *path, int grid_offset, int step)
 {
-    if (!config_get(CONFIG_UI_SHOW_ROAMING_PATH)) {
-        figure_roamer_preview_reset_building_types();
-        return;
+    if (path->size >= path->capacity) {
+        unsigned int new_capacity = path->capacity ? path->capacity * 2 : PATH_SIZE_STEP;
+        unsigned int *steps = realloc(path->steps, new_capacity * sizeof(unsigned int));
+        if (!steps) {
+            log_error("Unable to allocate memory for the roamer preview. The game will now crash.", 0, 0);
+            return;
+        }
+        path->steps = steps;
+        path->capacity = new_capacity;
     }
-
-    figure_type fig_type = building_type_to_figure_type(b_type);
-    if (fig_type == FIGURE_NONE) {
-        return;
+    path->steps[path->size++] = (unsigned int) grid_offset | (step << STEP_SHIFT);
+    int x = map_grid_offset_to_x(grid_offset);
+    int y = map_grid_offset_to_y(grid_offset);
+    if (x < path->x_min) {
+        path->x_min = x;
     }
-
-    if (fig_type == FIGURE_LABOR_SEEKER && config_get(CONFIG_GP_CH_GLOBAL_LABOUR)) {
-        return;
+    if (x > path->x_max) {
+        path->x_max = x;
     }
-
-    int grid_offset = map_grid_offset(x, y);
-
-    if (data.travelled_tiles.items[grid_offset] == SHOWN_BUILDING_OFFSET) {
-        return;
+    if (y < path->y_min) {
+        path->y_min = y;
     }
+    if (y > path->y_max) {
+        path->y_max = y;
+    }
+}
 
-    data.travelled_tiles.items[grid_offset] = SHOWN_BUILDING_OFFSET;
+static void simulate_roamers(building_type b_type, int x, int y, roamer_path *path)
+{
+    path->size = 0;
+    path->x_min = x;
+    path->y_min = y;
+    path->x_max = x;
+    path->y_max = y;
 
+    figure_type fig_type = building_type_to_figure_type(b_type);
     int b_size = building_is_farm(b_type) ? 3 : building_properties_for_type(b_type)->size;
+    path->x_max += b_size - 1;
+    path->y_max += b_size - 1;
 
     map_point road;
     if (!determine_road_access(x, y, b_size, b_type, &road)) {
@@ -265,12 +328,12 @@ void figure_roamer_preview_create(building_type b_type, int x, int y)
         }
         roamer.grid_offset = map_grid_offset(roamer.x, roamer.y);
         if (map_grid_is_valid_offset(roamer.grid_offset)) {
-            data.travelled_tiles.items[roamer.grid_offset] = FIGURE_ROAMER_PREVIEW_EXIT_TILE;
+            add_step(path, roamer.grid_offset, STEP_EXIT);
         }
         init_roaming(&roamer, i * 2, roamer.x, roamer.y);
         while (++roamer.roam_length < roamer.max_roam_length) {
-            if (roamer.progress_on_tile == 0 && data.travelled_tiles.items[roamer.grid_offset] < FIGURE_ROAMER_PREVIEW_MAX_PASSAGES) {
-                data.travelled_tiles.items[roamer.grid_offset]++;
+            if (roamer.progress_on_tile == 0) {
+                add_step(path, roamer.grid_offset, STEP_PASS);
             }
             figure_movement_roam_ticks(&roamer, 1);
         }
@@ -284,17 +347,210 @@ void figure_roamer_preview_create(building_type b_type, int x, int y)
         roamer.destination_y = y_road;
         while (roamer.direction != DIR_FIGURE_AT_DESTINATION &&
             roamer.direction != DIR_FIGURE_REROUTE && roamer.direction != DIR_FIGURE_LOST) {
-            if (data.travelled_tiles.items[roamer.grid_offset] < FIGURE_ROAMER_PREVIEW_MAX_PASSAGES) {
-                data.travelled_tiles.items[roamer.grid_offset]++;
-            }
+            add_step(path, roamer.grid_offset, STEP_PASS);
             roamer.progress_on_tile = 15;
             figure_movement_move_ticks(&roamer, 1);
         }
         figure_route_remove(&roamer);
         if (roamer.direction == DIR_FIGURE_AT_DESTINATION) {
-            int tile_type = data.travelled_tiles.items[roamer.grid_offset];
-            data.travelled_tiles.items[roamer.grid_offset] = tile_type < FIGURE_ROAMER_PREVIEW_EXIT_TILE ?
-                FIGURE_ROAMER_PREVIEW_ENTRY_TILE : FIGURE_ROAMER_PREVIEW_ENTRY_EXIT_TILE;
+            add_step(path, roamer.grid_offset, STEP_ENTRY);
+        }
+    }
+}
+
+static void apply_path(const roamer_path *path)
+{
+    for (unsigned int i = 0; i < path->size; i++) {
+        int grid_offset = path->steps[i] & GRID_OFFSET_MASK;
+        int tile_type = data.travelled_tiles.items[grid_offset];
+        switch (path->steps[i] >> STEP_SHIFT) {
+            case STEP_EXIT:
+                data.travelled_tiles.items[grid_offset] = FIGURE_ROAMER_PREVIEW_EXIT_TILE;
+                break;
+            case STEP_PASS:
+                if (tile_type < FIGURE_ROAMER_PREVIEW_MAX_PASSAGES) {
+                    data.travelled_tiles.items[grid_offset]++;
+                }
+                break;
+            case STEP_ENTRY:
+                data.travelled_tiles.items[grid_offset] = tile_type < FIGURE_ROAMER_PREVIEW_EXIT_TILE ?
+                    FIGURE_ROAMER_PREVIEW_ENTRY_TILE : FIGURE_ROAMER_PREVIEW_ENTRY_EXIT_TILE;
+                break;
+        }
+    }
+}
+
+static int can_show_roamers(building_type b_type)
+{
+    figure_type fig_type = building_type_to_figure_type(b_type);
+    if (fig_type == FIGURE_NONE) {
+        return 0;
+    }
+    if (fig_type == FIGURE_LABOR_SEEKER && config_get(CONFIG_GP_CH_GLOBAL_LABOUR)) {
+        return 0;
+    }
+    return 1;
+}
+
+static int mark_building_shown(int x, int y)
+{
+    int grid_offset = map_grid_offset(x, y);
+
+    if (data.travelled_tiles.items[grid_offset] == SHOWN_BUILDING_OFFSET) {
+        return 0;
+    }
+
+    data.travelled_tiles.items[grid_offset] = SHOWN_BUILDING_OFFSET;
+    return 1;
+}
+
+void figure_roamer_preview_create(building_type b_type, int x, int y)
+{
+    if (!config_get(CONFIG_UI_SHOW_ROAMING_PATH)) {
+        figure_roamer_preview_reset_building_types();
+        return;
+    }
+    if (!can_show_roamers(b_type) || !mark_building_shown(x, y)) {
+        return;
+    }
+    simulate_roamers(b_type, x, y, &data.scratch_path);
+    apply_path(&data.scratch_path);
+}
+
+static unsigned int get_tile_fingerprint(int grid_offset)
+{
+    unsigned int building_id = map_building_at(grid_offset);
+    unsigned int fingerprint = map_terrain_get(grid_offset) ^ (building_id * 2654435761u);
+    if (building_id) {
+        building *b = building_get(building_id);
+        if (building_type_is_roadblock(b->type)) {
+            // Multiplying by an odd number keeps every permission bit, unlike shifting them in
+            fingerprint = (fingerprint ^ b->data.roadblock.exceptions) * 16777619u;
+        }
+    }
+    return fingerprint;
+}
+
+static inline int *changed_tiles_sum(int x, int y)
+{
+    return &data.changed_tiles_sum.items[y * (data.changed_tiles_sum.width + 1) + x];
+}
+
+static int count_changed_tiles_in_area(int x_min, int y_min, int x_max, int y_max)
+{
+    map_grid_bound_area(&x_min, &y_min, &x_max, &y_max);
+    int count = *changed_tiles_sum(x_max + 1, y_max + 1);
+    count -= *changed_tiles_sum(x_max + 1, y_min);
+    count -= *changed_tiles_sum(x_min, y_max + 1);
+    count += *changed_tiles_sum(x_min, y_min);
+    return count;
+}
+
+static int resize_changed_tiles_sum(void)
+{
+    int width = map_grid_width();
+    int height = map_grid_height();
+    if (data.changed_tiles_sum.items &&
+        data.changed_tiles_sum.width == width && data.changed_tiles_sum.height == height) {
+        return 1;
+    }
+    free(data.changed_tiles_sum.items);
+    // The first row and column stay zero so the sums need no bounds checks
+    data.changed_tiles_sum.items = calloc((width + 1) * (height + 1), sizeof(int));
+    if (!data.changed_tiles_sum.items) {
+        log_error("Unable to allocate memory for the roamer preview. Cached paths will not be used.", 0, 0);
+        return 0;
+    }
+    data.changed_tiles_sum.width = width;
+    data.changed_tiles_sum.height = height;
+    return 1;
+}
+
+static void invalidate_changed_paths(void)
+{
+    // Keep a summed area table of the changed tiles so that each cached path only checks its own area
+    if (!resize_changed_tiles_sum()) {
+        for (unsigned int i = 0; i < data.cached.size; i++) {
+            data.cached.items[i].is_valid = 0;
+        }
+        return;
+    }
+    map_grid_ensure_u32(&data.tile_fingerprints);
+    int has_changes = 0;
+    for (int y = 0; y < map_grid_height(); y++) {
+        int row_sum = 0;
+        for (int x = 0; x < map_grid_width(); x++) {
+            int grid_offset = map_grid_offset(x, y);
+            unsigned int fingerprint = get_tile_fingerprint(grid_offset);
+            if (fingerprint != data.tile_fingerprints.items[grid_offset]) {
+                data.tile_fingerprints.items[grid_offset] = fingerprint;
+                row_sum++;
+                has_changes = 1;
+            }
+            *changed_tiles_sum(x + 1, y + 1) = *changed_tiles_sum(x + 1, y) + row_sum;
+        }
+    }
+    int skip_corners = config_get(CONFIG_GP_CH_ROAMERS_DONT_SKIP_CORNERS);
+    for (unsigned int i = 0; i < data.cached.size; i++) {
+        cached_roamer_path *cached = &data.cached.items[i];
+        if (!cached->is_valid) {
+            continue;
+        }
+        if (cached->skip_corners != skip_corners || (has_changes && count_changed_tiles_in_area(
+            cached->path.x_min - PATH_AREA_MARGIN, cached->path.y_min - PATH_AREA_MARGIN,
+            cached->path.x_max + PATH_AREA_MARGIN, cached->path.y_max + PATH_AREA_MARGIN))) {
+            cached->is_valid = 0;
+        }
+    }
+}
+
+static cached_roamer_path *get_cached_path(unsigned int building_id)
+{
+    if (building_id >= data.cached.size) {
+        unsigned int new_size = building_id + 1;
+        cached_roamer_path *items = realloc(data.cached.items, new_size * sizeof(cached_roamer_path));
+        if (!items) {
+            return 0;
+        }
+        memset(&items[data.cached.size], 0, (new_size - data.cached.size) * sizeof(cached_roamer_path));
+        data.cached.items = items;
+        data.cached.size = new_size;
+    }
+    return &data.cached.items[building_id];
+}
+
+static void create_for_building(const building *b)
+{
+    if (!can_show_roamers(b->type) || !mark_building_shown(b->x, b->y)) {
+        return;
+    }
+    cached_roamer_path *cached = get_cached_path(b->id);
+    if (!cached) {
+        simulate_roamers(b->type, b->x, b->y, &data.scratch_path);
+        apply_path(&data.scratch_path);
+        return;
+    }
+    if (!cached->is_valid || cached->type != b->type || cached->x != b->x || cached->y != b->y) {
+        simulate_roamers(b->type, b->x, b->y, &cached->path);
+        cached->type = b->type;
+        cached->x = b->x;
+        cached->y = b->y;
+        cached->skip_corners = config_get(CONFIG_GP_CH_ROAMERS_DONT_SKIP_CORNERS);
+        cached->is_valid = 1;
+    }
+    apply_path(&cached->path);
+}
+
+static void create_for_stored_building_types(void)
+{
+    if (!config_get(CONFIG_UI_SHOW_ROAMING_PATH)) {
+        figure_roamer_preview_reset_building_types();
+        return;
+    }
+    invalidate_changed_paths();
+    for (int i = 0; i < data.stored_building_types; i++) {
+        for (building *b = building_first_of_type(data.types[i]); b; b = b->next_of_type) {
+            create_for_building(b);
         }
     }
 }
@@ -316,8 +572,9 @@ void figure_roamer_preview_create_all_for_building_type(building_type type)
     if (data.stored_building_types == MAX_STORED_BUILDING_TYPES) {
         return;
     }
+    invalidate_changed_paths();
     for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
-        figure_roamer_preview_create(type, b->x, b->y);
+        create_for_building(b);
     }
     data.types[data.stored_building_types] = type;
     data.stored_building_types++;
@@ -325,7 +582,7 @@ void figure_roamer_preview_create_all_for_building_type(building_type type)
 
 void figure_roamer_preview_reset(building_type type)
 {
-    map_grid_clear_u8(data.travelled_tiles.items);
+    map_grid_clear_u8(&data.travelled_tiles);
     int show_other_roamers = 0;
     figure_type fig_type = building_type_to_figure_type(type);
     if (fig_type == FIGURE_LABOR_SEEKER && config_get(CONFIG_GP_CH_GLOBAL_LABOUR)) {
@@ -341,12 +598,8 @@ void figure_roamer_preview_reset(building_type type)
             }
         }
     }
-    if (show_other_roamers) {
-        for (int i = 0; i < data.stored_building_types; i++) {
-            for (building *b = building_first_of_type(data.types[i]); b; b = b->next_of_type) {
-                figure_roamer_preview_create(b->type, b->x, b->y);
-            }
-        }
+    if (show_other_roamers && data.stored_building_types) {
+        create_for_stored_building_types();
     }
 }
 
@@ -356,6 +609,18 @@ void figure_roamer_preview_reset_building_types(void)
     figure_roamer_preview_reset(BUILDING_NONE);
 }
 
+void figure_roamer_preview_clear_cache(void)
+{
+    for (unsigned int i = 0; i < data.cached.size; i++) {
+        free(data.cached.items[i].path.steps);
+    }
+    free(data.cached.items);
+    data.cached.items = 0;
+    data.cached.size = 0;
+    map_grid_clear_u32(&data.tile_fingerprints);
+    figure_roamer_preview_reset_building_types();
+}
+
 int figure_roamer_preview_get_frequency(int grid_offset)
 {
     return map_grid_is_valid_offset(grid_offset) ? data.travelled_tiles.items[grid_offset] : 0;
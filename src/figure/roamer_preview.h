@@ -13,6 +13,11 @@ void figure_roamer_preview_create(building_type b_type, int x, int y);
 void figure_roamer_preview_create_all_for_building_type(building_type type);
 void figure_roamer_preview_reset(building_type type);
 void figure_roamer_preview_reset_building_types(void);
+
+/**
+ * Forgets the roamer paths kept for the buildings, must be called when a new city is started or loaded
+ */
+void figure_roamer_preview_clear_cache(void);
 int figure_roamer_preview_get_frequency(int grid_offset);
 
 #endif // FIGURE_ROAMER_PREVIEW_H
@@ -2,9 +2,11 @@
 
 #include "building/building.h"
 #include "building/distribution.h"
+#include "building/house_service.h"
 #include "building/monument.h"
 #include "building/properties.h"
 #include "city/buildings.h"
+#include "city/culture.h"
 #include "city/finance.h"
 #include "core/config.h"
 #include "core/random.h"
@@ -18,22 +20,19 @@
 #define MAX_COVERAGE 96
 #define TOURISM_COOLDOWN 96
 
+// The coverage callbacks give the same result when called once per building instead of once per tile,
+// but every tile of a house still counts towards the houses covered by the walker
 static int provide_culture(int x, int y, void (*callback)(building *))
 {
     int serviced = 0;
-    int x_min, y_min, x_max, y_max;
-    map_grid_get_area(x, y, 1, 2, &x_min, &y_min, &x_max, &y_max);
-    for (int yy = y_min; yy <= y_max; yy++) {
-        for (int xx = x_min; xx <= x_max; xx++) {
-            int grid_offset = map_grid_offset(xx, yy);
-            int building_id = map_building_at(grid_offset);
-            if (building_id) {
-                building *b = building_get(building_id);
-                if (b->house_size && b->house_population > 0) {
-                    callback(b);
-                    serviced++;
-                }
-            }
+    int count;
+    const map_building_nearby *nearby = map_building_get_nearby(x, y, &count);
+    for (int i = 0; i < count; i++) {
+        building *b = building_get(nearby[i].building_id);
+        if (b->house_size && b->house_population > 0) {
+            callback(b);
+            house_service_track(b);
+            serviced += nearby[i].tiles;
         }
     }
     return serviced;
@@ -62,19 +61,14 @@ static void provide_sickness(int x, int y, void (*callback)(building *, int sick
 static int provide_entertainment(int x, int y, int shows, void (*callback)(building *, int))
 {
     int serviced = 0;
-    int x_min, y_min, x_max, y_max;
-    map_grid_get_area(x, y, 1, 2, &x_min, &y_min, &x_max, &y_max);
-    for (int yy = y_min; yy <= y_max; yy++) {
-        for (int xx = x_min; xx <= x_max; xx++) {
-            int grid_offset = map_grid_offset(xx, yy);
-            int building_id = map_building_at(grid_offset);
-            if (building_id) {
-                building *b = building_get(building_id);
-                if (b->house_size && b->house_population > 0) {
-                    callback(b, shows);
-                    serviced++;
-                }
-            }
+    int count;
+    const map_building_nearby *nearby = map_building_get_nearby(x, y, &count);
+    for (int i = 0; i < count; i++) {
+        building *b = building_get(nearby[i].building_id);
+        if (b->house_size && b->house_population > 0) {
+            callback(b, shows);
+            house_service_track(b);
+            serviced += nearby[i].tiles;
         }
     }
     return serviced;
@@ -155,6 +149,7 @@ static void religion_coverage_mars(building *b)
 static void religion_coverage_venus(building *b)
 {
     b->data.house.temple_venus = MAX_COVERAGE;
+    city_culture_update_building(b);
 }
 
 static void religion_coverage_pantheon(building *b)
@@ -273,19 +268,13 @@ static void tourist_spend(building *b, figure *f)
 static int provide_service(int x, int y, int *data, void (*callback)(building *, int *))
 {
     int serviced = 0;
-    int x_min, y_min, x_max, y_max;
-    map_grid_get_area(x, y, 1, 2, &x_min, &y_min, &x_max, &y_max);
-    for (int yy = y_min; yy <= y_max; yy++) {
-        for (int xx = x_min; xx <= x_max; xx++) {
-            int grid_offset = map_grid_offset(xx, yy);
-            int building_id = map_building_at(grid_offset);
-            if (building_id) {
-                building *b = building_get(building_id);
-                callback(b, data);
-                if (b->house_size && b->house_population > 0) {
-                    serviced++;
-                }
-            }
+    int count;
+    const map_building_nearby *nearby = map_building_get_nearby(x, y, &count);
+    for (int i = 0; i < count; i++) {
+        building *b = building_get(nearby[i].building_id);
+        callback(b, data);
+        if (b->house_size && b->house_population > 0) {
+            serviced += nearby[i].tiles;
         }
     }
     return serviced;
@@ -321,6 +310,7 @@ static void tax_collector_coverage(building *b, int *max_tax_multiplier)
             *max_tax_multiplier = tax_multiplier;
         }
         b->house_tax_coverage = 50;
+        house_service_track(b);
     }
 }
 
@@ -361,6 +351,7 @@ static void collect_offerings_from_house(building *house, building *temple)
             }
         }
         house->days_since_offering = 0;
+        house_service_track(house);
     }
 }
 
@@ -540,7 +540,7 @@ void figure_hippodrome_horse_reroute(void)
     if (!city_entertainment_hippodrome_has_race()) {
         return;
     }
-    for (int i = 1; i < figure_count(); i++) {
+    for (unsigned int i = figure_next_live_id(0); i; i = figure_next_live_id(i)) {
         figure *f = figure_get(i);
         if (f->state == FIGURE_STATE_ALIVE && f->type == FIGURE_HIPPODROME_HORSES) {
             f->wait_ticks_missile = 0;
@@ -2,6 +2,7 @@
 #include "building/building.h"
 #include "building/list.h"
 #include "building/monument.h"
+#include "city/culture.h"
 #include "city/festival.h"
 #include "city/figures.h"
 #include "city/map.h"
@@ -177,6 +178,7 @@ static void update_shows(figure *f)
             b->data.entertainment.days1 = 32;
             break;
     }
+    city_culture_update_building(b);
 }
 
 static void update_image(figure *f)
@@ -254,7 +256,7 @@ static int get_nearest_enemy(int x, int y, int *distance)
 {
     int min_enemy_id = 0;
     int min_dist = INFINITE;
-    for (int i = 1; i < figure_count(); i++) {
+    for (unsigned int i = figure_next_live_id(0); i; i = figure_next_live_id(i)) {
         figure *f = figure_get(i);
         if (figure_is_dead(f)) {
             continue;
@@ -3,9 +3,10 @@
 #include "building/house.h"
 #include "building/house_population.h"
 #include "building/properties.h"
+#include "building/spatial.h"
+#include "city/culture.h"
 #include "city/map.h"
 #include "city/population.h"
-#include "core/calc.h"
 #include "core/image.h"
 #include "core/time.h"
 #include "figure/combat.h"
@@ -36,6 +37,7 @@ void figure_create_emigrant(building *house, int num_people)
     city_population_remove(num_people);
     if (num_people < house->house_population) {
         house->house_population -= num_people;
+        city_culture_update_building(house);
     } else {
         building_house_change_to_vacant_lot(house);
     }
@@ -67,32 +69,30 @@ static void update_direction_and_image(figure *f)
     }
 }
 
+static int is_house_with_room(building *b, void *userdata)
+{
+    return b->state == BUILDING_STATE_IN_USE && b->house_size && !b->has_plague &&
+        b->distance_from_entry > 0 && b->house_population_room > 0 && !b->immigrant_figure_id;
+}
+
 static int closest_house_with_room(int x, int y)
 {
     if (houses_with_room.last_check == time_get_millis() && !houses_with_room.available) {
         return 0;
     }
-    int available_houses = 0;
     int min_dist = 1000;
     int min_building_id = 0;
     for (building_type type = BUILDING_HOUSE_SMALL_TENT; type <= BUILDING_HOUSE_LUXURY_PALACE; type++) {
-        for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
-            if (b->state == BUILDING_STATE_IN_USE && b->house_size && !b->has_plague &&
-                b->distance_from_entry > 0 && b->house_population_room > 0) {
-                if (!b->immigrant_figure_id) {
-                    int dist = calc_maximum_distance(x, y, b->x, b->y);
-                    available_houses++;
-                    if (dist < min_dist) {
-                        min_dist = dist;
-                        min_building_id = b->id;
-                    }
-                }
-            }
+        // Only a strictly closer house replaces one found for a previous type
+        int dist;
+        int building_id = building_spatial_find_closest(type, x, y, min_dist - 1, is_house_with_room, 0, &dist);
+        if (building_id) {
+            min_dist = dist;
+            min_building_id = building_id;
         }
     }
-    available_houses--;
     houses_with_room.last_check = time_get_millis();
-    houses_with_room.available = available_houses;
+    houses_with_room.available = min_building_id != 0;
     return min_building_id;
 }
 
@@ -173,6 +173,7 @@ void figure_immigrant_action(figure *f)
                 int is_empty = b->house_population == 0;
                 b->house_population += f->migrant_num_people;
                 b->house_population_room = max_people - b->house_population;
+                city_culture_update_building(b);
                 city_population_add(f->migrant_num_people);
                 if (is_empty) {
                     building_house_change_to(b, BUILDING_HOUSE_SMALL_TENT);
@@ -321,6 +322,7 @@ void figure_homeless_action(figure *f)
                     int is_empty = b->house_population == 0;
                     b->house_population += f->migrant_num_people;
                     b->house_population_room = max_people - b->house_population;
+                    city_culture_update_building(b);
                     city_population_add_homeless(f->migrant_num_people);
                     if (is_empty) {
                         building_house_change_to(b, BUILDING_HOUSE_SMALL_TENT);
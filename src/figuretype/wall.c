@@ -338,7 +338,7 @@ void figure_tower_sentry_action(figure *f)
 
 void figure_tower_sentry_reroute(void)
 {
-    for (int i = 1; i < figure_count(); i++) {
+    for (unsigned int i = figure_next_live_id(0); i; i = figure_next_live_id(i)) {
         figure *f = figure_get(i);
         if (f->type != FIGURE_TOWER_SENTRY || map_routing_is_wall_passable(f->grid_offset)) {
             continue;
@@ -17,12 +17,14 @@
 #include "empire/city.h"
 #include "figure/figure.h"
 #include "figuretype/crime.h"
+#include "game/replay.h"
 #include "game/tick.h"
 #include "graphics/color.h"
 #include "graphics/font.h"
 #include "graphics/text.h"
 #include "graphics/weather.h"
 #include "graphics/window.h"
+#include "platform/file_manager.h"
 #include "scenario/invasion.h"
 #include "scenario/property.h"
 #include "scenario/scenario.h"
@@ -34,6 +36,7 @@
 #include "window/editor/scenario_events.h"
 #include "window/plain_message_dialog.h"
 
+#include <stdio.h>
 #include <string.h>
 
 static int map_editor_warning_shown;
@@ -56,6 +59,8 @@ static void game_cheat_disable_legions_consumption(uint8_t *);
 static void game_cheat_disable_invasions(uint8_t *);
 static void game_cheat_change_weather(uint8_t *);
 static void game_cheat_destroy_building(uint8_t *);
+static void game_cheat_start_replay(uint8_t *);
+static void game_cheat_stop_replay(uint8_t *);
 
 static void (*const execute_command[])(uint8_t *args) = {
     game_cheat_add_money,
@@ -77,7 +82,9 @@ static void (*const execute_command[])(uint8_t *args) = {
     game_cheat_disable_legions_consumption,
     game_cheat_disable_invasions,
     game_cheat_change_weather,
-    game_cheat_destroy_building
+    game_cheat_destroy_building,
+    game_cheat_start_replay,
+    game_cheat_stop_replay
 };
 
 static const char *commands[] = {
@@ -100,7 +107,9 @@ static const char *commands[] = {
     "breadandfish",
     "leavemealone",
     "weather",                   // syntax: weather <weather_type> <intensity>
-    "destroy"                   // syntax: destroy <building_id> <destruction_type>
+    "destroy",                  // syntax: destroy <building_id> <destruction_type>
+    "startreplay",              // syntax: startreplay <name>
+    "stopreplay"
 };
 
 #define NUMBER_OF_COMMANDS sizeof (commands) / sizeof (commands[0])
@@ -393,8 +402,27 @@ static void game_cheat_destroy_building(uint8_t *args)
     show_warning(TR_CHEAT_DESTROYED_BUILDING);
 }
 
+static void game_cheat_start_replay(uint8_t *args)
+{
+    uint8_t name[MAX_COMMAND_SIZE];
+    parse_word(args, name);
+    if (!*name || game_replay_is_playing()) {
+        return;
+    }
+    char filename[FILE_NAME_MAX];
+    snprintf(filename, FILE_NAME_MAX, "%s%s.rpl",
+        platform_file_manager_get_directory_for_location(PATH_LOCATION_SAVEGAME, 0), (const char *) name);
+    game_replay_start_recording(filename);
+}
+
+static void game_cheat_stop_replay(uint8_t *args)
+{
+    game_replay_stop_recording();
+}
+
 void game_cheat_parse_command(uint8_t *command)
 {
+    game_replay_record_command(command);
     uint8_t command_to_call[MAX_COMMAND_SIZE];
     int next_arg = parse_word(command, command_to_call);
     for (int i = 0; i < NUMBER_OF_COMMANDS; i++) {
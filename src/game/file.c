@@ -27,6 +27,7 @@
 #include "figure/enemy_army.h"
 #include "figure/formation.h"
 #include "figure/name.h"
+#include "figure/roamer_preview.h"
 #include "figure/route.h"
 #include "figure/trader.h"
 #include "figure/visited_buildings.h"
@@ -117,6 +118,7 @@ static void clear_scenario_data(void)
     building_monument_initialize_deliveries();
     figure_route_clear_all();
     figure_visited_buildings_init();
+    figure_roamer_preview_clear_cache();
     scenario_events_clear();
     custom_messages_clear_all();
 
@@ -275,6 +277,8 @@ static void initialize_saved_game(void)
     map_image_update_all();
 
     scenario_map_init();
+    // The soldier strength is not saved, make sure it matches the size of the loaded map
+    map_soldier_strength_clear();
 
     city_view_init();
 
@@ -282,6 +286,7 @@ static void initialize_saved_game(void)
 
     map_orientation_update_buildings();
     figure_route_clean();
+    figure_roamer_preview_clear_cache();
     map_road_network_update();
     map_routing_update_land();
     building_maintenance_check_rome_access();
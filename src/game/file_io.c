@@ -74,9 +74,9 @@
 #define COMPRESS_BUFFER_INITIAL_SIZE 1000000
 #define UNCOMPRESSED 0x80000000
 #define PIECE_SIZE_DYNAMIC 0
-#define GRID_SIZE_BUF_U8 GRID_SIZE * GRID_SIZE
-#define GRID_SIZE_BUF_U16 GRID_SIZE * GRID_SIZE * 2
-#define GRID_SIZE_BUF_U32 GRID_SIZE * GRID_SIZE * 4
+#define GRID_SIZE_BUF_U8 GRID_SIZE_LEGACY * GRID_SIZE_LEGACY
+#define GRID_SIZE_BUF_U16 GRID_SIZE_LEGACY * GRID_SIZE_LEGACY * 2
+#define GRID_SIZE_BUF_U32 GRID_SIZE_LEGACY * GRID_SIZE_LEGACY * 4
 
 typedef struct {
     buffer buf;
@@ -240,6 +240,8 @@ typedef struct {
         int building_grid;
         int rubble_grid;
         int terrain_grid;
+        int grid_u8;
+        int grid_u16;
         int figures;
         int route_figures;
         int route_paths;
@@ -364,16 +366,18 @@ static void init_scenario_data(scenario_version_t version)
     if (version > SCENARIO_LAST_NO_STATIC_RESOURCES) {
         state->resource_version = create_scenario_piece(4, 0);
     }
-    state->graphic_ids = create_scenario_piece(GRID_SIZE_BUF_U16, 0);
-    state->edge = create_scenario_piece(GRID_SIZE_BUF_U8, 0);
-    state->terrain = create_scenario_piece(GRID_SIZE_BUF_U16, 0);
+    int grid_u8_size = version > SCENARIO_LAST_STATIC_GRIDS ? PIECE_SIZE_DYNAMIC : GRID_SIZE_BUF_U8;
+    int grid_u16_size = version > SCENARIO_LAST_STATIC_GRIDS ? PIECE_SIZE_DYNAMIC : GRID_SIZE_BUF_U16;
+    state->graphic_ids = create_scenario_piece(grid_u16_size, 0);
+    state->edge = create_scenario_piece(grid_u8_size, 0);
+    state->terrain = create_scenario_piece(grid_u16_size, 0);
     if (version > SCENARIO_LAST_NO_FORMULAS_AND_MODEL_DATA) {
-        state->bitfields = create_scenario_piece(GRID_SIZE_BUF_U16, 0);
+        state->bitfields = create_scenario_piece(grid_u16_size, 0);
     } else {
-        state->bitfields = create_scenario_piece(GRID_SIZE_BUF_U8, 0);
+        state->bitfields = create_scenario_piece(grid_u8_size, 0);
     }
-    state->random = create_scenario_piece(GRID_SIZE_BUF_U8, 0);
-    state->elevation = create_scenario_piece(GRID_SIZE_BUF_U8, 0);
+    state->random = create_scenario_piece(grid_u8_size, 0);
+    state->elevation = create_scenario_piece(grid_u8_size, 0);
     state->random_iv = create_scenario_piece(8, 0);
     state->camera = create_scenario_piece(8, 0);
 
@@ -439,6 +443,16 @@ static void get_version_data(savegame_version_data *version_data, savegame_versi
     version_data->piece_sizes.building_grid = GRID_SIZE_BUF_U16 * (version > SAVE_GAME_LAST_U16_GRIDS ? 2 : 1);
     version_data->piece_sizes.terrain_grid = GRID_SIZE_BUF_U16 * (version > SAVE_GAME_LAST_ORIGINAL_TERRAIN_DATA_SIZE_VERSION ? 2 : 1);
     version_data->piece_sizes.rubble_grid = GRID_SIZE_BUF_U32;
+    version_data->piece_sizes.grid_u8 = GRID_SIZE_BUF_U8;
+    version_data->piece_sizes.grid_u16 = GRID_SIZE_BUF_U16;
+    if (version > SAVE_GAME_LAST_STATIC_GRIDS) {
+        version_data->piece_sizes.image_grid = PIECE_SIZE_DYNAMIC;
+        version_data->piece_sizes.building_grid = PIECE_SIZE_DYNAMIC;
+        version_data->piece_sizes.terrain_grid = PIECE_SIZE_DYNAMIC;
+        version_data->piece_sizes.rubble_grid = PIECE_SIZE_DYNAMIC;
+        version_data->piece_sizes.grid_u8 = PIECE_SIZE_DYNAMIC;
+        version_data->piece_sizes.grid_u16 = PIECE_SIZE_DYNAMIC;
+    }
     version_data->piece_sizes.figures = 128000 * multiplier;
     version_data->piece_sizes.route_figures = 1200 * multiplier;
     version_data->piece_sizes.route_paths = 300000 * multiplier;
@@ -556,23 +570,23 @@ static void init_savegame_data(savegame_version_t version)
     if (version_data.features.image_grid) {
         state->image_grid = create_savegame_piece(version_data.piece_sizes.image_grid, 1);
     }
-    state->edge_grid = create_savegame_piece(GRID_SIZE_BUF_U8, 1);
+    state->edge_grid = create_savegame_piece(version_data.piece_sizes.grid_u8, 1);
     state->building_grid = create_savegame_piece(version_data.piece_sizes.building_grid, 1);
     state->terrain_grid = create_savegame_piece(version_data.piece_sizes.terrain_grid, 1);
-    state->aqueduct_grid = create_savegame_piece(GRID_SIZE_BUF_U8, 1);
-    state->figure_grid = create_savegame_piece(GRID_SIZE_BUF_U16, 1);
+    state->aqueduct_grid = create_savegame_piece(version_data.piece_sizes.grid_u8, 1);
+    state->figure_grid = create_savegame_piece(version_data.piece_sizes.grid_u16, 1);
     if (version > SAVE_GAME_LAST_NO_FORMULAS_AND_MODEL_DATA) {
-        state->bitfields_grid = create_savegame_piece(GRID_SIZE_BUF_U16, 1);
+        state->bitfields_grid = create_savegame_piece(version_data.piece_sizes.grid_u16, 1);
     } else {
-        state->bitfields_grid = create_savegame_piece(GRID_SIZE_BUF_U8, 1);
-    }
-    state->sprite_grid = create_savegame_piece(GRID_SIZE_BUF_U8, 1);
-    state->random_grid = create_savegame_piece(GRID_SIZE_BUF_U8, 0);
-    state->desirability_grid = create_savegame_piece(GRID_SIZE_BUF_U8, 1);
-    state->elevation_grid = create_savegame_piece(GRID_SIZE_BUF_U8, 1);
-    state->building_damage_grid = create_savegame_piece(GRID_SIZE_BUF_U8, 1);
-    state->aqueduct_backup_grid = create_savegame_piece(GRID_SIZE_BUF_U8, 1);
-    state->sprite_backup_grid = create_savegame_piece(GRID_SIZE_BUF_U8, 1);
+        state->bitfields_grid = create_savegame_piece(version_data.piece_sizes.grid_u8, 1);
+    }
+    state->sprite_grid = create_savegame_piece(version_data.piece_sizes.grid_u8, 1);
+    state->random_grid = create_savegame_piece(version_data.piece_sizes.grid_u8, 0);
+    state->desirability_grid = create_savegame_piece(version_data.piece_sizes.grid_u8, 1);
+    state->elevation_grid = create_savegame_piece(version_data.piece_sizes.grid_u8, 1);
+    state->building_damage_grid = create_savegame_piece(version_data.piece_sizes.grid_u8, 1);
+    state->aqueduct_backup_grid = create_savegame_piece(version_data.piece_sizes.grid_u8, 1);
+    state->sprite_backup_grid = create_savegame_piece(version_data.piece_sizes.grid_u8, 1);
     state->figures = create_savegame_piece(version_data.piece_sizes.figures, 1);
     state->route_figures = create_savegame_piece(version_data.piece_sizes.route_figures, 1);
     state->route_paths = create_savegame_piece(version_data.piece_sizes.route_paths, 1);
@@ -703,7 +717,7 @@ static void init_savegame_data(savegame_version_t version)
         state->visited_buildings = create_savegame_piece(PIECE_SIZE_DYNAMIC, 1);
     }
     if (version_data.features.rubble_grid) {
-        state->rubble_grid = create_savegame_piece(GRID_SIZE_BUF_U32, 1);
+        state->rubble_grid = create_savegame_piece(version_data.piece_sizes.rubble_grid, 1);
     }
     if (version_data.features.custom_production_rates) {
         state->production_rates = create_savegame_piece(PIECE_SIZE_DYNAMIC, 1);
@@ -17,6 +17,7 @@
 #include "game/campaign.h"
 #include "game/file.h"
 #include "game/file_editor.h"
+#include "game/replay.h"
 #include "game/settings.h"
 #include "game/speed.h"
 #include "game/state.h"
@@ -49,6 +50,7 @@ static encoding_type update_encoding(void)
     encoding_type encoding = encoding_determine(language);
     log_info("Detected encoding:", 0, encoding);
     font_set_encoding(encoding);
+    text_reset_layout_cache();
     translation_load(language);
     return encoding;
 }
@@ -202,7 +204,7 @@ void game_run(void)
     game_animation_update();
     int num_ticks = game_speed_get_elapsed_ticks();
     for (int i = 0; i < num_ticks; i++) {
-        game_tick_run();
+        game_replay_run_tick();
         game_file_write_mission_saved_game();
 
         if (window_is_invalid()) {
@@ -0,0 +1,592 @@
+#include "replay.h"
+
+#include "building/building.h"
+#include "building/construction.h"
+#include "building/construction_clear.h"
+#include "building/roadblock.h"
+#include "building/rotation.h"
+#include "building/storage.h"
+#include "city/festival.h"
+#include "city/finance.h"
+#include "city/labor.h"
+#include "city/population.h"
+#include "city/view.h"
+#include "core/buffer.h"
+#include "core/file.h"
+#include "core/io.h"
+#include "core/log.h"
+#include "core/random.h"
+#include "core/time.h"
+#include "figure/figure.h"
+#include "game/cheats.h"
+#include "game/file.h"
+#include "game/system.h"
+#include "game/tick.h"
+#include "game/undo.h"
+#include "map/grid.h"
+#include "window/city.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REPLAY_MAGIC "AURP"
+#define REPLAY_VERSION 2
+#define REPLAY_HEADER_SIZE 6
+
+#define EVENT_HEADER_SIZE 5
+// The command is the largest event
+#define MAX_EVENT_SIZE (EVENT_HEADER_SIZE + 1 + MAX_COMMAND_SIZE)
+#define EVENTS_SIZE_STEP 4096
+
+#define REPLAY_TICKS_PER_FRAME 50
+
+// Far away from any real clock value, so that times remembered before the replay started never match
+#define REPLAY_CLOCK_START ((time_millis) 1 << 40)
+
+typedef enum {
+    REPLAY_EVENT_END = 0,
+    REPLAY_EVENT_CONSTRUCTION = 1,
+    REPLAY_EVENT_COMMAND = 2,
+    REPLAY_EVENT_UNDO = 3,
+    REPLAY_EVENT_ACTION = 4
+} replay_event_type;
+
+typedef enum {
+    REPLAY_IDLE = 0,
+    REPLAY_RECORDING = 1,
+    REPLAY_PLAYING = 2
+} replay_state;
+
+static struct {
+    replay_state state;
+    char filename[FILE_NAME_MAX];
+    uint32_t tick;
+    struct {
+        int x_start;
+        int y_start;
+        int x_end;
+        int y_end;
+    } construction;
+    struct {
+        uint8_t *data;
+        size_t size;
+        size_t capacity;
+    } events;
+    struct {
+        buffer buf;
+        uint32_t next_event_tick;
+        int at_end;
+    } playback;
+    replay_results results;
+    struct {
+        uint64_t total_millis;
+        uint64_t max_tick_millis;
+    } timing;
+} data;
+
+int game_replay_is_recording(void)
+{
+    return data.state == REPLAY_RECORDING;
+}
+
+int game_replay_is_playing(void)
+{
+    return data.state == REPLAY_PLAYING;
+}
+
+static void free_events(void)
+{
+    free(data.events.data);
+    data.events.data = 0;
+    data.events.size = 0;
+    data.events.capacity = 0;
+}
+
+static int ensure_event_capacity(void)
+{
+    if (data.events.size + MAX_EVENT_SIZE > data.events.capacity) {
+        size_t new_capacity = data.events.capacity + EVENTS_SIZE_STEP;
+        uint8_t *events = realloc(data.events.data, new_capacity);
+        if (!events) {
+            log_error("Unable to allocate memory for the replay, recording stopped", 0, 0);
+            free_events();
+            data.state = REPLAY_IDLE;
+            return 0;
+        }
+        data.events.data = events;
+        data.events.capacity = new_capacity;
+    }
+    return 1;
+}
+
+static int begin_event(buffer *buf, replay_event_type type)
+{
+    if (!ensure_event_capacity()) {
+        return 0;
+    }
+    buffer_init(buf, data.events.data + data.events.size, MAX_EVENT_SIZE);
+    buffer_write_u32(buf, data.tick);
+    buffer_write_u8(buf, type);
+    return 1;
+}
+
+static void end_event(buffer *buf)
+{
+    data.events.size += buf->index;
+}
+
+static void get_starting_save_filename(const char *filename, char *save_filename)
+{
+    snprintf(save_filename, FILE_NAME_MAX, "%s", filename);
+    file_change_extension(save_filename, "svx");
+}
+
+int game_replay_start_recording(const char *filename)
+{
+    if (data.state != REPLAY_IDLE || !file_has_extension(filename, "rpl")) {
+        return 0;
+    }
+    char save_filename[FILE_NAME_MAX];
+    get_starting_save_filename(filename, save_filename);
+    if (!game_file_write_saved_game(save_filename)) {
+        log_error("Unable to write the starting saved game of the replay", save_filename, 0);
+        return 0;
+    }
+    snprintf(data.filename, FILE_NAME_MAX, "%s", filename);
+    data.tick = 0;
+    data.events.size = 0;
+    data.state = REPLAY_RECORDING;
+
+    if (!ensure_event_capacity()) {
+        return 0;
+    }
+    buffer buf;
+    buffer_init(&buf, data.events.data, REPLAY_HEADER_SIZE);
+    buffer_write_raw(&buf, REPLAY_MAGIC, 4);
+    buffer_write_u16(&buf, REPLAY_VERSION);
+    end_event(&buf);
+    log_info("Started recording replay", data.filename, 0);
+    return 1;
+}
+
+static uint32_t hash_bytes(uint32_t hash, const uint8_t *bytes, size_t size)
+{
+    // FNV-1a
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t calculate_checksum(void)
+{
+    uint8_t small_data[36];
+    memset(small_data, 0, sizeof(small_data));
+    buffer highest_id, highest_id_ever, building_sequence, corrupt_houses, figure_sequence, random;
+    buffer_init(&highest_id, &small_data[0], 4);
+    buffer_init(&highest_id_ever, &small_data[4], 8);
+    buffer_init(&building_sequence, &small_data[12], 4);
+    buffer_init(&corrupt_houses, &small_data[16], 8);
+    buffer_init(&figure_sequence, &small_data[24], 4);
+    buffer_init(&random, &small_data[28], 8);
+
+    uint32_t hash = 2166136261u;
+    buffer buildings;
+    building_save_state(&buildings, &highest_id, &highest_id_ever, &building_sequence, &corrupt_houses);
+    hash = hash_bytes(hash, buildings.data, buildings.index);
+    free(buildings.data);
+
+    buffer figures;
+    figure_save_state(&figures, &figure_sequence);
+    hash = hash_bytes(hash, figures.data, figures.index);
+    free(figures.data);
+
+    random_save_state(&random);
+    int32_t totals[2] = { city_finance_treasury(), city_population() };
+    hash = hash_bytes(hash, small_data, sizeof(small_data));
+    return hash_bytes(hash, (const uint8_t *) totals, sizeof(totals));
+}
+
+int game_replay_stop_recording(void)
+{
+    if (data.state != REPLAY_RECORDING) {
+        return 0;
+    }
+    buffer buf;
+    if (!begin_event(&buf, REPLAY_EVENT_END)) {
+        return 0;
+    }
+    // Lets the playback check that it ended with the same city
+    buffer_write_u32(&buf, calculate_checksum());
+    end_event(&buf);
+    data.state = REPLAY_IDLE;
+    int written = io_write_buffer_to_file(data.filename, data.events.data, data.events.size) == data.events.size;
+    if (written) {
+        log_info("Replay recorded, ticks:", data.filename, data.tick);
+    } else {
+        log_error("Unable to write replay", data.filename, 0);
+    }
+    free_events();
+    return written;
+}
+
+void game_replay_set_construction_start(int x, int y)
+{
+    data.construction.x_start = data.construction.x_end = x;
+    data.construction.y_start = data.construction.y_end = y;
+}
+
+void game_replay_set_construction_end(int x, int y)
+{
+    data.construction.x_end = x;
+    data.construction.y_end = y;
+}
+
+void game_replay_record_construction(building_type type)
+{
+    buffer buf;
+    if (data.state != REPLAY_RECORDING || !begin_event(&buf, REPLAY_EVENT_CONSTRUCTION)) {
+        return;
+    }
+    buffer_write_u16(&buf, type);
+    buffer_write_i16(&buf, data.construction.x_start);
+    buffer_write_i16(&buf, data.construction.y_start);
+    buffer_write_i16(&buf, data.construction.x_end);
+    buffer_write_i16(&buf, data.construction.y_end);
+    buffer_write_u8(&buf, building_rotation_get_rotation());
+    buffer_write_u8(&buf, building_rotation_get_extra_rotation());
+    buffer_write_u8(&buf, building_rotation_get_road_orientation());
+    buffer_write_u8(&buf, city_view_orientation());
+    end_event(&buf);
+}
+
+void game_replay_record_command(const uint8_t *command)
+{
+    buffer buf;
+    if (data.state != REPLAY_RECORDING || !begin_event(&buf, REPLAY_EVENT_COMMAND)) {
+        return;
+    }
+    size_t length = strlen((const char *) command);
+    if (length >= MAX_COMMAND_SIZE) {
+        length = MAX_COMMAND_SIZE - 1;
+    }
+    buffer_write_u8(&buf, (uint8_t) length);
+    buffer_write_raw(&buf, command, length);
+    end_event(&buf);
+}
+
+void game_replay_record_undo(void)
+{
+    buffer buf;
+    if (data.state != REPLAY_RECORDING || !begin_event(&buf, REPLAY_EVENT_UNDO)) {
+        return;
+    }
+    end_event(&buf);
+}
+
+void game_replay_record_action(replay_action action, int param1, int param2, int param3)
+{
+    buffer buf;
+    if (data.state != REPLAY_RECORDING || !begin_event(&buf, REPLAY_EVENT_ACTION)) {
+        return;
+    }
+    buffer_write_u8(&buf, action);
+    buffer_write_i32(&buf, param1);
+    buffer_write_i32(&buf, param2);
+    buffer_write_i32(&buf, param3);
+    end_event(&buf);
+}
+
+static void run_tick_on_replay_clock(void)
+{
+    // Some of the simulation only does its work once per clock value, so the clock has to follow the ticks
+    time_set_millis(REPLAY_CLOCK_START + data.tick);
+    game_tick_run();
+    data.tick++;
+}
+
+void game_replay_run_tick(void)
+{
+    if (data.state != REPLAY_RECORDING) {
+        game_tick_run();
+        return;
+    }
+    time_millis real_time = time_get_millis();
+    run_tick_on_replay_clock();
+    time_set_millis(real_time);
+}
+
+static int load_events(const char *filename)
+{
+    FILE *fp = file_open(filename, "rb");
+    if (!fp) {
+        return 0;
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size < REPLAY_HEADER_SIZE) {
+        file_close(fp);
+        return 0;
+    }
+    data.events.data = malloc(size);
+    if (!data.events.data) {
+        file_close(fp);
+        return 0;
+    }
+    data.events.size = data.events.capacity = size;
+    size_t read = fread(data.events.data, 1, size, fp);
+    file_close(fp);
+    if (read != (size_t) size || memcmp(data.events.data, REPLAY_MAGIC, 4) != 0) {
+        free_events();
+        return 0;
+    }
+    buffer_init(&data.playback.buf, data.events.data, (int) size);
+    buffer_skip(&data.playback.buf, 4);
+    if (buffer_read_u16(&data.playback.buf) != REPLAY_VERSION) {
+        free_events();
+        return 0;
+    }
+    return 1;
+}
+
+static void read_next_event_tick(void)
+{
+    // A truncated replay simply ends at the last complete event
+    if (data.playback.buf.index + EVENT_HEADER_SIZE > data.playback.buf.size) {
+        data.playback.next_event_tick = data.tick;
+        data.playback.at_end = 1;
+        return;
+    }
+    data.playback.next_event_tick = buffer_read_u32(&data.playback.buf);
+}
+
+int game_replay_start_playback(const char *filename)
+{
+    if (data.state != REPLAY_IDLE) {
+        return 0;
+    }
+    if (!load_events(filename)) {
+        log_error("Unable to read replay", filename, 0);
+        return 0;
+    }
+    char save_filename[FILE_NAME_MAX];
+    get_starting_save_filename(filename, save_filename);
+    if (game_file_load_saved_game(save_filename) != FILE_LOAD_SUCCESS) {
+        log_error("Unable to load the starting saved game of the replay", save_filename, 0);
+        free_events();
+        return 0;
+    }
+    window_city_show();
+
+    snprintf(data.filename, FILE_NAME_MAX, "%s", filename);
+    data.tick = 0;
+    data.timing.total_millis = 0;
+    data.timing.max_tick_millis = 0;
+    data.playback.at_end = 0;
+    memset(&data.results, 0, sizeof(data.results));
+    data.state = REPLAY_PLAYING;
+    read_next_event_tick();
+    log_info("Started playing replay", data.filename, 0);
+    return 1;
+}
+
+static void apply_construction(void)
+{
+    buffer *buf = &data.playback.buf;
+    building_type type = buffer_read_u16(buf);
+    int x_start = buffer_read_i16(buf);
+    int y_start = buffer_read_i16(buf);
+    int x_end = buffer_read_i16(buf);
+    int y_end = buffer_read_i16(buf);
+    int rotation = buffer_read_u8(buf);
+    int extra_rotation = buffer_read_u8(buf);
+    int road_orientation = buffer_read_u8(buf);
+    int view_orientation = buffer_read_u8(buf);
+
+    for (int i = 0; i < 4 && city_view_orientation() != view_orientation; i++) {
+        city_view_rotate_left();
+    }
+    building_construction_set_type(type, 0);
+    building_rotation_set_state(rotation, extra_rotation, road_orientation);
+    building_construction_start(x_start, y_start, map_grid_offset(x_start, y_start));
+    building_construction_update(x_end, y_end, map_grid_offset(x_end, y_end));
+    building_construction_place();
+    building_construction_clear_type();
+}
+
+static void apply_command(void)
+{
+    uint8_t command[MAX_COMMAND_SIZE];
+    size_t length = buffer_read_u8(&data.playback.buf);
+    if (length >= MAX_COMMAND_SIZE) {
+        length = MAX_COMMAND_SIZE - 1;
+    }
+    length = buffer_read_raw(&data.playback.buf, command, length);
+    command[length] = 0;
+    game_cheat_parse_command(command);
+}
+
+static void apply_action(void)
+{
+    buffer *buf = &data.playback.buf;
+    replay_action action = buffer_read_u8(buf);
+    int param1 = buffer_read_i32(buf);
+    int param2 = buffer_read_i32(buf);
+    int param3 = buffer_read_i32(buf);
+    if (buf->overflow) {
+        return;
+    }
+    switch (action) {
+        case REPLAY_ACTION_TAX_CHANGE:
+            city_finance_change_tax_percentage(param1);
+            break;
+        case REPLAY_ACTION_WAGES_CHANGE:
+            city_labor_change_wages(param1);
+            break;
+        case REPLAY_ACTION_LABOR_PRIORITY:
+            city_labor_set_priority(param1, param2);
+            break;
+        case REPLAY_ACTION_FESTIVAL:
+            city_festival_select_god(param1);
+            city_festival_select_size(param2);
+            city_festival_schedule();
+            break;
+        case REPLAY_ACTION_STORAGE_RESOURCE_STATE:
+            building_storage_cycle_resource_state(param1, param2, param3);
+            break;
+        case REPLAY_ACTION_STORAGE_PARTIAL_RESOURCE_STATE:
+            building_storage_cycle_partial_resource_state(param1, param2, param3);
+            break;
+        case REPLAY_ACTION_STORAGE_ACCEPT_ALL:
+            building_storage_accept_all(param1);
+            break;
+        case REPLAY_ACTION_STORAGE_ACCEPT_NONE:
+            building_storage_accept_none(param1);
+            break;
+        case REPLAY_ACTION_STORAGE_EMPTY_ALL:
+            building_storage_toggle_empty_all(param1);
+            break;
+        case REPLAY_ACTION_STORAGE_TOGGLE_PERMISSION:
+            building_storage_toggle_permission(param1, building_get(param2));
+            break;
+        case REPLAY_ACTION_STORAGE_SET_PERMISSION:
+            building_storage_set_permission(param1, building_get(param2), param3);
+            break;
+        case REPLAY_ACTION_ROADBLOCK_PERMISSION:
+            building_roadblock_set_permission(param1, building_get(param2));
+            break;
+        case REPLAY_ACTION_ROADBLOCK_ACCEPT_ALL:
+            building_roadblock_accept_all(building_get(param1));
+            break;
+        case REPLAY_ACTION_ROADBLOCK_ACCEPT_NONE:
+            building_roadblock_accept_none(building_get(param1));
+            break;
+        case REPLAY_ACTION_MOTHBALL:
+            building_mothball_toggle(building_get(param1));
+            break;
+        case REPLAY_ACTION_CLEAR_CONFIRMATION:
+            building_construction_clear_confirm(param1);
+            break;
+        default:
+            log_error("Unknown replay action", 0, action);
+            break;
+    }
+}
+
+static void read_recorded_checksum(void)
+{
+    uint32_t checksum = buffer_read_u32(&data.playback.buf);
+    if (!data.playback.buf.overflow) {
+        data.results.recorded_checksum = checksum;
+        data.results.has_recorded_checksum = 1;
+    }
+}
+
+static void finish_playback(void)
+{
+    data.results.ticks = data.tick;
+    data.results.checksum = calculate_checksum();
+
+    char result[200];
+    uint64_t millis = data.timing.total_millis ? data.timing.total_millis : 1;
+    snprintf(result, sizeof(result), "ticks: %u, ticks/sec: %.1f, max tick: %u ms, checksum: %08x",
+        (unsigned int) data.tick, data.tick * 1000.0 / millis, (unsigned int) data.timing.max_tick_millis,
+        (unsigned int) data.results.checksum);
+    log_info("Replay finished", result, 0);
+    if (!data.results.has_recorded_checksum) {
+        log_info("The replay has no recorded checksum, it was cut short", 0, 0);
+    } else if (data.results.recorded_checksum != data.results.checksum) {
+        snprintf(result, sizeof(result), "recorded: %08x, played back: %08x",
+            (unsigned int) data.results.recorded_checksum, (unsigned int) data.results.checksum);
+        log_error("The replay diverged from the recording", result, 0);
+    }
+
+    data.state = REPLAY_IDLE;
+    free_events();
+}
+
+const replay_results *game_replay_get_results(void)
+{
+    return &data.results;
+}
+
+static int apply_due_events(void)
+{
+    while (data.playback.next_event_tick <= data.tick) {
+        if (data.playback.at_end) {
+            return 0;
+        }
+        switch (buffer_read_u8(&data.playback.buf)) {
+            case REPLAY_EVENT_CONSTRUCTION:
+                apply_construction();
+                break;
+            case REPLAY_EVENT_COMMAND:
+                apply_command();
+                break;
+            case REPLAY_EVENT_UNDO:
+                game_undo_perform();
+                break;
+            case REPLAY_EVENT_ACTION:
+                apply_action();
+                break;
+            case REPLAY_EVENT_END:
+                read_recorded_checksum();
+                return 0;
+            default:
+                return 0;
+        }
+        if (data.playback.buf.overflow) {
+            return 0;
+        }
+        read_next_event_tick();
+    }
+    return 1;
+}
+
+void game_replay_run_ticks(void)
+{
+    if (data.state != REPLAY_PLAYING) {
+        return;
+    }
+    time_millis real_time = time_get_millis();
+    uint64_t frame_start = system_get_ticks();
+    for (int i = 0; i < REPLAY_TICKS_PER_FRAME; i++) {
+        if (!apply_due_events()) {
+            data.timing.total_millis += system_get_ticks() - frame_start;
+            time_set_millis(real_time);
+            finish_playback();
+            return;
+        }
+        uint64_t tick_start = system_get_ticks();
+        run_tick_on_replay_clock();
+        uint64_t tick_millis = system_get_ticks() - tick_start;
+        if (tick_millis > data.timing.max_tick_millis) {
+            data.timing.max_tick_millis = tick_millis;
+        }
+    }
+    data.timing.total_millis += system_get_ticks() - frame_start;
+    time_set_millis(real_time);
+}
@@ -0,0 +1,115 @@
+#ifndef GAME_REPLAY_H
+#define GAME_REPLAY_H
+
+#include "building/type.h"
+
+#include <stdint.h>
+
+typedef enum {
+    REPLAY_ACTION_TAX_CHANGE = 0,
+    REPLAY_ACTION_WAGES_CHANGE = 1,
+    REPLAY_ACTION_LABOR_PRIORITY = 2,
+    REPLAY_ACTION_FESTIVAL = 3,
+    REPLAY_ACTION_STORAGE_RESOURCE_STATE = 4,
+    REPLAY_ACTION_STORAGE_PARTIAL_RESOURCE_STATE = 5,
+    REPLAY_ACTION_STORAGE_ACCEPT_ALL = 6,
+    REPLAY_ACTION_STORAGE_ACCEPT_NONE = 7,
+    REPLAY_ACTION_STORAGE_EMPTY_ALL = 8,
+    REPLAY_ACTION_STORAGE_TOGGLE_PERMISSION = 9,
+    REPLAY_ACTION_STORAGE_SET_PERMISSION = 10,
+    REPLAY_ACTION_ROADBLOCK_PERMISSION = 11,
+    REPLAY_ACTION_ROADBLOCK_ACCEPT_ALL = 12,
+    REPLAY_ACTION_ROADBLOCK_ACCEPT_NONE = 13,
+    REPLAY_ACTION_MOTHBALL = 14,
+    REPLAY_ACTION_CLEAR_CONFIRMATION = 15
+} replay_action;
+
+typedef struct {
+    uint32_t ticks;
+    uint32_t checksum;
+    uint32_t recorded_checksum;
+    int has_recorded_checksum;
+} replay_results;
+
+/**
+ * @file
+ * Records the player inputs that change the simulation, stamped with the game tick they happened before,
+ * and plays them back as fast as possible to benchmark the simulation.
+ *
+ * The replay also stores a checksum of the city when recording stopped. Inputs that are not recorded
+ * make the playback end with a different checksum, which is reported as a divergence.
+ *
+ * While recording or playing back, every tick sees a clock that only depends on the tick number,
+ * so the parts of the simulation that check the current time behave the same way on each run.
+ *
+ * A replay named "name" is stored as "name.rpl" next to the starting saved game "name.svx".
+ */
+
+/**
+ * Saves the current city as the starting saved game and starts recording
+ * @param filename Full path to the replay file, must have the .rpl extension
+ * @return 1 if recording started, 0 otherwise
+ */
+int game_replay_start_recording(const char *filename);
+
+/**
+ * Stops recording and writes the replay file
+ * @return 1 if the replay file was written, 0 otherwise
+ */
+int game_replay_stop_recording(void);
+
+/**
+ * Loads the starting saved game of the replay and starts playing it back
+ * @param filename Full path to the replay file
+ * @return 1 if the playback started, 0 otherwise
+ */
+int game_replay_start_playback(const char *filename);
+
+int game_replay_is_recording(void);
+
+int game_replay_is_playing(void);
+
+/**
+ * Runs the next batch of ticks of the replay being played back, applying the recorded inputs as they become due.
+ * Logs the results and stops the playback once the replay is over.
+ */
+void game_replay_run_ticks(void);
+
+/**
+ * Gets the results of the last replay that was played back to the end
+ * @return The number of ticks run, the checksum of the city at the end of the playback
+ *         and the checksum stored by the recording, if any
+ */
+const replay_results *game_replay_get_results(void);
+
+/**
+ * Runs a single game tick, advancing the recording clock if a replay is being recorded
+ */
+void game_replay_run_tick(void);
+
+/**
+ * Remembers the tile a construction was started on, before any adjustment by the construction code
+ */
+void game_replay_set_construction_start(int x, int y);
+
+/**
+ * Remembers the tile a construction was dragged to, before any adjustment by the construction code
+ */
+void game_replay_set_construction_end(int x, int y);
+
+void game_replay_record_construction(building_type type);
+
+void game_replay_record_command(const uint8_t *command);
+
+void game_replay_record_undo(void);
+
+/**
+ * Records a player action from an advisor, a building window or a confirmation dialog
+ * @param action The action
+ * @param param1 First parameter, as passed to the function that performs the action
+ * @param param2 Second parameter
+ * @param param3 Third parameter
+ */
+void game_replay_record_action(replay_action action, int param1, int param2, int param3);
+
+#endif // GAME_REPLAY_H
@@ -44,7 +44,7 @@ If you are unsure about anything regarding the savegame versioning, please ask o
 
 typedef enum {
 
-    SAVE_GAME_CURRENT_VERSION = 0xab,
+    SAVE_GAME_CURRENT_VERSION = 0xac,
 
     SAVE_GAME_LAST_ORIGINAL_LIMITS_VERSION = 0x66,
     SAVE_GAME_LAST_SMALLER_IMAGE_ID_VERSION = 0x76,
@@ -96,10 +96,11 @@ typedef enum {
     SAVE_GAME_LAST_U16_GRIDS = 0xa8,
     SAVE_GAME_LAST_NO_FORMULAS_AND_MODEL_DATA = 0xa9,
     SAVE_GAME_LAST_STATIC_PATHS_AND_ROUTES = 0xaa,
+    SAVE_GAME_LAST_STATIC_GRIDS = 0xab,
 } savegame_version_t;
 
 typedef enum {
-    SCENARIO_CURRENT_VERSION = 20,
+    SCENARIO_CURRENT_VERSION = 21,
 
     SCENARIO_VERSION_NONE = 0,
     SCENARIO_LAST_UNVERSIONED = 1,
@@ -121,6 +122,7 @@ typedef enum {
     SCENARIO_LAST_NO_EXTRA_NATIVE_BUILDINGS = 17,
     SCENARIO_LAST_NO_VISIBLE_CUSTOM_VARIABLES = 18,
     SCENARIO_LAST_NO_FORMULAS_AND_MODEL_DATA = 19,
+    SCENARIO_LAST_STATIC_GRIDS = 20,
 } scenario_version_t;
 
 typedef enum {
@@ -97,9 +97,7 @@ static void advance_month(void)
     building_trim();
 
     building_connectable_update_connections();
-    map_tiles_update_all_roads();
-    map_tiles_update_all_highways();
-    map_tiles_update_all_water();
+    map_tiles_update_changed_roads_and_water();
     map_routing_update_land_citizen();
     city_message_sort_and_compact();
 
@@ -15,6 +15,7 @@
 #include "core/calc.h"
 #include "core/image.h"
 #include "figure/roamer_preview.h"
+#include "game/replay.h"
 #include "game/resource.h"
 #include "graphics/window.h"
 #include "map/aqueduct.h"
@@ -146,7 +147,7 @@ void game_undo_restore_building_state(void)
         if (data.buildings[i].id) {
             building *b = building_get(data.buildings[i].id);
             if (b->state == BUILDING_STATE_DELETED_BY_PLAYER) {
-                b->state = BUILDING_STATE_IN_USE;
+                building_set_state(b, BUILDING_STATE_IN_USE);
             }
             b->is_deleted = 0;
         }
@@ -205,7 +206,7 @@ static void add_building_to_terrain(building *b)
             b->data.industry.fishing_boat_id = 0;
         }
     }
-    b->state = BUILDING_STATE_IN_USE;
+    building_set_state(b, BUILDING_STATE_IN_USE);
 }
 
 void game_undo_perform(void)
@@ -213,6 +214,7 @@ void game_undo_perform(void)
     if (!game_can_undo()) {
         return;
     }
+    game_replay_record_undo();
     data.available = 0;
     city_finance_process_construction(-data.building_cost);
     if (data.type == BUILDING_CLEAR_LAND) {
@@ -273,7 +275,7 @@ void game_undo_perform(void)
         }
         for (int i = 0; i < data.num_buildings; i++) {
             if (data.buildings[i].id) {
-                building_get(data.buildings[i].id)->state = BUILDING_STATE_UNDO;
+                building_set_state(building_get(data.buildings[i].id), BUILDING_STATE_UNDO);
             }
         }
         building_update_state();
@@ -58,6 +58,9 @@ typedef struct {
         float scale_x, float scale_y, double angle, int disable_coord_scaling);
     void (*draw_silhouette)(const image *img, int x, int y, color_t color, float scale);
 
+    void (*start_image_batch)(void);
+    void (*finish_image_batch)(void);
+
     void (*create_custom_image)(custom_image_type type, int width, int height, int is_yuv);
     int (*has_custom_image)(custom_image_type type);
     color_t *(*get_custom_image_buffer)(custom_image_type type, int *actual_texture_width);
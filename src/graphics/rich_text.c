@@ -12,6 +12,7 @@
 #include "graphics/image.h"
 #include "graphics/image_button.h"
 #include "graphics/panel.h"
+#include "graphics/renderer.h"
 #include "graphics/scrollbar.h"
 #include "graphics/window.h"
 
@@ -203,6 +204,9 @@ static void draw_line(const uint8_t *str, const font_definition *font, int x, in
     int start_link = 0;
     int num_link_chars = 0;
     const font_definition *def = font;
+    if (!measure_only) {
+        graphics_renderer()->start_image_batch();
+    }
     while (*str) {
         if (*str == '@') {
             int message_id = string_to_int(++str);
@@ -240,6 +244,9 @@ static void draw_line(const uint8_t *str, const font_definition *font, int x, in
             str++;
         }
     }
+    if (!measure_only) {
+        graphics_renderer()->finish_image_batch();
+    }
 }
 
 static int get_raw_text_width(const uint8_t *str)
@@ -289,8 +289,8 @@ static void create_full_city_screenshot(void)
     int draw_cloud_shadows = config_get(CONFIG_UI_DRAW_CLOUD_SHADOWS);
     config_set(CONFIG_UI_DRAW_CLOUD_SHADOWS, 0);
 
-    int min_width = (GRID_SIZE * TILE_X_SIZE - city_width_pixels) / 2 + TILE_X_SIZE;
-    int max_height = (GRID_SIZE * TILE_Y_SIZE + city_height_pixels) / 2;
+    int min_width = (map_grid_stride() * TILE_X_SIZE - city_width_pixels) / 2 + TILE_X_SIZE;
+    int max_height = (map_grid_stride() * TILE_Y_SIZE + city_height_pixels) / 2;
     int min_height = max_height - city_height_pixels - TILE_Y_SIZE;
     map_tile dummy_tile = { 0, 0, 0 };
     int error = 0;
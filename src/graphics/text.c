@@ -7,11 +7,14 @@
 #include "core/time.h"
 #include "graphics/graphics.h"
 #include "graphics/image.h"
+#include "graphics/renderer.h"
 
 #include <string.h>
 
 #define ELLIPSIS_LENGTH 4
 #define NUMBER_BUFFER_LENGTH 100
+#define LAYOUT_CACHE_SIZE 32
+#define MAX_LAYOUT_LINES 100
 
 static uint8_t tmp_line[200];
 
@@ -34,6 +37,36 @@ static struct {
     int width[FONT_TYPES_MAX];
 } ellipsis = { {'.', '.', '.', 0} };
 
+typedef enum {
+    LAYOUT_NONE = 0,
+    LAYOUT_DRAW = 1,
+    LAYOUT_MEASURE = 2
+} layout_type;
+
+typedef struct {
+    unsigned int start;
+    unsigned int length;
+    int width;
+} layout_line;
+
+typedef struct {
+    layout_type type;
+    const uint8_t *str;
+    uint32_t hash;
+    unsigned int length;
+    font_t font;
+    int box_width;
+    unsigned int last_used;
+    int num_lines;
+    int largest_width;
+    layout_line lines[MAX_LAYOUT_LINES];
+} text_layout;
+
+static struct {
+    text_layout items[LAYOUT_CACHE_SIZE];
+    unsigned int current_use;
+} layout_cache;
+
 static int get_ellipsis_width(font_t font)
 {
     if (!ellipsis.width[font]) {
@@ -336,6 +369,7 @@ int text_draw_scaled(const uint8_t *str, int x, int y, font_t font, color_t colo
     }
 
     int current_x = x;
+    graphics_renderer()->start_image_batch();
     while (length > 0) {
         int num_bytes = 1;
 
@@ -368,6 +402,7 @@ int text_draw_scaled(const uint8_t *str, int x, int y, font_t font, color_t colo
         length -= num_bytes;
         input_cursor.position += num_bytes;
     }
+    graphics_renderer()->finish_image_batch();
     if (input_cursor.capture && !input_cursor.seen) {
         input_cursor.width = 4;
         input_cursor.x_offset = current_x - x;
@@ -403,6 +438,7 @@ int text_draw_number_scaled(int value, char prefix, const uint8_t *postfix,
     const font_definition *def = font_definition_for(font);
     int current_x = x;
 
+    graphics_renderer()->start_image_batch();
     if (prefix) {
         uint8_t prefix_str[2] = { prefix, 0 };
         current_x += text_draw_scaled(prefix_str, current_x, y, font, color, scale) - def->space_width;
@@ -441,6 +477,7 @@ int text_draw_number_scaled(int value, char prefix, const uint8_t *postfix,
     } else {
         current_x += def->space_width;
     }
+    graphics_renderer()->finish_image_batch();
 
     return current_x - x;
 }
@@ -464,6 +501,7 @@ void text_draw_number_finances(int value, int x, int y, font_t font, color_t col
 
     int separator_pixels = config_get(CONFIG_UI_DIGIT_SEPARATOR) * 4;
 
+    graphics_renderer()->start_image_batch();
     while (length > 0) {
         int num_bytes = 1;
 
@@ -484,6 +522,7 @@ void text_draw_number_finances(int value, int x, int y, font_t font, color_t col
         length--;
         inverted_length++;
     }
+    graphics_renderer()->finish_image_batch();
 }
 
 int text_draw_money(int value, int x_offset, int y_offset, font_t font)
@@ -577,26 +616,65 @@ void text_draw_number_centered_colored(
     text_draw_centered(str, x_offset, y_offset, box_width, font, color);
 }
 
-int text_draw_multiline(const uint8_t *str, int x_offset, int y_offset, int box_width,
-    int centered, font_t font, color_t color)
+static uint32_t hash_string(const uint8_t *str, unsigned int *length)
 {
-    int line_height = font_definition_for(font)->line_height;
-    if (line_height < 11) {
-        line_height = 11;
+    uint32_t hash = 2166136261u;
+    const uint8_t *start = str;
+    while (*str) {
+        hash = (hash ^ *str++) * 16777619u;
+    }
+    *length = (unsigned int) (str - start);
+    return hash;
+}
+
+static text_layout *find_layout(layout_type type, const uint8_t *str, int box_width, font_t font, int *found)
+{
+    unsigned int length;
+    uint32_t hash = hash_string(str, &length);
+    text_layout *oldest = &layout_cache.items[0];
+    layout_cache.current_use++;
+    for (int i = 0; i < LAYOUT_CACHE_SIZE; i++) {
+        text_layout *layout = &layout_cache.items[i];
+        if (layout->type == type && layout->str == str && layout->hash == hash && layout->length == length &&
+            layout->font == font && layout->box_width == box_width) {
+            layout->last_used = layout_cache.current_use;
+            *found = 1;
+            return layout;
+        }
+        if (layout->last_used < oldest->last_used) {
+            oldest = layout;
+        }
     }
+    oldest->type = type;
+    oldest->str = str;
+    oldest->hash = hash;
+    oldest->length = length;
+    oldest->font = font;
+    oldest->box_width = box_width;
+    oldest->last_used = layout_cache.current_use;
+    *found = 0;
+    return oldest;
+}
+
+void text_reset_layout_cache(void)
+{
+    memset(&layout_cache, 0, sizeof(layout_cache));
+}
+
+static void layout_multiline(const uint8_t *str, int box_width, font_t font, text_layout *layout)
+{
+    const uint8_t *text_start = str;
     int has_more_characters = 1;
     int guard = 0;
-    int y = y_offset;
+    layout->num_lines = 0;
     while (has_more_characters) {
-        if (++guard >= 100) {
+        if (++guard >= MAX_LAYOUT_LINES) {
             break;
         }
-        // clear line
-        for (int i = 0; i < 200; i++) {
-            tmp_line[i] = 0;
-        }
+        layout_line *line = &layout->lines[layout->num_lines++];
+        line->start = (unsigned int) (str - text_start);
+        line->length = 0;
         int current_width = 0;
-        int line_index = 0;
         while (has_more_characters) {
             int word_num_chars;
             int word_width = get_word_width(str, font, &word_num_chars, 0);
@@ -612,10 +690,12 @@ int text_draw_multiline(const uint8_t *str, int x_offset, int y_offset, int box_
             }
             current_width += word_width;
             for (int i = 0; i < word_num_chars; i++) {
-                if (line_index == 0 && *str <= ' ') {
+                if (line->length == 0 && *str <= ' ') {
                     str++; // skip whitespace at start of line
+                    line->start++;
                 } else {
-                    tmp_line[line_index++] = *str++;
+                    line->length++;
+                    str++;
                 }
             }
             if (!*str) {
@@ -625,17 +705,39 @@ int text_draw_multiline(const uint8_t *str, int x_offset, int y_offset, int box_
                 break;
             }
         }
-        int line_offset = centered ? (box_width - current_width) / 2 : 0;
+        line->width = current_width;
+    }
+}
+
+int text_draw_multiline(const uint8_t *str, int x_offset, int y_offset, int box_width,
+    int centered, font_t font, color_t color)
+{
+    int line_height = font_definition_for(font)->line_height;
+    if (line_height < 11) {
+        line_height = 11;
+    }
+    int found;
+    text_layout *layout = find_layout(LAYOUT_DRAW, str, box_width, font, &found);
+    if (!found) {
+        layout_multiline(str, box_width, font, layout);
+    }
+    int y = y_offset;
+    for (int i = 0; i < layout->num_lines; i++) {
+        const layout_line *line = &layout->lines[i];
+        unsigned int length = line->length < sizeof(tmp_line) ? line->length : sizeof(tmp_line) - 1;
+        memcpy(tmp_line, str + line->start, length);
+        tmp_line[length] = 0;
+        int line_offset = centered ? (box_width - line->width) / 2 : 0;
         text_draw(tmp_line, x_offset + line_offset, y, font, color);
         y += line_height + 5;
     }
     return y - y_offset;
 }
 
-int text_measure_multiline(const uint8_t *str, int box_width, font_t font, int *largest_width)
+static void measure_multiline(const uint8_t *str, int box_width, font_t font, text_layout *layout)
 {
     // \n is not counted as a word and is only caught it directly after a word: "word \n" won't work correctly
-    *largest_width = 0;
+    layout->largest_width = 0;
     int has_more_characters = 1;
     int guard = 0;
     int num_lines = 0;
@@ -669,12 +771,23 @@ int text_measure_multiline(const uint8_t *str, int box_width, font_t font, int *
                 }
             }
         }
-        if (current_width > *largest_width) {
-            *largest_width = current_width;
+        if (current_width > layout->largest_width) {
+            layout->largest_width = current_width;
         }
         num_lines += 1;
     }
-    return num_lines;
+    layout->num_lines = num_lines;
+}
+
+int text_measure_multiline(const uint8_t *str, int box_width, font_t font, int *largest_width)
+{
+    int found;
+    text_layout *layout = find_layout(LAYOUT_MEASURE, str, box_width, font, &found);
+    if (!found) {
+        measure_multiline(str, box_width, font, layout);
+    }
+    *largest_width = layout->largest_width;
+    return layout->num_lines;
 }
 
 void text_draw_build_menu_with_index(const uint8_t *str, int index, int x_offset, int y_offset, int box_width, font_t font, color_t color)
@@ -4,6 +4,7 @@
 #include "core/dir.h"
 #include "core/file.h"
 #include "core/smacker.h"
+#include "core/thread.h"
 #include "core/time.h"
 #include "game/campaign.h"
 #include "game/system.h"
@@ -16,9 +17,12 @@
 #include "easyav1.h"
 #include "pl_mpeg/pl_mpeg.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 #define MAX_FRAME_TIME_ADVANCE_MS (1.0 / 30.0)
+#define VIDEO_QUEUE_SIZE 4
+#define DECODER_WAIT_MS 5
 
 typedef enum {
     VIDEO_TYPE_NONE = 0,
@@ -27,6 +31,23 @@ typedef enum {
     VIDEO_TYPE_AV1 = 3
 } video_type;
 
+typedef enum {
+    DECODE_NO_FRAME = 0,
+    DECODE_FRAME = 1,
+    DECODE_END = 2
+} decode_result;
+
+typedef struct {
+    uint8_t *data;
+    int stride;
+    int size;
+} video_plane;
+
+typedef struct {
+    color_t *pixels;
+    video_plane planes[3];
+} queued_frame;
+
 static struct {
     int is_playing;
     int is_ended;
@@ -58,10 +79,26 @@ static struct {
         int width;
     } buffer;
     int restart_music;
+    struct {
+        thread_handle *thread;
+        thread_mutex *lock;
+        thread_condition *has_room;
+        queued_frame frames[VIDEO_QUEUE_SIZE];
+        int first;
+        int count;
+        int stop;
+        int finished;
+        int is_yuv;
+        queued_frame *mpg_target;
+        int mpg_has_frame;
+    } decoder;
 } data;
 
+static void stop_decoder(void);
+
 static void close_decoder(void)
 {
+    stop_decoder();
     if (data.s) {
         smacker_close(data.s);
         data.s = 0;
@@ -91,6 +128,53 @@ static void update_mpg_audio(plm_t *mpeg, plm_samples_t *samples, void *user)
     sound_device_write_custom_music_data(samples->interleaved, sizeof(float) * samples->count * 2);
 }
 
+static void write_smk_frame_audio(void)
+{
+    if (data.audio.has_audio) {
+        int audio_len = smacker_get_frame_audio_size(data.s, 0);
+        const void *audio_data = smacker_get_frame_audio(data.s, 0);
+        if (audio_len > 0) {
+            sound_device_write_custom_music_data(audio_data, audio_len);
+        }
+    }
+}
+
+static void write_av1_audio(void)
+{
+    if (data.audio.has_audio) {
+        const easyav1_audio_frame *audio_frame = easyav1_get_audio_frame(data.easyav1);
+        if (audio_frame) {
+            sound_device_write_custom_music_data(audio_frame->pcm.interlaced, (int) audio_frame->bytes);
+        }
+    }
+}
+
+static void draw_smk_frame(color_t *pixels, int stride)
+{
+    const unsigned char *frame = smacker_get_frame_video(data.s);
+    const uint32_t *pal = smacker_get_frame_palette(data.s);
+    if (!frame || !pal) {
+        return;
+    }
+    color_t colors[256];
+    for (int i = 0; i < 256; i++) {
+        colors[i] = ALPHA_OPAQUE | pal[i];
+    }
+    for (int y = 0; y < data.video.height; y++) {
+        color_t *pixel = &pixels[y * stride];
+        if (data.video.y_scale != SMACKER_Y_SCALE_NONE && (y & 1)) {
+            // Scaled videos show every source line twice, so the line above can be copied
+            memcpy(pixel, pixel - stride, data.video.width * sizeof(color_t));
+            continue;
+        }
+        int video_y = data.video.y_scale == SMACKER_Y_SCALE_NONE ? y : y / 2;
+        const unsigned char *line = frame + (video_y * data.video.width);
+        for (int x = 0; x < data.video.width; x++) {
+            pixel[x] = colors[line[x]];
+        }
+    }
+}
+
 static int load_av1(const char *filename)
 {
     if (data.type == VIDEO_TYPE_SMK || data.type == VIDEO_TYPE_MPG) {
@@ -283,6 +367,227 @@ static int load_smk(const char *filename)
     return 1;
 }
 
+static int copy_plane(video_plane *plane, const void *source, int stride, int rows)
+{
+    int size = stride * rows;
+    if (plane->size < size) {
+        uint8_t *plane_data = realloc(plane->data, size);
+        if (!plane_data) {
+            return 0;
+        }
+        plane->data = plane_data;
+        plane->size = size;
+    }
+    memcpy(plane->data, source, size);
+    plane->stride = stride;
+    return 1;
+}
+
+static void queue_mpg_video(plm_t *plm, plm_frame_t *frame, void *user)
+{
+    queued_frame *target = data.decoder.mpg_target;
+    if (!target) {
+        return;
+    }
+    if (data.decoder.is_yuv) {
+        if (!copy_plane(&target->planes[0], frame->y.data, frame->y.width, frame->y.height) ||
+            !copy_plane(&target->planes[1], frame->cb.data, frame->cb.width, frame->cb.height) ||
+            !copy_plane(&target->planes[2], frame->cr.data, frame->cr.width, frame->cr.height)) {
+            return;
+        }
+    } else {
+        plm_frame_to_bgra(frame, (uint8_t *) target->pixels, data.video.width * sizeof(color_t));
+    }
+    data.decoder.mpg_has_frame = 1;
+}
+
+static decode_result decode_frame(queued_frame *frame)
+{
+    if (data.type == VIDEO_TYPE_SMK) {
+        if (!frame) {
+            return DECODE_NO_FRAME;
+        }
+        if (smacker_next_frame(data.s) != SMACKER_FRAME_OK) {
+            return DECODE_END;
+        }
+        write_smk_frame_audio();
+        draw_smk_frame(frame->pixels, data.video.width);
+        return DECODE_FRAME;
+    } else if (data.type == VIDEO_TYPE_MPG) {
+        if (!frame) {
+            return DECODE_NO_FRAME;
+        }
+        data.decoder.mpg_target = frame;
+        data.decoder.mpg_has_frame = 0;
+        while (!data.decoder.mpg_has_frame && !plm_has_ended(data.plm)) {
+            plm_decode(data.plm, data.video.micros_per_frame / 1000000.0);
+        }
+        data.decoder.mpg_target = 0;
+        return data.decoder.mpg_has_frame ? DECODE_FRAME : DECODE_END;
+    } else if (data.type == VIDEO_TYPE_AV1) {
+        // AV1 keeps its own clock: audio and frames become available as it advances
+        write_av1_audio();
+        if (frame && data.decoder.is_yuv && easyav1_has_video_frame(data.easyav1)) {
+            const easyav1_video_frame *video_frame = easyav1_get_video_frame(data.easyav1);
+            int chroma_rows = (data.video.height + 1) / 2;
+            if (video_frame &&
+                copy_plane(&frame->planes[0], video_frame->data[0], (int) video_frame->stride[0], data.video.height) &&
+                copy_plane(&frame->planes[1], video_frame->data[1], (int) video_frame->stride[1], chroma_rows) &&
+                copy_plane(&frame->planes[2], video_frame->data[2], (int) video_frame->stride[2], chroma_rows)) {
+                return DECODE_FRAME;
+            }
+        }
+        return easyav1_is_finished(data.easyav1) ? DECODE_END : DECODE_NO_FRAME;
+    }
+    return DECODE_END;
+}
+
+static int run_decoder(void *userdata)
+{
+    thread_mutex_lock(data.decoder.lock);
+    while (!data.decoder.stop) {
+        queued_frame *frame = 0;
+        if (data.decoder.count < VIDEO_QUEUE_SIZE) {
+            frame = &data.decoder.frames[(data.decoder.first + data.decoder.count) % VIDEO_QUEUE_SIZE];
+        }
+        // The render thread only reads queued frames, so the free slot can be filled without the lock
+        thread_mutex_unlock(data.decoder.lock);
+        decode_result result = decode_frame(frame);
+        thread_mutex_lock(data.decoder.lock);
+        if (result == DECODE_FRAME) {
+            data.decoder.count++;
+        } else if (result == DECODE_END) {
+            data.decoder.finished = 1;
+            break;
+        } else if (!data.decoder.stop) {
+            thread_condition_wait_timeout(data.decoder.has_room, data.decoder.lock, DECODER_WAIT_MS);
+        }
+    }
+    thread_mutex_unlock(data.decoder.lock);
+    return 0;
+}
+
+static void free_queued_frames(void)
+{
+    for (int i = 0; i < VIDEO_QUEUE_SIZE; i++) {
+        queued_frame *frame = &data.decoder.frames[i];
+        free(frame->pixels);
+        for (int j = 0; j < 3; j++) {
+            free(frame->planes[j].data);
+        }
+        memset(frame, 0, sizeof(queued_frame));
+    }
+}
+
+static void start_decoder(void)
+{
+    if (!data.decoder.lock) {
+        data.decoder.lock = thread_mutex_create();
+        data.decoder.has_room = thread_condition_create();
+    }
+    if (!data.decoder.lock || !data.decoder.has_room) {
+        return;
+    }
+    if (!data.decoder.is_yuv) {
+        for (int i = 0; i < VIDEO_QUEUE_SIZE; i++) {
+            data.decoder.frames[i].pixels = malloc(sizeof(color_t) * data.video.width * data.video.height);
+            if (!data.decoder.frames[i].pixels) {
+                free_queued_frames();
+                return;
+            }
+        }
+    }
+    data.decoder.first = 0;
+    data.decoder.count = 0;
+    data.decoder.stop = 0;
+    data.decoder.finished = 0;
+    if (data.type == VIDEO_TYPE_SMK) {
+        // load_smk already decoded the first frame and video_init passed on its audio,
+        // so it is queued as is and the worker starts with the next one
+        draw_smk_frame(data.decoder.frames[0].pixels, data.video.width);
+        data.decoder.count = 1;
+    } else if (data.type == VIDEO_TYPE_MPG) {
+        plm_set_video_decode_callback(data.plm, queue_mpg_video, 0);
+    }
+    data.decoder.thread = thread_create(run_decoder, "video_decoder", 0);
+    if (!data.decoder.thread) {
+        // No threads on this platform: keep decoding in the draw call
+        if (data.type == VIDEO_TYPE_MPG) {
+            plm_set_video_decode_callback(data.plm, update_mpg_video, 0);
+        }
+        free_queued_frames();
+    }
+}
+
+static void stop_decoder(void)
+{
+    if (!data.decoder.thread) {
+        return;
+    }
+    thread_mutex_lock(data.decoder.lock);
+    data.decoder.stop = 1;
+    thread_condition_signal(data.decoder.has_room);
+    thread_mutex_unlock(data.decoder.lock);
+    thread_wait(data.decoder.thread);
+    data.decoder.thread = 0;
+    free_queued_frames();
+}
+
+static void upload_queued_frame(const queued_frame *frame)
+{
+    if (data.decoder.is_yuv) {
+        graphics_renderer()->update_custom_image_yuv(CUSTOM_IMAGE_VIDEO,
+            frame->planes[0].data, frame->planes[0].stride, frame->planes[1].data, frame->planes[1].stride,
+            frame->planes[2].data, frame->planes[2].stride);
+        return;
+    }
+    for (int y = 0; y < data.video.height; y++) {
+        memcpy(&data.buffer.pixels[y * data.buffer.width], &frame->pixels[y * data.video.width],
+            data.video.width * sizeof(color_t));
+    }
+    graphics_renderer()->update_custom_image(CUSTOM_IMAGE_VIDEO);
+}
+
+static void end_video(void);
+
+static void show_queued_frames(time_millis now_millis)
+{
+    data.video.draw_frame = 0;
+    thread_mutex_lock(data.decoder.lock);
+    int frames = data.decoder.count;
+    int finished = data.decoder.finished;
+    thread_mutex_unlock(data.decoder.lock);
+
+    if (!frames) {
+        if (finished) {
+            close_decoder();
+            data.is_ended = 1;
+            data.is_playing = 0;
+            end_video();
+        }
+        return;
+    }
+    if (data.type != VIDEO_TYPE_AV1) {
+        // Frame n is due from the start of its own period, so the first frame is shown right away
+        int due_frames = (now_millis - data.video.start_render_millis) * 1000 / data.video.micros_per_frame + 1;
+        if (due_frames - data.video.current_frame < frames) {
+            frames = due_frames - data.video.current_frame;
+        }
+        if (frames <= 0) {
+            return;
+        }
+    }
+    // When drawing fell behind, the frames in between are dropped and only the latest due one is shown
+    upload_queued_frame(&data.decoder.frames[(data.decoder.first + frames - 1) % VIDEO_QUEUE_SIZE]);
+    data.video.current_frame += frames;
+
+    thread_mutex_lock(data.decoder.lock);
+    data.decoder.first = (data.decoder.first + frames) % VIDEO_QUEUE_SIZE;
+    data.decoder.count -= frames;
+    thread_condition_signal(data.decoder.has_room);
+    thread_mutex_unlock(data.decoder.lock);
+}
+
 static void end_video(void)
 {
     sound_device_use_default_music_player();
@@ -302,6 +607,7 @@ int video_start(const char *filename)
         sound_speech_stop();
         int is_yuv = data.type != VIDEO_TYPE_SMK && graphics_renderer()->supports_yuv_image_format();
         graphics_renderer()->create_custom_image(CUSTOM_IMAGE_VIDEO, data.video.width, data.video.height, is_yuv);
+        data.decoder.is_yuv = is_yuv;
         if (!is_yuv) {
             data.buffer.pixels = graphics_renderer()->get_custom_image_buffer(CUSTOM_IMAGE_VIDEO, &data.buffer.width);
         }
@@ -342,6 +648,7 @@ void video_init(int restart_music)
                 audio_data, audio_len);
         }
     }
+    start_decoder();
 }
 
 int video_is_finished(void)
@@ -377,6 +684,10 @@ static void get_next_frame(void)
     }
     time_millis now_millis = system_get_ticks();
 
+    if (data.decoder.thread) {
+        show_queued_frames(now_millis);
+        return;
+    }
     if (data.type == VIDEO_TYPE_SMK) {
         int frame_no = (now_millis - data.video.start_render_millis) * 1000 / data.video.micros_per_frame;
         data.video.draw_frame = data.video.current_frame == 0;
@@ -390,14 +701,7 @@ static void get_next_frame(void)
             }
             data.video.current_frame++;
             data.video.draw_frame = 1;
-
-            if (data.audio.has_audio) {
-                int audio_len = smacker_get_frame_audio_size(data.s, 0);
-                const void *audio_data = smacker_get_frame_audio(data.s, 0);
-                if (audio_len > 0) {
-                    sound_device_write_custom_music_data(audio_data, audio_len);
-                }
-            }
+            write_smk_frame_audio();
         }
     } else if (data.type == VIDEO_TYPE_MPG) {
         double elapsed_time = (now_millis - data.video.start_render_millis) / 1000.0;
@@ -413,12 +717,7 @@ static void get_next_frame(void)
             end_video();
         }
     } else if (data.type == VIDEO_TYPE_AV1) {
-        if (data.audio.has_audio) {
-            const easyav1_audio_frame *audio_frame = easyav1_get_audio_frame(data.easyav1);
-            if (audio_frame) {
-                sound_device_write_custom_music_data(audio_frame->pcm.interlaced, (int) audio_frame->bytes);
-            }
-        }
+        write_av1_audio();
 
         if (easyav1_has_video_frame(data.easyav1)) {
             data.video.draw_frame = 1;
@@ -442,19 +741,7 @@ static void update_video_frame(void)
         return;
     }
     if (data.type == VIDEO_TYPE_SMK) {
-        const unsigned char *frame = smacker_get_frame_video(data.s);
-        const uint32_t *pal = smacker_get_frame_palette(data.s);
-        if (frame && pal) {
-            for (int y = 0; y < data.video.height; y++) {
-                color_t *pixel = &data.buffer.pixels[y * data.buffer.width];
-                int video_y = data.video.y_scale == SMACKER_Y_SCALE_NONE ? y : y / 2;
-                const unsigned char *line = frame + (video_y * data.video.width);
-                for (int x = 0; x < data.video.width; x++) {
-                    *pixel = ALPHA_OPAQUE | pal[line[x]];
-                    ++pixel;
-                }
-            }
-        }
+        draw_smk_frame(data.buffer.pixels, data.buffer.width);
     } else if (data.type == VIDEO_TYPE_MPG) {
         if (graphics_renderer()->supports_yuv_image_format()) {
             plm_frame_t *frame = data.video.mpg_frame;
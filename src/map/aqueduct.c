@@ -47,27 +47,27 @@ void map_aqueduct_remove(int grid_offset)
 
 void map_aqueduct_clear(void)
 {
-    map_grid_clear_u8(aqueduct.items);
+    map_grid_clear_u8(&aqueduct);
 }
 
 void map_aqueduct_backup(void)
 {
-    map_grid_copy_u8(aqueduct.items, aqueduct_backup.items);
+    map_grid_copy_u8(&aqueduct, &aqueduct_backup);
 }
 
 void map_aqueduct_restore(void)
 {
-    map_grid_copy_u8(aqueduct_backup.items, aqueduct.items);
+    map_grid_copy_u8(&aqueduct_backup, &aqueduct);
 }
 
 void map_aqueduct_save_state(buffer *buf, buffer *backup)
 {
-    map_grid_save_state_u8(aqueduct.items, buf);
-    map_grid_save_state_u8(aqueduct_backup.items, backup);
+    map_grid_save_state_u8(&aqueduct, buf);
+    map_grid_save_state_u8(&aqueduct_backup, backup);
 }
 
 void map_aqueduct_load_state(buffer *buf, buffer *backup)
 {
-    map_grid_load_state_u8(aqueduct.items, buf);
-    map_grid_load_state_u8(aqueduct_backup.items, backup);
+    map_grid_load_state_u8(&aqueduct, buf);
+    map_grid_load_state_u8(&aqueduct_backup, backup);
 }
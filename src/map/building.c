@@ -2,9 +2,16 @@
 
 #include "building/building.h"
 #include "core/config.h"
+#include "core/log.h"
 #include "game/save_version.h"
 #include "map/grid.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#define NEARBY_SIZE_STEP 5000
+#define NEARBY_ENTRIES_PER_TILE 4
+
 static grid_u32 buildings_grid;
 static grid_u8 damage_grid;
 static grid_u32 rubble_info_grid;
@@ -13,6 +20,78 @@ static grid_u32 buildings_grid_backup;
 static grid_u8 damage_grid_backup;
 static grid_u32 rubble_info_grid_backup;
 
+static struct {
+    struct {
+        unsigned int start;
+        unsigned int count;
+        unsigned int generation;
+    } *tiles;
+    int total_tiles;
+    map_building_nearby *entries;
+    unsigned int size;
+    unsigned int capacity;
+    unsigned int generation;
+} nearby = { .generation = 1 };
+
+static void clear_nearby(void)
+{
+    // Stale entries are never reused, so the whole list is dropped once instead of tracking holes
+    nearby.size = 0;
+    nearby.generation++;
+    int total_tiles = map_grid_total_tiles();
+    if (nearby.total_tiles != total_tiles) {
+        free(nearby.tiles);
+        nearby.tiles = calloc(total_tiles, sizeof(*nearby.tiles));
+        nearby.total_tiles = nearby.tiles ? total_tiles : 0;
+        if (!nearby.tiles) {
+            log_error("Unable to allocate memory for the nearby buildings cache", 0, 0);
+        }
+    } else if (!nearby.generation) {
+        memset(nearby.tiles, 0, total_tiles * sizeof(*nearby.tiles));
+    }
+    if (!nearby.generation) {
+        nearby.generation = 1;
+    }
+}
+
+static void invalidate_nearby(int grid_offset)
+{
+    if (nearby.total_tiles != map_grid_total_tiles()) {
+        // the whole cache is dropped on the next lookup
+        return;
+    }
+    int x_min, y_min, x_max, y_max;
+    map_grid_get_area(map_grid_offset_to_x(grid_offset), map_grid_offset_to_y(grid_offset), 1,
+        MAP_BUILDING_NEARBY_RADIUS, &x_min, &y_min, &x_max, &y_max);
+    for (int yy = y_min; yy <= y_max; yy++) {
+        for (int xx = x_min; xx <= x_max; xx++) {
+            nearby.tiles[map_grid_offset(xx, yy)].generation = 0;
+        }
+    }
+}
+
+static int add_nearby(unsigned int building_id, unsigned int start)
+{
+    for (unsigned int i = start; i < nearby.size; i++) {
+        if (nearby.entries[i].building_id == building_id) {
+            nearby.entries[i].tiles++;
+            return 1;
+        }
+    }
+    if (nearby.size >= nearby.capacity) {
+        unsigned int new_capacity = nearby.capacity + NEARBY_SIZE_STEP;
+        map_building_nearby *entries = realloc(nearby.entries, new_capacity * sizeof(map_building_nearby));
+        if (!entries) {
+            return 0;
+        }
+        nearby.entries = entries;
+        nearby.capacity = new_capacity;
+    }
+    nearby.entries[nearby.size].building_id = building_id;
+    nearby.entries[nearby.size].tiles = 1;
+    nearby.size++;
+    return 1;
+}
 
 unsigned int map_building_at(int grid_offset)
 {
@@ -21,15 +100,66 @@ unsigned int map_building_at(int grid_offset)
 
 unsigned int map_building_from_buffer(buffer *buildings, int grid_offset)
 {
-    buffer_set(buildings, grid_offset * sizeof(uint16_t));
-    return buffer_read_u16(buildings);
+    switch (map_grid_seek_state(buildings, grid_offset)) {
+        case sizeof(uint16_t):
+            return buffer_read_u16(buildings);
+        case sizeof(uint32_t):
+            return buffer_read_u32(buildings);
+        default:
+            return 0;
+    }
 }
 
 void map_building_set(int grid_offset, unsigned int building_id)
 {
+    if (buildings_grid.items[grid_offset] != building_id) {
+        invalidate_nearby(grid_offset);
+    }
     buildings_grid.items[grid_offset] = building_id;
 }
 
+const map_building_nearby *map_building_get_nearby(int x, int y, int *count)
+{
+    int grid_offset = map_grid_offset(x, y);
+    if (!map_grid_is_valid_offset(grid_offset)) {
+        *count = 0;
+        return 0;
+    }
+    if (nearby.total_tiles != map_grid_total_tiles()) {
+        clear_nearby();
+        if (!nearby.tiles) {
+            *count = 0;
+            return 0;
+        }
+    }
+    if (nearby.tiles[grid_offset].generation == nearby.generation) {
+        *count = nearby.tiles[grid_offset].count;
+        return &nearby.entries[nearby.tiles[grid_offset].start];
+    }
+    if (nearby.size >= nearby.total_tiles * NEARBY_ENTRIES_PER_TILE) {
+        clear_nearby();
+    }
+    unsigned int start = nearby.size;
+    int x_min, y_min, x_max, y_max;
+    map_grid_get_area(x, y, 1, MAP_BUILDING_NEARBY_RADIUS, &x_min, &y_min, &x_max, &y_max);
+    for (int yy = y_min; yy <= y_max; yy++) {
+        for (int xx = x_min; xx <= x_max; xx++) {
+            unsigned int building_id = map_building_at(map_grid_offset(xx, yy));
+            if (building_id && !add_nearby(building_id, start)) {
+                log_error("Unable to allocate enough memory for the nearby buildings cache. The game will now crash.",
+                    0, 0);
+                *count = 0;
+                return 0;
+            }
+        }
+    }
+    nearby.tiles[grid_offset].start = start;
+    nearby.tiles[grid_offset].count = nearby.size - start;
+    nearby.tiles[grid_offset].generation = nearby.generation;
+    *count = nearby.size - start;
+    return &nearby.entries[start];
+}
+
 void map_building_damage_clear(int grid_offset)
 {
     damage_grid.items[grid_offset] = 0;
@@ -72,8 +202,9 @@ int map_building_ruins_left(unsigned int building_id)
     int size = b->data.rubble.og_size ? b->data.rubble.og_size : b->size;
     int slice_offset = b->data.rubble.og_grid_offset ? b->data.rubble.og_grid_offset : b->grid_offset;
     grid_slice *slice = map_grid_get_grid_slice_square(slice_offset, size);
-    for (int i = 0; i < slice->size; i++) {
-        int grid_offset = slice->grid_offsets[i];
+    grid_slice_iterator it = map_grid_slice_iterate(slice);
+    while (map_grid_slice_next(&it)) {
+        int grid_offset = it.grid_offset;
         if (map_building_rubble_building_id(grid_offset) == building_id) {
             ruins_count++;
         } else if (map_building_at(grid_offset) == building_id &&
@@ -86,49 +217,52 @@ int map_building_ruins_left(unsigned int building_id)
 
 void map_building_backup(void)
 {
-    map_grid_copy_u32(buildings_grid.items, buildings_grid_backup.items);
-    map_grid_copy_u8(damage_grid.items, damage_grid_backup.items);
-    map_grid_copy_u32(rubble_info_grid.items, rubble_info_grid_backup.items);
+    map_grid_copy_u32(&buildings_grid, &buildings_grid_backup);
+    map_grid_copy_u8(&damage_grid, &damage_grid_backup);
+    map_grid_copy_u32(&rubble_info_grid, &rubble_info_grid_backup);
 }
 
 void map_building_restore(void)
 {
-    map_grid_copy_u32(buildings_grid_backup.items, buildings_grid.items);
-    map_grid_copy_u8(damage_grid_backup.items, damage_grid.items);
-    map_grid_copy_u32(rubble_info_grid_backup.items, rubble_info_grid.items);
+    map_grid_copy_u32(&buildings_grid_backup, &buildings_grid);
+    clear_nearby();
+    map_grid_copy_u8(&damage_grid_backup, &damage_grid);
+    map_grid_copy_u32(&rubble_info_grid_backup, &rubble_info_grid);
 }
 
 void map_building_clear_backup(void)
 {
-    map_grid_clear_u32(buildings_grid_backup.items);
-    map_grid_clear_u8(damage_grid_backup.items);
-    map_grid_clear_u32(rubble_info_grid_backup.items);
+    map_grid_clear_u32(&buildings_grid_backup);
+    map_grid_clear_u8(&damage_grid_backup);
+    map_grid_clear_u32(&rubble_info_grid_backup);
 }
 
 void map_building_clear(void)
 {
-    map_grid_clear_u32(buildings_grid.items);
-    map_grid_clear_u8(damage_grid.items);
-    map_grid_clear_u32(rubble_info_grid.items);
+    map_grid_clear_u32(&buildings_grid);
+    map_grid_clear_u8(&damage_grid);
+    map_grid_clear_u32(&rubble_info_grid);
+    clear_nearby();
 }
 
 void map_building_save_state(buffer *buildings, buffer *damage, buffer *rubble)
 {
-    map_grid_save_state_u32(buildings_grid.items, buildings);
-    map_grid_save_state_u8(damage_grid.items, damage);
-    map_grid_save_state_u32(rubble_info_grid.items, rubble);
+    map_grid_save_state_u32(&buildings_grid, buildings);
+    map_grid_save_state_u8(&damage_grid, damage);
+    map_grid_save_state_u32(&rubble_info_grid, rubble);
 }
 
 void map_building_load_state(buffer *buildings, buffer *damage, buffer *rubble, savegame_version_t version)
 {
     if (version <= SAVE_GAME_LAST_U16_GRIDS) {
-        map_grid_load_state_u16_to_u32(buildings_grid.items, buildings);
-        map_grid_load_state_u8(damage_grid.items, damage);
+        map_grid_load_state_u16_to_u32(&buildings_grid, buildings);
+        map_grid_load_state_u8(&damage_grid, damage);
     } else {
-        map_grid_load_state_u32(buildings_grid.items, buildings);
-        map_grid_load_state_u8(damage_grid.items, damage);
-        map_grid_load_state_u32(rubble_info_grid.items, rubble);
+        map_grid_load_state_u32(&buildings_grid, buildings);
+        map_grid_load_state_u8(&damage_grid, damage);
+        map_grid_load_state_u32(&rubble_info_grid, rubble);
     }
+    clear_nearby();
 }
 
 int map_building_is_reservoir(int x, int y)
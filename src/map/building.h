@@ -16,6 +16,24 @@ unsigned int map_building_from_buffer(buffer *buildings, int grid_offset);
 
 void map_building_set(int grid_offset, unsigned int building_id);
 
+#define MAP_BUILDING_NEARBY_RADIUS 2
+
+typedef struct {
+    unsigned int building_id;
+    unsigned int tiles;
+} map_building_nearby;
+
+/**
+ * Returns the distinct buildings within MAP_BUILDING_NEARBY_RADIUS tiles of the given tile.
+ * The result is cached per tile until the building grid around it changes.
+ * @param x The x coordinate of the tile
+ * @param y The y coordinate of the tile
+ * @param count Set to the number of buildings returned
+ * @return The buildings in the order they are first found when scanning the area row by row,
+ *         along with the number of tiles each one covers in the area. Only valid until the next call.
+ */
+const map_building_nearby *map_building_get_nearby(int x, int y, int *count);
+
 /**
  * Increases building damage by 1
  * @param grid_offset Map offset
@@ -6,6 +6,7 @@ extern struct map_data_t {
     int height;
     int start_offset;
     int border_size;
+    int grid_size;
 } map_data;
 
 #endif // MAP_DATA_H
@@ -14,7 +14,7 @@ static grid_i8 desirability_grid;
 
 void map_desirability_clear(void)
 {
-    map_grid_clear_i8(desirability_grid.items);
+    map_grid_clear_i8(&desirability_grid);
 }
 
 static void add_desirability_at_distance(int x, int y, int size, int distance, int desirability)
@@ -77,10 +77,10 @@ static void update_buildings(void)
     int range;
     int venus_module2 = building_monument_gt_module_is_active(VENUS_MODULE_2_DESIRABILITY_ENTERTAINMENT);
     int venus_gt = building_monument_working(BUILDING_GRAND_TEMPLE_VENUS);
+    const building_hot_data *hot = building_get_hot_data();
     for (int i = 1; i < building_count(); i++) {
-        building *b = building_get(i);
-        if (b->state == BUILDING_STATE_IN_USE) {
-
+        if (hot[i].state == BUILDING_STATE_IN_USE) {
+            building *b = building_get(i);
             const model_building *model = model_get_building(b->type);
             value = model->desirability_value;
             step = model->desirability_step;
@@ -225,10 +225,10 @@ int map_desirability_get_max(int x, int y, int size)
 
 void map_desirability_save_state(buffer *buf)
 {
-    map_grid_save_state_i8(desirability_grid.items, buf);
+    map_grid_save_state_i8(&desirability_grid, buf);
 }
 
 void map_desirability_load_state(buffer *buf)
 {
-    map_grid_load_state_i8(desirability_grid.items, buf);
+    map_grid_load_state_i8(&desirability_grid, buf);
 }
@@ -18,7 +18,7 @@ void map_elevation_set(int grid_offset, int value)
 
 void map_elevation_clear(void)
 {
-    map_grid_clear_u8(elevation.items);
+    map_grid_clear_u8(&elevation);
 }
 
 static void fix_cliff_tiles(int grid_offset)
@@ -51,10 +51,10 @@ void map_elevation_remove_cliffs(void)
 
 void map_elevation_save_state(buffer *buf)
 {
-    map_grid_save_state_u8(elevation.items, buf);
+    map_grid_save_state_u8(&elevation, buf);
 }
 
 void map_elevation_load_state(buffer *buf)
 {
-    map_grid_load_state_u8(elevation.items, buf);
+    map_grid_load_state_u8(&elevation, buf);
 }
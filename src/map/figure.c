@@ -98,15 +98,15 @@ int map_figure_foreach_until(int grid_offset, int (*callback)(figure *f))
 
 void map_figure_clear(void)
 {
-    map_grid_clear_u16(figures.items);
+    map_grid_clear_u16(&figures);
 }
 
 void map_figure_save_state(buffer *buf)
 {
-    map_grid_save_state_u16(figures.items, buf);
+    map_grid_save_state_u16(&figures, buf);
 }
 
 void map_figure_load_state(buffer *buf)
 {
-    map_grid_load_state_u16(figures.items, buf);
+    map_grid_load_state_u16(&figures, buf);
 }
@@ -9,73 +9,136 @@
 #include <string.h>
 
 
-#define OFFSET(x,y) (x + GRID_SIZE * y)
+#define GRID_STATE_VERSION 1
+#define GRID_STATE_HEADER_SIZE (3 * sizeof(int32_t))
+#define MAX_ADJACENT_SIZE 7
+#define MAX_REGISTERED_GRIDS 64
+
+struct map_data_t map_data = { .grid_size = GRID_SIZE_LEGACY };
+
+typedef enum {
+    GRID_TYPE_U8,
+    GRID_TYPE_I8,
+    GRID_TYPE_U16,
+    GRID_TYPE_I16,
+    GRID_TYPE_U32
+} grid_type;
+
+static struct {
+    grid_type type;
+    void *grid;
+} registered_grids[MAX_REGISTERED_GRIDS];
+
+static int num_registered_grids;
+
+static struct {
+    int grid_size;
+    int direction_delta[8];
+    int adjacent[MAX_ADJACENT_SIZE + 1][4 * MAX_ADJACENT_SIZE + 1];
+} deltas;
+
+static void calculate_deltas(void)
+{
+    int size = map_data.grid_size;
+    const int direction_delta[8] = {
+        -size, 1 - size, 1, 1 + size, size, size - 1, -1, -1 - size
+    };
+    memcpy(deltas.direction_delta, direction_delta, sizeof(direction_delta));
+
+    memset(deltas.adjacent, 0, sizeof(deltas.adjacent));
+    for (int tiles = 1; tiles <= MAX_ADJACENT_SIZE; tiles++) {
+        if (tiles == 6) {
+            continue; // there are no 6x6 buildings
+        }
+        // clockwise around the building, starting at the top left
+        int *adjacent = deltas.adjacent[tiles];
+        for (int i = 0; i < tiles; i++) {
+            *adjacent++ = i - size;
+        }
+        for (int i = 0; i < tiles; i++) {
+            *adjacent++ = tiles + i * size;
+        }
+        for (int i = tiles - 1; i >= 0; i--) {
+            *adjacent++ = i + tiles * size;
+        }
+        for (int i = tiles - 1; i >= 0; i--) {
+            *adjacent++ = -1 + i * size;
+        }
+    }
+    deltas.grid_size = size;
+}
 
-struct map_data_t map_data;
+static void *allocate_items(size_t item_size)
+{
+    void *items = calloc(map_grid_total_tiles(), item_size);
+    if (!items) {
+        log_error("Unable to allocate memory for a map grid", 0, map_data.grid_size);
+    }
+    return items;
+}
 
-static const int DIRECTION_DELTA[] = {
-    -OFFSET(0,1), OFFSET(1,-1), 1, OFFSET(1,1), OFFSET(0,1), OFFSET(-1,1), -1, -OFFSET(1,1)
-};
+static void register_grid(grid_type type, void *grid)
+{
+    for (int i = 0; i < num_registered_grids; i++) {
+        if (registered_grids[i].grid == grid) {
+            return;
+        }
+    }
+    if (num_registered_grids >= MAX_REGISTERED_GRIDS) {
+        log_error("Too many map grids, the grid will not be resized with the map", 0, num_registered_grids);
+        return;
+    }
+    registered_grids[num_registered_grids].type = type;
+    registered_grids[num_registered_grids].grid = grid;
+    num_registered_grids++;
+}
 
-static const int ADJACENT_OFFSETS[][29] = {
-    {
-        0
-    },
-    {//1x1
-        OFFSET(0,-1),
-        OFFSET(1,0),
-        OFFSET(0,1),
-        OFFSET(-1,0), 0
-    },
-    {//2x2
-        OFFSET(0,-1), OFFSET(1,-1),
-        OFFSET(2,0), OFFSET(2,1),
-        OFFSET(1,2), OFFSET(0,2),
-        OFFSET(-1,1), OFFSET(-1,0), 0
-    },
-    {//3x3
-        OFFSET(0,-1), OFFSET(1,-1), OFFSET(2,-1),
-        OFFSET(3,0), OFFSET(3,1), OFFSET(3,2),
-        OFFSET(2,3), OFFSET(1,3), OFFSET(0,3),
-        OFFSET(-1,2), OFFSET(-1,1), OFFSET(-1,0), 0
-    },
-    {//4x4
-        OFFSET(0,-1), OFFSET(1,-1), OFFSET(2,-1), OFFSET(3,-1),
-        OFFSET(4,0), OFFSET(4,1), OFFSET(4,2), OFFSET(4,3),
-        OFFSET(3,4), OFFSET(2,4), OFFSET(1,4), OFFSET(0,4),
-        OFFSET(-1,3), OFFSET(-1,2), OFFSET(-1,1), OFFSET(-1,0), 0
-    },
-    {//5x5
-        OFFSET(0,-1), OFFSET(1,-1), OFFSET(2,-1), OFFSET(3,-1), OFFSET(4,-1),
-        OFFSET(5,0), OFFSET(5,1), OFFSET(5,2), OFFSET(5,3), OFFSET(5,4),
-        OFFSET(4,5), OFFSET(3,5), OFFSET(2,5), OFFSET(1,5), OFFSET(0,5),
-        OFFSET(-1,4), OFFSET(-1,3), OFFSET(-1,2), OFFSET(-1,1), OFFSET(-1,0), 0
-    },
-    {//6x6
-        0
-    },
-    {//7x7
-        OFFSET(0,-1), OFFSET(1,-1), OFFSET(2,-1), OFFSET(3,-1), OFFSET(4,-1), OFFSET(5,-1), OFFSET(6,-1),
-        OFFSET(7,0), OFFSET(7,1), OFFSET(7,2), OFFSET(7,3), OFFSET(7,4), OFFSET(7,5), OFFSET(7,6),
-        OFFSET(6,7), OFFSET(5,7), OFFSET(4,7), OFFSET(3,7), OFFSET(2,7), OFFSET(1,7), OFFSET(0,7),
-        OFFSET(-1,6), OFFSET(-1,5), OFFSET(-1,4), OFFSET(-1,3), OFFSET(-1,2), OFFSET(-1,1), OFFSET(-1,0), 0
-    }
-};
+static void reallocate_grid(grid_type type, void *grid)
+{
+    switch (type) {
+        case GRID_TYPE_U8:
+            free(((grid_u8 *) grid)->items);
+            ((grid_u8 *) grid)->items = allocate_items(sizeof(uint8_t));
+            break;
+        case GRID_TYPE_I8:
+            free(((grid_i8 *) grid)->items);
+            ((grid_i8 *) grid)->items = allocate_items(sizeof(int8_t));
+            break;
+        case GRID_TYPE_U16:
+            free(((grid_u16 *) grid)->items);
+            ((grid_u16 *) grid)->items = allocate_items(sizeof(uint16_t));
+            break;
+        case GRID_TYPE_I16:
+            free(((grid_i16 *) grid)->items);
+            ((grid_i16 *) grid)->items = allocate_items(sizeof(int16_t));
+            break;
+        case GRID_TYPE_U32:
+            free(((grid_u32 *) grid)->items);
+            ((grid_u32 *) grid)->items = allocate_items(sizeof(uint32_t));
+            break;
+    }
+}
+
+static void set_grid_size(int grid_size)
+{
+    if (grid_size == map_data.grid_size) {
+        return;
+    }
+    map_data.grid_size = grid_size;
+    for (int i = 0; i < num_registered_grids; i++) {
+        reallocate_grid(registered_grids[i].type, registered_grids[i].grid);
+    }
+}
 
 /* --- Slice pool (100 entries) with ring eviction --- */
 #define GRID_SLICE_POOL_CAP 100
+#define GRID_SLICE_RUNS_STEP 16
 static grid_slice grid_slice_pool[GRID_SLICE_POOL_CAP];
 static uint8_t grid_slice_pool_used[GRID_SLICE_POOL_CAP];
 static int grid_slice_pool_next = 0;
 
-static grid_slice *grid_slice_pool_commit(const int *offsets, int count)
+static grid_slice *grid_slice_pool_take(void)
 {
-    if (count < 0) {
-        count = 0;
-    }
-    if (count > MAX_SLICE_SIZE) {
-        count = MAX_SLICE_SIZE;
-    }
     /* find free slot first */
     int slot = -1;
     for (int i = 0; i < GRID_SLICE_POOL_CAP; i++) {
@@ -93,34 +156,148 @@ static grid_slice *grid_slice_pool_commit(const int *offsets, int count)
 
     grid_slice_pool_used[slot] = 1;
     grid_slice *s = &grid_slice_pool[slot];
-    s->size = count;
+    /* keep the runs buffer of the evicted slice around for reuse */
+    map_grid_slice_clear(s);
+    return s;
+}
 
-    /* copy exactly count entries */
-    for (int i = 0; i < count; i++) {
-        s->grid_offsets[i] = offsets[i];
+/* appends the offset to the last run when it directly follows it */
+static int grid_slice_add_offset(grid_slice *s, int offset)
+{
+    if (s->size >= map_grid_total_tiles()) {
+        return 0;
+    }
+    if (s->num_runs) {
+        grid_slice_run *last = &s->runs[s->num_runs - 1];
+        if (last->grid_offset + last->length == offset) {
+            last->length++;
+            s->size++;
+            return 1;
+        }
     }
+    if (s->num_runs >= s->runs_capacity) {
+        int new_capacity = s->runs_capacity + GRID_SLICE_RUNS_STEP;
+        grid_slice_run *runs = realloc(s->runs, new_capacity * sizeof(grid_slice_run));
+        if (!runs) {
+            log_error("Unable to allocate memory for a grid slice. The slice will be incomplete.", 0, 0);
+            return 0;
+        }
+        s->runs = runs;
+        s->runs_capacity = new_capacity;
+    }
+    s->runs[s->num_runs].grid_offset = offset;
+    s->runs[s->num_runs].length = 1;
+    s->num_runs++;
+    s->size++;
+    return 1;
+}
 
+static grid_slice *grid_slice_pool_commit(const int *offsets, int count)
+{
+    grid_slice *s = grid_slice_pool_take();
+    for (int i = 0; i < count; i++) {
+        if (!grid_slice_add_offset(s, offsets[i])) {
+            break;
+        }
+    }
     return s;
 }
 
+static int grid_slice_get_run(const grid_slice *slice, int run, int *grid_offset, int *length)
+{
+    if (slice->row_length) {
+        if (run >= slice->size / slice->row_length) {
+            return 0;
+        }
+        *grid_offset = slice->start_offset + run * map_data.grid_size;
+        *length = slice->row_length;
+        return 1;
+    }
+    if (run >= slice->num_runs) {
+        return 0;
+    }
+    *grid_offset = slice->runs[run].grid_offset;
+    *length = slice->runs[run].length;
+    return 1;
+}
+
 void map_grid_init(int width, int height, int start_offset, int border_size)
 {
     map_data.width = width;
     map_data.height = height;
     map_data.start_offset = start_offset;
     map_data.border_size = border_size;
+
+    int grid_size = width + border_size;
+    if (grid_size <= 0 || grid_size > GRID_SIZE_MAX) {
+        log_error("Invalid map grid size, using the original size instead", 0, grid_size);
+        grid_size = GRID_SIZE_LEGACY;
+    }
+    set_grid_size(grid_size);
 }
 
-/* allocate from pool based on already computed offsets */
-static grid_slice *allocate_grid_slice_memory_from_offsets(const int *offsets, int count)
+int map_grid_stride(void)
 {
-    return grid_slice_pool_commit(offsets, count);
+    return map_data.grid_size;
+}
+
+int map_grid_total_tiles(void)
+{
+    return map_data.grid_size * map_data.grid_size;
 }
 
 grid_slice *map_grid_get_grid_slice(int *grid_offsets, int size)
 {
-    /* size may be larger than MAX_SLICE_SIZE; cap on commit */
-    return allocate_grid_slice_memory_from_offsets(grid_offsets, size);
+    /* size may be larger than the grid; cap on commit */
+    return grid_slice_pool_commit(grid_offsets, size);
+}
+
+void map_grid_slice_clear(grid_slice *slice)
+{
+    slice->size = 0;
+    slice->row_length = 0;
+    slice->start_offset = 0;
+    slice->num_runs = 0;
+}
+
+grid_slice_iterator map_grid_slice_iterate(const grid_slice *slice)
+{
+    grid_slice_iterator it = { slice, 0, -1, 0 };
+    return it;
+}
+
+int map_grid_slice_next(grid_slice_iterator *it)
+{
+    if (!it->slice) {
+        return 0;
+    }
+    int grid_offset, length;
+    it->position++;
+    while (grid_slice_get_run(it->slice, it->run, &grid_offset, &length)) {
+        if (it->position < length) {
+            it->grid_offset = grid_offset + it->position;
+            return 1;
+        }
+        it->run++;
+        it->position = 0;
+    }
+    return 0;
+}
+
+int map_grid_slice_get_first_and_last_offsets(const grid_slice *slice, int *first_offset, int *last_offset)
+{
+    if (!slice || slice->size == 0) {
+        return 0;
+    }
+    int grid_offset, length;
+    grid_slice_get_run(slice, 0, first_offset, &length);
+    if (slice->row_length) {
+        grid_slice_get_run(slice, slice->size / slice->row_length - 1, &grid_offset, &length);
+    } else {
+        grid_slice_get_run(slice, slice->num_runs - 1, &grid_offset, &length);
+    }
+    *last_offset = grid_offset + length - 1;
+    return 1;
 }
 
 grid_slice *map_grid_get_grid_slice_from_corners(int start_x, int start_y, int end_x, int end_y)
@@ -153,10 +330,10 @@ int map_grid_get_corner_offsets_from_grid_slice(const grid_slice *slice, int *to
     }
     int x_min = 2147483647, y_min = 2147483647; // no max offset values defined, just use INT_MAX
     int x_max = 0, y_max = 0;
-    for (int i = 0; i < slice->size; i++) {
-        int offset = slice->grid_offsets[i];
-        int x = map_grid_offset_to_x(offset);
-        int y = map_grid_offset_to_y(offset);
+    grid_slice_iterator it = map_grid_slice_iterate(slice);
+    while (map_grid_slice_next(&it)) {
+        int x = map_grid_offset_to_x(it.grid_offset);
+        int y = map_grid_offset_to_y(it.grid_offset);
         if (x < x_min) x_min = x;
         if (y < y_min) y_min = y;
         if (x > x_max) x_max = x;
@@ -173,29 +350,37 @@ grid_slice *map_grid_get_grid_slice_rectangle(int start_grid_offset, int width,
     int x = map_grid_offset_to_x(start_grid_offset);
     int y = map_grid_offset_to_y(start_grid_offset);
 
-    int tmp[MAX_SLICE_SIZE];
-    int count = 0;
-
+    grid_slice *s = grid_slice_pool_take();
+    if (width <= 0 || height <= 0) {
+        return s;
+    }
+    /* offsets only grow along the rectangle, so it is valid as a whole when both ends are */
+    int first_offset = map_grid_offset(x, y);
+    int last_offset = map_grid_offset(x + width - 1, y + height - 1);
+    if (width * height <= map_grid_total_tiles() &&
+        map_grid_is_valid_offset(first_offset) && map_grid_is_valid_offset(last_offset)) {
+        s->size = width * height;
+        s->row_length = width;
+        s->start_offset = first_offset;
+        return s;
+    }
     for (int i = 0; i < height; i++) {
         for (int j = 0; j < width; j++) {
-            if (count >= MAX_SLICE_SIZE) {
-                return allocate_grid_slice_memory_from_offsets(tmp, count);
-            }
             int offset = map_grid_offset(x + j, y + i);
-            if (map_grid_is_valid_offset(offset)) {
-                tmp[count++] = offset;
-            } else {
-                /* skip invalid */
+            if (!map_grid_is_valid_offset(offset)) {
+                continue; /* skip invalid */
+            }
+            if (!grid_slice_add_offset(s, offset)) {
+                return s;
             }
         }
     }
-    return allocate_grid_slice_memory_from_offsets(tmp, count);
+    return s;
 }
 
 grid_slice *map_grid_get_grid_slice_house(unsigned int building_id, int check_rubble)
 {
-    int tmp[MAX_SLICE_SIZE];
-    int count = 0;
+    grid_slice *s = grid_slice_pool_take();
 
     building *b = building_get(building_id);
     int starting_x = map_grid_offset_to_x(b->grid_offset);
@@ -203,17 +388,15 @@ grid_slice *map_grid_get_grid_slice_house(unsigned int building_id, int check_ru
     for (int i = 0; i < 4; i++) // max house size is 4x4
     {
         for (int j = 0; j < 4; j++) {
-            if (count >= MAX_SLICE_SIZE) {
-                return allocate_grid_slice_memory_from_offsets(tmp, count);
-            }
             int offset = map_grid_offset(starting_x + j, starting_y + i);
             if ((check_rubble ? map_building_rubble_building_id(offset) : map_building_at(offset)) == building_id) {
-                tmp[count++] = offset;
-                continue;
+                if (!grid_slice_add_offset(s, offset)) {
+                    return s;
+                }
             }
         }
     }
-    return allocate_grid_slice_memory_from_offsets(tmp, count);
+    return s;
 }
 
 grid_slice *map_grid_get_grid_slice_square(int start_grid_offset, int size)
@@ -226,14 +409,10 @@ grid_slice *map_grid_get_grid_slice_ring(int center_grid_offset, int inner_radiu
 {
     int center_x = map_grid_offset_to_x(center_grid_offset);
     int center_y = map_grid_offset_to_y(center_grid_offset);
-    int tmp[MAX_SLICE_SIZE];
-    int count = 0;
+    grid_slice *s = grid_slice_pool_take();
 
     for (int dy = -outer_radius; dy <= outer_radius; dy++) {
         for (int dx = -outer_radius; dx <= outer_radius; dx++) {
-            if (count >= MAX_SLICE_SIZE) {
-                return allocate_grid_slice_memory_from_offsets(tmp, count);
-            }
             int distance = (abs(dx) > abs(dy)) ? abs(dx) : abs(dy);
 
             // Include if within ring bounds (greater than inner radius, less than or equal to outer radius)
@@ -243,17 +422,17 @@ grid_slice *map_grid_get_grid_slice_ring(int center_grid_offset, int inner_radiu
                 if (x < 0 || y < 0) {
                     continue;
                 }
-                if (x > GRID_SIZE || y > GRID_SIZE) {
+                if (x > map_data.grid_size || y > map_data.grid_size) {
                     continue;
                 }
                 int offset = map_grid_offset(x, y);
-                if (map_grid_is_valid_offset(offset)) {
-                    tmp[count++] = offset;
+                if (map_grid_is_valid_offset(offset) && !grid_slice_add_offset(s, offset)) {
+                    return s;
                 }
             }
         }
     }
-    return allocate_grid_slice_memory_from_offsets(tmp, count);
+    return s;
 }
 
 grid_slice *map_grid_get_grid_slice_from_center(int center_grid_offset, int radius)
@@ -264,35 +443,35 @@ grid_slice *map_grid_get_grid_slice_from_center(int center_grid_offset, int radi
 
 int map_grid_is_valid_offset(int grid_offset)
 {
-    return grid_offset >= 0 && grid_offset < GRID_SIZE * GRID_SIZE;
+    return grid_offset >= 0 && grid_offset < map_grid_total_tiles();
 }
 
 int map_grid_offset(int x, int y)
 {
-    return map_data.start_offset + x + y * GRID_SIZE;
+    return map_data.start_offset + x + y * map_data.grid_size;
 }
 
 int map_grid_offset_to_x(int grid_offset)
 {
-    return (grid_offset - map_data.start_offset) % GRID_SIZE;
+    return (grid_offset - map_data.start_offset) % map_data.grid_size;
 }
 
 int map_grid_offset_to_y(int grid_offset)
 {
-    return (grid_offset - map_data.start_offset) / GRID_SIZE;
+    return (grid_offset - map_data.start_offset) / map_data.grid_size;
 }
 
 int map_grid_delta(int x, int y)
 {
-    return y * GRID_SIZE + x;
+    return y * map_data.grid_size + x;
 }
 
 int map_grid_add_delta(int grid_offset, int x, int y)
 {
-    int raw_x = grid_offset % GRID_SIZE;
-    int raw_y = grid_offset / GRID_SIZE;
-    if (raw_x + x < 0 || raw_x + x >= GRID_SIZE ||
-        raw_y + y < 0 || raw_y + y >= GRID_SIZE) {
+    int raw_x = grid_offset % map_data.grid_size;
+    int raw_y = grid_offset / map_data.grid_size;
+    if (raw_x + x < 0 || raw_x + x >= map_data.grid_size ||
+        raw_y + y < 0 || raw_y + y >= map_data.grid_size) {
         return -1;
     }
     return grid_offset + map_grid_delta(x, y);
@@ -301,7 +480,10 @@ int map_grid_add_delta(int grid_offset, int x, int y)
 int map_grid_direction_delta(int direction)
 {
     if (direction >= 0 && direction < 8) {
-        return DIRECTION_DELTA[direction];
+        if (deltas.grid_size != map_data.grid_size) {
+            calculate_deltas();
+        }
+        return deltas.direction_delta[direction];
     } else {
         return 0;
     }
@@ -404,7 +586,10 @@ int map_grid_is_inside(int x, int y, int size)
 
 const int *map_grid_adjacent_offsets(int size)
 {
-    return ADJACENT_OFFSETS[size];
+    if (deltas.grid_size != map_data.grid_size) {
+        calculate_deltas();
+    }
+    return deltas.adjacent[size];
 }
 
 void map_grid_get_corner_tiles(int start_x, int start_y, int x, int y, int *c1x, int *c1y, int *c2x, int *c2y)
@@ -422,130 +607,312 @@ void map_grid_get_corner_tiles(int start_x, int start_y, int x, int y, int *c1x,
     }
 }
 
-void map_grid_clear_i8(int8_t *grid)
+void map_grid_ensure_u8(grid_u8 *grid)
 {
-    memset(grid, 0, GRID_SIZE * GRID_SIZE * sizeof(int8_t));
+    if (!grid->items) {
+        grid->items = allocate_items(sizeof(uint8_t));
+        register_grid(GRID_TYPE_U8, grid);
+    }
+}
+
+void map_grid_ensure_i8(grid_i8 *grid)
+{
+    if (!grid->items) {
+        grid->items = allocate_items(sizeof(int8_t));
+        register_grid(GRID_TYPE_I8, grid);
+    }
 }
 
-void map_grid_clear_u8(uint8_t *grid)
+void map_grid_ensure_u16(grid_u16 *grid)
 {
-    memset(grid, 0, GRID_SIZE * GRID_SIZE * sizeof(uint8_t));
+    if (!grid->items) {
+        grid->items = allocate_items(sizeof(uint16_t));
+        register_grid(GRID_TYPE_U16, grid);
+    }
 }
 
-void map_grid_clear_u16(uint16_t *grid)
+void map_grid_ensure_i16(grid_i16 *grid)
 {
-    memset(grid, 0, GRID_SIZE * GRID_SIZE * sizeof(uint16_t));
+    if (!grid->items) {
+        grid->items = allocate_items(sizeof(int16_t));
+        register_grid(GRID_TYPE_I16, grid);
+    }
 }
 
-void map_grid_clear_u32(uint32_t *grid)
+void map_grid_ensure_u32(grid_u32 *grid)
 {
-    memset(grid, 0, GRID_SIZE * GRID_SIZE * sizeof(uint32_t));
+    if (!grid->items) {
+        grid->items = allocate_items(sizeof(uint32_t));
+        register_grid(GRID_TYPE_U32, grid);
+    }
 }
 
-void map_grid_clear_i16(int16_t *grid)
+void map_grid_clear_i8(grid_i8 *grid)
 {
-    memset(grid, 0, GRID_SIZE * GRID_SIZE * sizeof(int16_t));
+    map_grid_ensure_i8(grid);
+    memset(grid->items, 0, map_grid_total_tiles() * sizeof(int8_t));
 }
 
-void map_grid_init_i8(int8_t *grid, int8_t value)
+void map_grid_clear_u8(grid_u8 *grid)
 {
-    memset(grid, value, GRID_SIZE * GRID_SIZE * sizeof(int8_t));
+    map_grid_ensure_u8(grid);
+    memset(grid->items, 0, map_grid_total_tiles() * sizeof(uint8_t));
 }
 
-void map_grid_and_u8(uint8_t *grid, uint8_t mask)
+void map_grid_clear_u16(grid_u16 *grid)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        grid[i] &= mask;
+    map_grid_ensure_u16(grid);
+    memset(grid->items, 0, map_grid_total_tiles() * sizeof(uint16_t));
+}
+
+void map_grid_clear_u32(grid_u32 *grid)
+{
+    map_grid_ensure_u32(grid);
+    memset(grid->items, 0, map_grid_total_tiles() * sizeof(uint32_t));
+}
+
+void map_grid_clear_i16(grid_i16 *grid)
+{
+    map_grid_ensure_i16(grid);
+    memset(grid->items, 0, map_grid_total_tiles() * sizeof(int16_t));
+}
+
+void map_grid_init_i8(grid_i8 *grid, int8_t value)
+{
+    map_grid_ensure_i8(grid);
+    memset(grid->items, value, map_grid_total_tiles() * sizeof(int8_t));
+}
+
+void map_grid_and_u8(grid_u8 *grid, uint8_t mask)
+{
+    map_grid_ensure_u8(grid);
+    int total_tiles = map_grid_total_tiles();
+    for (int i = 0; i < total_tiles; i++) {
+        grid->items[i] &= mask;
+    }
+}
+
+void map_grid_and_u16(grid_u16 *grid, uint16_t mask)
+{
+    map_grid_ensure_u16(grid);
+    int total_tiles = map_grid_total_tiles();
+    for (int i = 0; i < total_tiles; i++) {
+        grid->items[i] &= mask;
     }
 }
 
-void map_grid_and_u16(uint16_t *grid, uint16_t mask)
+void map_grid_and_u32(grid_u32 *grid, uint32_t mask)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        grid[i] &= mask;
+    map_grid_ensure_u32(grid);
+    int total_tiles = map_grid_total_tiles();
+    for (int i = 0; i < total_tiles; i++) {
+        grid->items[i] &= mask;
     }
 }
 
-void map_grid_and_u32(uint32_t *grid, uint32_t mask)
+void map_grid_copy_u8(grid_u8 *src, grid_u8 *dst)
+{
+    map_grid_ensure_u8(src);
+    map_grid_ensure_u8(dst);
+    memcpy(dst->items, src->items, map_grid_total_tiles() * sizeof(uint8_t));
+}
+
+void map_grid_copy_u16(grid_u16 *src, grid_u16 *dst)
+{
+    map_grid_ensure_u16(src);
+    map_grid_ensure_u16(dst);
+    memcpy(dst->items, src->items, map_grid_total_tiles() * sizeof(uint16_t));
+}
+
+void map_grid_copy_u32(grid_u32 *src, grid_u32 *dst)
+{
+    map_grid_ensure_u32(src);
+    map_grid_ensure_u32(dst);
+    memcpy(dst->items, src->items, map_grid_total_tiles() * sizeof(uint32_t));
+}
+
+static void save_state_header(buffer *buf, int item_size)
+{
+    buffer_init_dynamic(buf, GRID_STATE_HEADER_SIZE + map_grid_total_tiles() * item_size);
+    buffer_write_i32(buf, GRID_STATE_VERSION);
+    buffer_write_i32(buf, map_data.grid_size);
+    buffer_write_i32(buf, item_size);
+}
+
+/**
+ * Grids saved without a header always have GRID_SIZE_LEGACY x GRID_SIZE_LEGACY items.
+ * A grid saved with a header can never have that exact size, as the header adds 16 bytes.
+ */
+static int is_legacy_state(const buffer *buf)
+{
+    size_t legacy_tiles = GRID_SIZE_LEGACY * GRID_SIZE_LEGACY;
+    return buf->size == legacy_tiles * sizeof(uint8_t) ||
+        buf->size == legacy_tiles * sizeof(uint16_t) ||
+        buf->size == legacy_tiles * sizeof(uint32_t);
+}
+
+static int read_state_header(buffer *buf, int *grid_size, int *item_size)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        grid[i] &= mask;
+    if (is_legacy_state(buf)) {
+        buffer_set(buf, 0);
+        *grid_size = GRID_SIZE_LEGACY;
+        *item_size = (int) (buf->size / (GRID_SIZE_LEGACY * GRID_SIZE_LEGACY));
+        return 1;
+    }
+    if (buf->size < sizeof(uint32_t) + GRID_STATE_HEADER_SIZE) {
+        return 0;
+    }
+    buffer_load_dynamic(buf);
+    int version = buffer_read_i32(buf);
+    *grid_size = buffer_read_i32(buf);
+    *item_size = buffer_read_i32(buf);
+    if (version != GRID_STATE_VERSION || *grid_size <= 0 || *grid_size > GRID_SIZE_MAX || *item_size <= 0) {
+        return 0;
     }
+    return buf->size == sizeof(uint32_t) + GRID_STATE_HEADER_SIZE +
+        (size_t) *grid_size * *grid_size * *item_size;
 }
 
-void map_grid_copy_u8(const uint8_t *src, uint8_t *dst)
+static int load_state_header(buffer *buf, int item_size)
 {
-    memcpy(dst, src, GRID_SIZE * GRID_SIZE * sizeof(uint8_t));
+    int grid_size;
+    int saved_item_size;
+    if (!read_state_header(buf, &grid_size, &saved_item_size)) {
+        log_error("Invalid saved map grid, the grid will be cleared", 0, (int) buf->size);
+        return 0;
+    }
+    if (saved_item_size != item_size) {
+        log_error("Unexpected item size of saved map grid, the grid will be cleared", 0, saved_item_size);
+        return 0;
+    }
+    set_grid_size(grid_size);
+    return 1;
 }
 
-void map_grid_copy_u16(const uint16_t *src, uint16_t *dst)
+void map_grid_save_state_u8(grid_u8 *grid, buffer *buf)
 {
-    memcpy(dst, src, GRID_SIZE * GRID_SIZE * sizeof(uint16_t));
+    map_grid_ensure_u8(grid);
+    save_state_header(buf, sizeof(uint8_t));
+    buffer_write_raw(buf, grid->items, map_grid_total_tiles());
 }
 
-void map_grid_copy_u32(const uint32_t *src, uint32_t *dst)
+void map_grid_save_state_i8(grid_i8 *grid, buffer *buf)
 {
-    memcpy(dst, src, GRID_SIZE * GRID_SIZE * sizeof(uint32_t));
+    map_grid_ensure_i8(grid);
+    save_state_header(buf, sizeof(int8_t));
+    buffer_write_raw(buf, grid->items, map_grid_total_tiles());
 }
 
-void map_grid_save_state_u8(const uint8_t *grid, buffer *buf)
+void map_grid_save_state_u16(grid_u16 *grid, buffer *buf)
 {
-    buffer_write_raw(buf, grid, GRID_SIZE * GRID_SIZE);
+    map_grid_ensure_u16(grid);
+    save_state_header(buf, sizeof(uint16_t));
+    int total_tiles = map_grid_total_tiles();
+    for (int i = 0; i < total_tiles; i++) {
+        buffer_write_u16(buf, grid->items[i]);
+    }
 }
 
-void map_grid_save_state_i8(const int8_t *grid, buffer *buf)
+void map_grid_save_state_u32_to_u16(grid_u32 *grid, buffer *buf)
 {
-    buffer_write_raw(buf, grid, GRID_SIZE * GRID_SIZE);
+    map_grid_ensure_u32(grid);
+    save_state_header(buf, sizeof(uint16_t));
+    int total_tiles = map_grid_total_tiles();
+    for (int i = 0; i < total_tiles; i++) {
+        buffer_write_u16(buf, (uint16_t) grid->items[i]);
+    }
 }
 
-void map_grid_save_state_u16(const uint16_t *grid, buffer *buf)
+void map_grid_save_state_u32(grid_u32 *grid, buffer *buf)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        buffer_write_u16(buf, grid[i]);
+    map_grid_ensure_u32(grid);
+    save_state_header(buf, sizeof(uint32_t));
+    int total_tiles = map_grid_total_tiles();
+    for (int i = 0; i < total_tiles; i++) {
+        buffer_write_u32(buf, grid->items[i]);
     }
 }
 
-void map_grid_save_state_u32_to_u16(const uint32_t *grid, buffer *buf)
+void map_grid_load_state_u8(grid_u8 *grid, buffer *buf)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        buffer_write_u16(buf, (uint16_t) grid[i]);
+    if (!load_state_header(buf, sizeof(uint8_t))) {
+        map_grid_clear_u8(grid);
+        return;
     }
+    map_grid_ensure_u8(grid);
+    buffer_read_raw(buf, grid->items, map_grid_total_tiles());
 }
 
-void map_grid_save_state_u32(const uint32_t *grid, buffer *buf)
+void map_grid_load_state_i8(grid_i8 *grid, buffer *buf)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        buffer_write_u32(buf, grid[i]);
+    if (!load_state_header(buf, sizeof(int8_t))) {
+        map_grid_clear_i8(grid);
+        return;
     }
+    map_grid_ensure_i8(grid);
+    buffer_read_raw(buf, grid->items, map_grid_total_tiles());
 }
 
-void map_grid_load_state_u8(uint8_t *grid, buffer *buf)
+void map_grid_load_state_u8_to_u16(grid_u16 *grid, buffer *buf)
 {
-    buffer_read_raw(buf, grid, GRID_SIZE * GRID_SIZE);
+    if (!load_state_header(buf, sizeof(uint8_t))) {
+        map_grid_clear_u16(grid);
+        return;
+    }
+    map_grid_ensure_u16(grid);
+    int total_tiles = map_grid_total_tiles();
+    for (int i = 0; i < total_tiles; i++) {
+        grid->items[i] = buffer_read_u8(buf);
+    }
 }
 
-void map_grid_load_state_i8(int8_t *grid, buffer *buf)
+void map_grid_load_state_u16(grid_u16 *grid, buffer *buf)
 {
-    buffer_read_raw(buf, grid, GRID_SIZE * GRID_SIZE);
+    if (!load_state_header(buf, sizeof(uint16_t))) {
+        map_grid_clear_u16(grid);
+        return;
+    }
+    map_grid_ensure_u16(grid);
+    int total_tiles = map_grid_total_tiles();
+    for (int i = 0; i < total_tiles; i++) {
+        grid->items[i] = buffer_read_u16(buf);
+    }
 }
 
-void map_grid_load_state_u16(uint16_t *grid, buffer *buf)
+void map_grid_load_state_u16_to_u32(grid_u32 *grid, buffer *buf)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        grid[i] = buffer_read_u16(buf);
+    if (!load_state_header(buf, sizeof(uint16_t))) {
+        map_grid_clear_u32(grid);
+        return;
+    }
+    map_grid_ensure_u32(grid);
+    int total_tiles = map_grid_total_tiles();
+    for (int i = 0; i < total_tiles; i++) {
+        grid->items[i] = buffer_read_u16(buf);
     }
 }
 
-void map_grid_load_state_u16_to_u32(uint32_t *grid, buffer *buf)
+void map_grid_load_state_u32(grid_u32 *grid, buffer *buf)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        grid[i] = buffer_read_u16(buf);
+    if (!load_state_header(buf, sizeof(uint32_t))) {
+        map_grid_clear_u32(grid);
+        return;
+    }
+    map_grid_ensure_u32(grid);
+    int total_tiles = map_grid_total_tiles();
+    for (int i = 0; i < total_tiles; i++) {
+        grid->items[i] = buffer_read_u32(buf);
     }
 }
 
-void map_grid_load_state_u32(uint32_t *grid, buffer *buf)
+int map_grid_seek_state(buffer *buf, int grid_offset)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        grid[i] = buffer_read_u32(buf);
+    int grid_size;
+    int item_size;
+    if (!read_state_header(buf, &grid_size, &item_size) ||
+        grid_offset < 0 || grid_offset >= grid_size * grid_size) {
+        return 0;
     }
+    buffer_skip(buf, grid_offset * item_size);
+    return item_size;
 }
@@ -6,47 +6,107 @@
 #include <stdint.h>
 
 enum {
-    GRID_SIZE = 162
+    /** Grid size of the original game, used by all files that do not store the grid size */
+    GRID_SIZE_LEGACY = 162,
+    /** Largest supported grid size, as buildings and figures store their grid offsets in 16 bits */
+    GRID_SIZE_MAX = 181
 };
-#define MAX_SLICE_SIZE GRID_SIZE * GRID_SIZE 
+
+/**
+ * A horizontal run of consecutive grid offsets
+ */
+typedef struct {
+    int grid_offset;
+    int length;
+} grid_slice_run;
+
 /**
  * Represents a collection of grid offsets
  *
- * Used to store multiple grid coordinates as a contiguous array of offsets,
- * for operations on groups of tiles - allows easy iteration through uneven shapes
+ * Used for operations on groups of tiles - allows easy iteration through uneven shapes.
+ * Rectangles are stored as their top-left offset and row length, any other shape as the
+ * runs of consecutive offsets it is made of. Use a grid_slice_iterator to visit the offsets.
  *
- * @var grid_offsets Array containing the grid offset positions
- * @var size 1-based count of valid entries in grid_offsets, 0 means empty arrray, 1 means [0] is valid, etc.
+ * @var size Number of tiles in the slice, 0 means the slice is empty
+ * @var row_length Width of the rectangle, 0 if the slice is stored as runs
+ * @var start_offset Top-left grid offset of the rectangle
+ * @var runs Runs of consecutive offsets, in iteration order, for slices that are not rectangles
+ * @var num_runs Number of valid entries in runs
+ * @var runs_capacity Number of allocated entries in runs
  */
 typedef struct grid_slice {
-    int grid_offsets[MAX_SLICE_SIZE];
     int size;
+    int row_length;
+    int start_offset;
+    grid_slice_run *runs;
+    int num_runs;
+    int runs_capacity;
 } grid_slice;
 
+/**
+ * Iterates over the offsets of a grid slice, row by row:
+ *
+ *     grid_slice_iterator it = map_grid_slice_iterate(slice);
+ *     while (map_grid_slice_next(&it)) {
+ *         do_something(it.grid_offset);
+ *     }
+ */
+typedef struct {
+    const grid_slice *slice;
+    int run;
+    int position;
+    int grid_offset;
+} grid_slice_iterator;
+
+/**
+ * Grids hold one item per tile, row by row, so neighbouring tiles stay at fixed offset deltas.
+ *
+ * The items are allocated by the first map_grid_* function the grid is passed to, and are
+ * reallocated and cleared whenever the grid size changes. Grids that are not cleared or loaded
+ * before they are first read must be set up with map_grid_ensure_*.
+ */
 typedef struct {
-    uint8_t items[GRID_SIZE * GRID_SIZE];
+    uint8_t *items;
 } grid_u8;
 
 typedef struct {
-    int8_t items[GRID_SIZE * GRID_SIZE];
+    int8_t *items;
 } grid_i8;
 
 typedef struct {
-    uint16_t items[GRID_SIZE * GRID_SIZE];
+    uint16_t *items;
 } grid_u16;
 
 typedef struct {
-    int16_t items[GRID_SIZE * GRID_SIZE];
+    int16_t *items;
 } grid_i16;
 
 typedef struct {
-    uint32_t items[GRID_SIZE * GRID_SIZE];
+    uint32_t *items;
 } grid_u32;
 
+/**
+ * @brief Sets up the grid for a map. The grid size is the map width plus the border size.
+ */
 void map_grid_init(int width, int height, int start_offset, int border_size);
 
+/**
+ * @brief Gets the number of tiles in a row of the grid, border included
+ */
+int map_grid_stride(void);
+
+/**
+ * @brief Gets the number of tiles in the grid, which is one more than the highest valid grid offset
+ */
+int map_grid_total_tiles(void);
+
 grid_slice *map_grid_get_grid_slice(int *grid_offsets, int size);
 
+/**
+ * @brief Empties the slice, keeping its memory for reuse
+ */
+void map_grid_slice_clear(grid_slice *slice);
+
 grid_slice *map_grid_get_grid_slice_from_corners(int start_x, int start_y, int end_x, int end_y);
 grid_slice *map_grid_get_grid_slice_from_corner_offsets(int corner_offset_1, int corner_offset_2);
 /** @brief Uses a loop instead of first and last position, since a grid slice is not ncessarily an ordered array
@@ -54,6 +114,24 @@ grid_slice *map_grid_get_grid_slice_from_corner_offsets(int corner_offset_1, int
  */
 int map_grid_get_corner_offsets_from_grid_slice(const grid_slice *slice, int *top_left_offset, int *bottom_right_offset);
 
+/**
+ * @brief Starts iterating over the offsets of the slice
+ * @param slice The slice, can be NULL
+ */
+grid_slice_iterator map_grid_slice_iterate(const grid_slice *slice);
+
+/**
+ * @brief Moves the iterator to the next offset of the slice, which is then stored in grid_offset
+ * @return 1 if there was a next offset, 0 if the iteration is over
+ */
+int map_grid_slice_next(grid_slice_iterator *it);
+
+/**
+ * @brief Gets the first and last offsets of the slice, in iteration order
+ * @return 1 on success, 0 if the slice is empty
+ */
+int map_grid_slice_get_first_and_last_offsets(const grid_slice *slice, int *first_offset, int *last_offset);
+
 int map_grid_is_valid_offset(int grid_offset);
 
 int map_grid_offset(int x, int y);
@@ -94,50 +172,74 @@ const int *map_grid_adjacent_offsets(int size);
 
 void map_grid_get_corner_tiles(int start_x, int start_y, int x, int y, int *c1x, int *c1y, int *c2x, int *c2y);
 
-void map_grid_clear_u8(uint8_t *grid);
+void map_grid_ensure_u8(grid_u8 *grid);
 
-void map_grid_clear_i8(int8_t *grid);
+void map_grid_ensure_i8(grid_i8 *grid);
 
-void map_grid_clear_u16(uint16_t *grid);
+void map_grid_ensure_u16(grid_u16 *grid);
 
-void map_grid_clear_i16(int16_t *grid);
+void map_grid_ensure_i16(grid_i16 *grid);
 
-void map_grid_clear_u32(uint32_t *grid);
+void map_grid_ensure_u32(grid_u32 *grid);
 
-void map_grid_init_i8(int8_t *grid, int8_t value);
+void map_grid_clear_u8(grid_u8 *grid);
 
-void map_grid_and_u8(uint8_t *grid, uint8_t mask);
+void map_grid_clear_i8(grid_i8 *grid);
 
-void map_grid_and_u16(uint16_t *grid, uint16_t mask);
+void map_grid_clear_u16(grid_u16 *grid);
 
-void map_grid_and_u32(uint32_t *grid, uint32_t mask);
+void map_grid_clear_i16(grid_i16 *grid);
 
-void map_grid_copy_u8(const uint8_t *src, uint8_t *dst);
+void map_grid_clear_u32(grid_u32 *grid);
 
-void map_grid_copy_u16(const uint16_t *src, uint16_t *dst);
+void map_grid_init_i8(grid_i8 *grid, int8_t value);
 
-void map_grid_copy_u32(const uint32_t *src, uint32_t *dst);
+void map_grid_and_u8(grid_u8 *grid, uint8_t mask);
 
+void map_grid_and_u16(grid_u16 *grid, uint16_t mask);
 
-void map_grid_save_state_u8(const uint8_t *grid, buffer *buf);
+void map_grid_and_u32(grid_u32 *grid, uint32_t mask);
 
-void map_grid_save_state_i8(const int8_t *grid, buffer *buf);
+void map_grid_copy_u8(grid_u8 *src, grid_u8 *dst);
 
-void map_grid_save_state_u16(const uint16_t *grid, buffer *buf);
+void map_grid_copy_u16(grid_u16 *src, grid_u16 *dst);
 
-void map_grid_save_state_u32_to_u16(const uint32_t *grid, buffer *buf);
+void map_grid_copy_u32(grid_u32 *src, grid_u32 *dst);
 
-void map_grid_save_state_u32(const uint32_t *grid, buffer *buf);
+/**
+ * Saved grids start with a header holding the grid state version, the grid size and the item size.
+ * Grids saved before the header was introduced are always GRID_SIZE_LEGACY in size and are still loaded.
+ * Loading a grid of a different size changes the grid size of all grids.
+ */
+void map_grid_save_state_u8(grid_u8 *grid, buffer *buf);
+
+void map_grid_save_state_i8(grid_i8 *grid, buffer *buf);
+
+void map_grid_save_state_u16(grid_u16 *grid, buffer *buf);
+
+void map_grid_save_state_u32_to_u16(grid_u32 *grid, buffer *buf);
 
-void map_grid_load_state_u8(uint8_t *grid, buffer *buf);
+void map_grid_save_state_u32(grid_u32 *grid, buffer *buf);
 
-void map_grid_load_state_i8(int8_t *grid, buffer *buf);
+void map_grid_load_state_u8(grid_u8 *grid, buffer *buf);
 
-void map_grid_load_state_u16(uint16_t *grid, buffer *buf);
+void map_grid_load_state_i8(grid_i8 *grid, buffer *buf);
 
-void map_grid_load_state_u16_to_u32(uint32_t *grid, buffer *buf);
+void map_grid_load_state_u8_to_u16(grid_u16 *grid, buffer *buf);
 
-void map_grid_load_state_u32(uint32_t *grid, buffer *buf);
+void map_grid_load_state_u16(grid_u16 *grid, buffer *buf);
+
+void map_grid_load_state_u16_to_u32(grid_u32 *grid, buffer *buf);
+
+void map_grid_load_state_u32(grid_u32 *grid, buffer *buf);
+
+/**
+ * @brief Moves the buffer of a saved grid to the item at the given grid offset, without loading the grid
+ * @param buf Buffer holding the saved grid
+ * @param grid_offset Grid offset in the saved grid
+ * @return Size of the item in bytes, or 0 if the saved grid is invalid or does not have the grid offset
+ */
+int map_grid_seek_state(buffer *buf, int grid_offset);
 
 /**
  * @brief Creates a grid slice representing a rectangular area starting from the given grid offset.
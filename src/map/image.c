@@ -25,12 +25,12 @@ void map_image_set(int grid_offset, int image_id)
 
 void map_image_backup(void)
 {
-    map_grid_copy_u32(images.items, images_backup.items);
+    map_grid_copy_u32(&images, &images_backup);
 }
 
 void map_image_restore(void)
 {
-    map_grid_copy_u32(images_backup.items, images.items);
+    map_grid_copy_u32(&images_backup, &images);
 }
 
 void map_image_restore_at(int grid_offset)
@@ -40,7 +40,8 @@ void map_image_restore_at(int grid_offset)
 
 void map_image_clear(void)
 {
-    map_grid_clear_u32(images.items);
+    map_grid_clear_u32(&images);
+    map_grid_ensure_u32(&images_backup);
 }
 
 void map_image_init_edges(void)
@@ -86,10 +87,10 @@ void map_image_update_all(void)
 
 void map_image_save_state_legacy(buffer *buf)
 {
-    map_grid_save_state_u32_to_u16(images.items, buf);
+    map_grid_save_state_u32_to_u16(&images, buf);
 }
 
 void map_image_load_state_legacy(buffer *buf)
 {
-    map_grid_load_state_u16_to_u32(images.items, buf);
+    map_grid_load_state_u16_to_u32(&images, buf);
 }
@@ -9,6 +9,7 @@
 #include "map/terrain.h"
 
 #define MAX_TILES 8
+#define MAX_TILE_MASKS (1 << MAX_TILES)
 
 struct terrain_image_context {
     const unsigned char tiles[MAX_TILES];
@@ -291,6 +292,12 @@ static struct {
     {terrain_images_aqueduct, 16}
 };
 
+// For each context and each combination of matching neighbour tiles, index + 1 of the first matching item
+static struct {
+    unsigned char first_match[CONTEXT_MAX_ITEMS][MAX_TILE_MASKS];
+    int initialized;
+} lookup;
+
 static void clear_current_offset(struct terrain_image_context *items, int num_items)
 {
     for (int i = 0; i < num_items; i++) {
@@ -325,25 +332,53 @@ static int context_matches_tiles(const struct terrain_image_context *context, co
     return 1;
 }
 
+static void init_lookup(void)
+{
+    int tiles[MAX_TILES];
+    for (int group = 0; group < CONTEXT_MAX_ITEMS; group++) {
+        const struct terrain_image_context *context = context_pointers[group].context;
+        int size = context_pointers[group].size;
+        for (int mask = 0; mask < MAX_TILE_MASKS; mask++) {
+            for (int i = 0; i < MAX_TILES; i++) {
+                tiles[i] = (mask >> i) & 1;
+            }
+            lookup.first_match[group][mask] = 0;
+            for (int i = 0; i < size; i++) {
+                if (context_matches_tiles(&context[i], tiles)) {
+                    lookup.first_match[group][mask] = i + 1;
+                    break;
+                }
+            }
+        }
+    }
+    lookup.initialized = 1;
+}
+
 static const terrain_image *get_image(int group, int tiles[MAX_TILES])
 {
     static terrain_image result;
 
+    if (!lookup.initialized) {
+        init_lookup();
+    }
+    int mask = 0;
+    for (int i = 0; i < MAX_TILES; i++) {
+        if (tiles[i]) {
+            mask |= 1 << i;
+        }
+    }
     result.is_valid = 0;
-    struct terrain_image_context *context = context_pointers[group].context;
-    int size = context_pointers[group].size;
-    for (int i = 0; i < size; i++) {
-        if (context_matches_tiles(&context[i], tiles)) {
-            context[i].current_item_offset++;
-            if (context[i].current_item_offset >= context[i].max_item_offset) {
-                context[i].current_item_offset = 0;
-            }
-            result.is_valid = 1;
-            result.group_offset = context[i].offset_for_orientation[city_view_orientation() / 2];
-            result.item_offset = context[i].current_item_offset;
-            result.aqueduct_offset = context[i].aqueduct_offset;
-            break;
+    int match = lookup.first_match[group][mask];
+    if (match) {
+        struct terrain_image_context *context = &context_pointers[group].context[match - 1];
+        context->current_item_offset++;
+        if (context->current_item_offset >= context->max_item_offset) {
+            context->current_item_offset = 0;
         }
+        result.is_valid = 1;
+        result.group_offset = context->offset_for_orientation[city_view_orientation() / 2];
+        result.item_offset = context->current_item_offset;
+        result.aqueduct_offset = context->aqueduct_offset;
     }
     return &result;
 }
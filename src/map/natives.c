@@ -155,7 +155,7 @@ void map_natives_init(void)
             }
             building *b = building_create(type, x, y);
             map_building_set(grid_offset, b->id);
-            b->state = BUILDING_STATE_IN_USE;
+            building_set_state(b, BUILDING_STATE_IN_USE);
             switch (type) {
                 case BUILDING_NATIVE_CROPS:
                     b->data.industry.progress = random_bit;
@@ -240,7 +240,7 @@ void map_natives_init_editor(void)
                 continue;
             }
             building *b = building_create(type, x, y);
-            b->state = BUILDING_STATE_IN_USE;
+            building_set_state(b, BUILDING_STATE_IN_USE);
             map_building_set(grid_offset, b->id);
             if (type == BUILDING_NATIVE_MEETING) {
                 map_building_set(grid_offset + map_grid_delta(1, 0), b->id);
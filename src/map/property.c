@@ -51,7 +51,9 @@ int map_property_is_draw_tile(int grid_offset)
 
 int map_property_is_draw_tile_from_buffer(buffer *edge, int grid_offset)
 {
-    buffer_set(edge, grid_offset);
+    if (!map_grid_seek_state(edge, grid_offset)) {
+        return 0;
+    }
     return buffer_read_u8(edge) & EDGE_LEFTMOST_TILE;
 }
 
@@ -77,7 +79,7 @@ void map_property_mark_native_land(int grid_offset)
 
 void map_property_clear_all_native_land(void)
 {
-    map_grid_and_u8(edge_grid.items, EDGE_NO_NATIVE_LAND);
+    map_grid_and_u8(&edge_grid, EDGE_NO_NATIVE_LAND);
 }
 
 int map_property_multi_tile_xy(int grid_offset)
@@ -129,8 +131,11 @@ int map_property_multi_tile_size(int grid_offset)
 
 int map_property_multi_tile_size_from_buffer(buffer *bitfields, int grid_offset)
 {
-    buffer_set(bitfields, grid_offset);
-    switch (buffer_read_u16(bitfields) & BIT_SIZES) {
+    if (!map_grid_seek_state(bitfields, grid_offset)) {
+        return 1;
+    }
+    // the sizes are in the lowest byte, which is stored first for both 8 and 16 bit bitfields
+    switch (buffer_read_u8(bitfields) & BIT_SIZES) {
         case BIT_SIZE2: return 2;
         case BIT_SIZE3: return 3;
         case BIT_SIZE4: return 4;
@@ -219,7 +224,7 @@ void map_property_clear_deleted(int grid_offset)
 
 void map_property_clear_constructing_and_deleted(void)
 {
-    map_grid_and_u16(bitfields_grid.items, BIT_NO_CONSTRUCTION_AND_DELETED);
+    map_grid_and_u16(&bitfields_grid, BIT_NO_CONSTRUCTION_AND_DELETED);
 }
 
 int map_property_is_future_earthquake(int grid_offset)
@@ -239,41 +244,37 @@ void map_property_clear_future_earthquake(int grid_offset)
 
 void map_property_clear(void)
 {
-    map_grid_clear_u16(bitfields_grid.items);
-    map_grid_clear_u8(edge_grid.items);
+    map_grid_clear_u16(&bitfields_grid);
+    map_grid_clear_u8(&edge_grid);
 }
 
 void map_property_backup(void)
 {
-    map_grid_copy_u16(bitfields_grid.items, bitfields_backup.items);
-    map_grid_copy_u8(edge_grid.items, edge_backup.items);
+    map_grid_copy_u16(&bitfields_grid, &bitfields_backup);
+    map_grid_copy_u8(&edge_grid, &edge_backup);
 }
 
 void map_property_restore(void)
 {
-    map_grid_copy_u16(bitfields_backup.items, bitfields_grid.items);
-    map_grid_copy_u8(edge_backup.items, edge_grid.items);
+    map_grid_copy_u16(&bitfields_backup, &bitfields_grid);
+    map_grid_copy_u8(&edge_backup, &edge_grid);
 }
 
 void map_property_save_state(buffer *bitfields, buffer *edge)
 {
-    map_grid_save_state_u16(bitfields_grid.items, bitfields);
-    map_grid_save_state_u8(edge_grid.items, edge);
+    map_grid_save_state_u16(&bitfields_grid, bitfields);
+    map_grid_save_state_u8(&edge_grid, edge);
 }
 
 void map_property_load_state(buffer *bitfields, buffer *edge)
 {
-    map_grid_load_state_u16(bitfields_grid.items, bitfields);
-    map_grid_load_state_u8(edge_grid.items, edge);
+    map_grid_load_state_u16(&bitfields_grid, bitfields);
+    map_grid_load_state_u8(&edge_grid, edge);
 }
 
 void map_property_load_state_u8(buffer *bitfields, buffer *edge)
 {
-    uint8_t buf[GRID_SIZE * GRID_SIZE];
-    map_grid_load_state_u8(buf, bitfields);
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        uint16_t value = (uint16_t) buf[i];
-        bitfields_grid.items[i] = value &= BIT_NO_FUTURE_EARTHQUAKE;
-    }
-    map_grid_load_state_u8(edge_grid.items, edge);
+    map_grid_load_state_u8_to_u16(&bitfields_grid, bitfields);
+    map_grid_and_u16(&bitfields_grid, BIT_NO_FUTURE_EARTHQUAKE);
+    map_grid_load_state_u8(&edge_grid, edge);
 }
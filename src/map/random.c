@@ -7,17 +7,16 @@ static grid_u8 random;
 
 void map_random_clear(void)
 {
-    map_grid_clear_u8(random.items);
+    map_grid_clear_u8(&random);
 }
 
 void map_random_init(void)
 {
-    int grid_offset = 0;
-    for (int y = 0; y < GRID_SIZE; y++) {
-        for (int x = 0; x < GRID_SIZE; x++, grid_offset++) {
-            random_generate_next();
-            random.items[grid_offset] = (uint8_t) random_short();
-        }
+    map_grid_ensure_u8(&random);
+    int total_tiles = map_grid_total_tiles();
+    for (int grid_offset = 0; grid_offset < total_tiles; grid_offset++) {
+        random_generate_next();
+        random.items[grid_offset] = (uint8_t) random_short();
     }
 }
 
@@ -28,16 +27,18 @@ int map_random_get(int grid_offset)
 
 int map_random_get_from_buffer(buffer *buf, int grid_offset)
 {
-    buffer_set(buf, grid_offset);
+    if (!map_grid_seek_state(buf, grid_offset)) {
+        return 0;
+    }
     return buffer_read_u8(buf);
 }
 
 void map_random_save_state(buffer *buf)
 {
-    map_grid_save_state_u8(random.items, buf);
+    map_grid_save_state_u8(&random, buf);
 }
 
 void map_random_load_state(buffer *buf)
 {
-    map_grid_load_state_u8(random.items, buf);
+    map_grid_load_state_u8(&random, buf);
 }
@@ -6,8 +6,18 @@
 static struct {
     ring_tile tiles[3000];
     int index[8][9];
+    int total_tiles;
+    int grid_size;
 } data;
 
+static void calculate_grid_offsets(void)
+{
+    for (int i = 0; i < data.total_tiles; i++) {
+        data.tiles[i].grid_offset = map_grid_delta(data.tiles[i].x, data.tiles[i].y);
+    }
+    data.grid_size = map_grid_stride();
+}
+
 void map_ring_init(void)
 {
     int index = 0;
@@ -42,9 +52,8 @@ void map_ring_init(void)
             }
         }
     }
-    for (int i = 0; i < index; i++) {
-        data.tiles[i].grid_offset = map_grid_delta(data.tiles[i].x, data.tiles[i].y);
-    }
+    data.total_tiles = index;
+    calculate_grid_offsets();
 }
 
 int map_ring_start(int size, int distance)
@@ -65,5 +74,8 @@ int map_ring_is_inside_map(int x, int y)
 
 const ring_tile *map_ring_tile(int index)
 {
+    if (data.grid_size != map_grid_stride()) {
+        calculate_grid_offsets();
+    }
     return &data.tiles[index];
 }
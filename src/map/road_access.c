@@ -14,6 +14,16 @@
 #include "map/terrain.h"
 #include "map/tiles.h"
 
+#define ROAMING_TILE_KNOWN 0x8000
+#define ROAMING_TILE_NEAR_BUILDING 0x4000
+#define ROAMING_TILE_DIAGONAL_SHIFT 4
+#define ROAMING_TILE_STRETCH_SHIFT 8
+
+// Per tile: which neighbours are road for roaming (bits 0-3 for directions 0, 2, 4, 6, bits 4-7 for 1, 3, 5, 7)
+// and the longest stretch of road around it. Only filled in when no adjacent tile is a building, since
+// roadblocks, granaries and warehouses depend on the walker's permissions and the building's state.
+static grid_u16 roaming_tiles;
+
 static void find_minimum_road_tile(int x, int y, int size, int *min_value, int *min_grid_offset)
 {
     int base_offset = map_grid_offset(x, y);
@@ -550,10 +560,82 @@ static int get_adjacent_road_tile_for_roaming(int grid_offset, roadblock_permiss
     return is_road;
 }
 
+static int get_diagonal_road_stretch(const int *road_tiles)
+{
+    int max_stretch = 0;
+    int stretch = 0;
+    for (int i = 0; i < 16; i++) {
+        if (road_tiles[i % 8]) {
+            stretch++;
+            if (stretch > max_stretch) {
+                max_stretch = stretch;
+            }
+        } else {
+            stretch = 0;
+        }
+    }
+    return max_stretch;
+}
+
+static int get_roaming_tile_info(int grid_offset)
+{
+    int info = roaming_tiles.items[grid_offset];
+    if (info & ROAMING_TILE_KNOWN) {
+        return info;
+    }
+    const int deltas[8] = {
+        map_grid_delta(0, -1), map_grid_delta(1, -1), map_grid_delta(1, 0), map_grid_delta(1, 1),
+        map_grid_delta(0, 1), map_grid_delta(-1, 1), map_grid_delta(-1, 0), map_grid_delta(-1, -1)
+    };
+    int road_tiles[8];
+    info = ROAMING_TILE_KNOWN;
+    for (int dir = 0; dir < 8; dir++) {
+        int offset = grid_offset + deltas[dir];
+        if (dir % 2 == 0 && map_terrain_is(offset, TERRAIN_BUILDING)) {
+            info |= ROAMING_TILE_NEAR_BUILDING;
+            roaming_tiles.items[grid_offset] = info;
+            return info;
+        }
+        road_tiles[dir] = terrain_is_road_like(offset);
+        if (road_tiles[dir]) {
+            info |= 1 << (dir % 2 ? ROAMING_TILE_DIAGONAL_SHIFT + dir / 2 : dir / 2);
+        }
+    }
+    info |= get_diagonal_road_stretch(road_tiles) << ROAMING_TILE_STRETCH_SHIFT;
+    roaming_tiles.items[grid_offset] = info;
+    return info;
+}
+
+void map_road_invalidate_roaming_tiles(int grid_offset)
+{
+    for (int y = -1; y <= 1; y++) {
+        for (int x = -1; x <= 1; x++) {
+            int offset = grid_offset + map_grid_delta(x, y);
+            if (map_grid_is_valid_offset(offset)) {
+                roaming_tiles.items[offset] = 0;
+            }
+        }
+    }
+}
+
+void map_road_clear_roaming_tiles(void)
+{
+    map_grid_clear_u16(&roaming_tiles);
+}
+
 int map_get_adjacent_road_tiles_for_roaming(int grid_offset, int *road_tiles, int perm)
 {
     road_tiles[1] = road_tiles[3] = road_tiles[5] = road_tiles[7] = 0;
 
+    int info = get_roaming_tile_info(grid_offset);
+    if (!(info & ROAMING_TILE_NEAR_BUILDING)) {
+        road_tiles[0] = info & 1;
+        road_tiles[2] = (info >> 1) & 1;
+        road_tiles[4] = (info >> 2) & 1;
+        road_tiles[6] = (info >> 3) & 1;
+        return road_tiles[0] + road_tiles[2] + road_tiles[4] + road_tiles[6];
+    }
+
     road_tiles[0] = get_adjacent_road_tile_for_roaming(grid_offset + map_grid_delta(0, -1), perm);
     road_tiles[2] = get_adjacent_road_tile_for_roaming(grid_offset + map_grid_delta(1, 0), perm);
     road_tiles[4] = get_adjacent_road_tile_for_roaming(grid_offset + map_grid_delta(0, 1), perm);
@@ -564,22 +646,20 @@ int map_get_adjacent_road_tiles_for_roaming(int grid_offset, int *road_tiles, in
 
 int map_get_diagonal_road_tiles_for_roaming(int grid_offset, int *road_tiles)
 {
+    int info = get_roaming_tile_info(grid_offset);
+    // the stored stretch is only valid for the unmodified result of map_get_adjacent_road_tiles_for_roaming
+    if (!(info & ROAMING_TILE_NEAR_BUILDING) && road_tiles[0] == (info & 1) && road_tiles[2] == ((info >> 1) & 1) &&
+        road_tiles[4] == ((info >> 2) & 1) && road_tiles[6] == ((info >> 3) & 1)) {
+        road_tiles[1] = (info >> ROAMING_TILE_DIAGONAL_SHIFT) & 1;
+        road_tiles[3] = (info >> (ROAMING_TILE_DIAGONAL_SHIFT + 1)) & 1;
+        road_tiles[5] = (info >> (ROAMING_TILE_DIAGONAL_SHIFT + 2)) & 1;
+        road_tiles[7] = (info >> (ROAMING_TILE_DIAGONAL_SHIFT + 3)) & 1;
+        return (info >> ROAMING_TILE_STRETCH_SHIFT) & 0xf;
+    }
     road_tiles[1] = terrain_is_road_like(grid_offset + map_grid_delta(1, -1));
     road_tiles[3] = terrain_is_road_like(grid_offset + map_grid_delta(1, 1));
     road_tiles[5] = terrain_is_road_like(grid_offset + map_grid_delta(-1, 1));
     road_tiles[7] = terrain_is_road_like(grid_offset + map_grid_delta(-1, -1));
 
-    int max_stretch = 0;
-    int stretch = 0;
-    for (int i = 0; i < 16; i++) {
-        if (road_tiles[i % 8]) {
-            stretch++;
-            if (stretch > max_stretch) {
-                max_stretch = stretch;
-            }
-        } else {
-            stretch = 0;
-        }
-    }
-    return max_stretch;
+    return get_diagonal_road_stretch(road_tiles);
 }
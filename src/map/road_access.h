@@ -38,6 +38,18 @@ int map_road_to_largest_network_monument_construction(int x, int y, int size, in
 
 int map_get_adjacent_road_tiles_for_roaming(int grid_offset, int *road_tiles, int p);
 
+/**
+ * Forgets the roaming information of the tile and its neighbours, must be called when
+ * the road, access ramp or building terrain of the tile changes
+ * @param grid_offset The changed tile
+ */
+void map_road_invalidate_roaming_tiles(int grid_offset);
+
+/**
+ * Forgets the roaming information of all tiles
+ */
+void map_road_clear_roaming_tiles(void);
+
 int map_get_diagonal_road_tiles_for_roaming(int grid_offset, int *road_tiles);
 
 #endif // MAP_ROAD_ACCESS_H
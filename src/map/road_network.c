@@ -10,8 +10,6 @@
 
 #define MAX_QUEUE 1000
 
-static const int ADJACENT_OFFSETS[] = {-GRID_SIZE, 1, GRID_SIZE, -1};
-
 static grid_u8 network;
 
 static struct {
@@ -22,7 +20,7 @@ static struct {
 
 void map_road_network_clear(void)
 {
-    map_grid_clear_u8(network.items);
+    map_grid_clear_u8(&network);
 }
 
 int map_road_network_get(int grid_offset)
@@ -33,17 +31,18 @@ int map_road_network_get(int grid_offset)
 static int mark_road_network(int grid_offset, uint8_t network_id)
 {
     memset(&queue, 0, sizeof(queue));
+    const int adjacent_offsets[] = { map_grid_delta(0, -1), 1, map_grid_delta(0, 1), -1 };
     int guard = 0;
     int next_offset;
     int size = 1;
     do {
-        if (++guard >= GRID_SIZE * GRID_SIZE) {
+        if (++guard >= map_grid_total_tiles()) {
             break;
         }
         network.items[grid_offset] = network_id;
         next_offset = -1;
         for (int i = 0; i < 4; i++) {
-            int new_offset = grid_offset + ADJACENT_OFFSETS[i];
+            int new_offset = grid_offset + adjacent_offsets[i];
             if (map_routing_citizen_is_passable(new_offset) && !network.items[new_offset]) {
                 if (
                     map_routing_citizen_is_road(new_offset) ||
@@ -80,7 +79,7 @@ static int mark_road_network(int grid_offset, uint8_t network_id)
 void map_road_network_update(void)
 {
     city_map_clear_largest_road_networks();
-    map_grid_clear_u8(network.items);
+    map_grid_clear_u8(&network);
     int network_id = 1;
     int grid_offset = map_data.start_offset;
     for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
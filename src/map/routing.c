@@ -1,6 +1,7 @@
 #include "routing.h"
 
 #include "building/building.h"
+#include "core/log.h"
 #include "core/time.h"
 #include "map/building.h"
 #include "map/figure.h"
@@ -12,7 +13,6 @@
 
 #include <stdlib.h>
 
-#define MAX_QUEUE GRID_SIZE * GRID_SIZE
 #define GUARD 50000
 
 #define UNTIL_STOP 0
@@ -23,7 +23,8 @@ typedef enum {
     DIRECTIONS_DIAGONALS = 8
 } max_directions;
 
-static const int ROUTE_OFFSETS[] = { -162, 1, 162, -1, -161, 163, 161, -163 };
+// Directions of the route offsets, in the order of ROUTE_OFFSETS_X and ROUTE_OFFSETS_Y
+static const int ROUTE_DIRECTIONS[] = { 0, 2, 4, 6, 1, 3, 5, 7 };
 static const int ROUTE_OFFSETS_X[] = { 0, 1, 0, -1,  1, 1, -1, -1 };
 static const int ROUTE_OFFSETS_Y[] = { -1, 0, 1,  0, -1, 1,  1, -1 };
 static const int HIGHWAY_DIRECTIONS[] = {
@@ -47,7 +48,9 @@ static struct {
 static struct {
     int head;
     int tail;
-    int items[MAX_QUEUE];
+    int capacity;
+    int *items;
+    int route_offsets[8];
 } queue;
 
 static grid_u8 water_drag;
@@ -66,7 +69,7 @@ static void reset_fighting_status(void)
 {
     time_millis current_time = time_get_millis();
     if (current_time != fighting_data.last_check) {
-        map_grid_clear_u8(fighting_data.status.items);
+        map_grid_clear_u8(&fighting_data.status);
         fighting_data.last_check = current_time;
     }
 }
@@ -76,11 +79,31 @@ const map_routing_distance_grid *map_routing_get_distance_grid(void)
     return &distance;
 }
 
+static void resize_queue(void)
+{
+    int total_tiles = map_grid_total_tiles();
+    if (queue.capacity == total_tiles) {
+        return;
+    }
+    free(queue.items);
+    queue.items = malloc(sizeof(int) * total_tiles);
+    if (!queue.items) {
+        log_error("Unable to allocate memory for the routing queue", 0, total_tiles);
+        queue.capacity = 0;
+        return;
+    }
+    queue.capacity = total_tiles;
+    for (int i = 0; i < 8; i++) {
+        queue.route_offsets[i] = map_grid_direction_delta(ROUTE_DIRECTIONS[i]);
+    }
+}
+
 static void clear_data(void)
 {
+    resize_queue();
     reset_fighting_status();
-    map_grid_clear_i16(distance.possible.items);
-    map_grid_clear_i16(distance.determined.items);
+    map_grid_clear_i16(&distance.possible);
+    map_grid_clear_i16(&distance.determined);
     queue.head = 0;
     queue.tail = 0;
 }
@@ -89,7 +112,7 @@ static inline void enqueue(int next_offset, int dist)
 {
     distance.determined.items[next_offset] = dist;
     queue.items[queue.tail++] = next_offset;
-    if (queue.tail >= MAX_QUEUE) {
+    if (queue.tail >= queue.capacity) {
         queue.tail = 0;
     }
 }
@@ -97,7 +120,7 @@ static inline void enqueue(int next_offset, int dist)
 static inline int queue_pop(void)
 {
     int result = queue.items[queue.head];
-    if (++queue.head >= MAX_QUEUE) {
+    if (++queue.head >= queue.capacity) {
         queue.head = 0;
     }
     return result;
@@ -217,7 +240,7 @@ static void route_queue_from_to(int src_x, int src_y, int dst_x, int dst_y, int
         int y = map_grid_offset_to_y(offset);
         distance.possible.items[offset] = 1;
         for (int i = 0; i < num_directions; i++) {
-            int next_offset = offset + ROUTE_OFFSETS[i];
+            int next_offset = offset + queue.route_offsets[i];
             int remaining_dist = distance_left(x + ROUTE_OFFSETS_X[i], y + ROUTE_OFFSETS_Y[i]);
             int dist = 2 + distance.determined.items[offset];
             if (receive_highway_bonus(next_offset, i)) {
@@ -234,7 +257,7 @@ static void route_queue_all_from(int source, max_directions directions,
     int (*callback)(int next_offset, int dist, int direction), int is_boat)
 {
     clear_data();
-    map_grid_clear_u8(water_drag.items);
+    map_grid_clear_u8(&water_drag);
     enqueue(source, 1);
     int tiles = 0;
     while (queue.head != queue.tail) {
@@ -246,13 +269,13 @@ static void route_queue_all_from(int source, max_directions directions,
         if (water_drag.items[offset] < drag) {
             water_drag.items[offset]++;
             queue.items[queue.tail++] = offset;
-            if (queue.tail >= MAX_QUEUE) {
+            if (queue.tail >= queue.capacity) {
                 queue.tail = 0;
             }
         } else {
             int dist = 1 + distance.determined.items[offset];
             for (max_directions i = 0; i < directions; i++) {
-                int route_offset = ROUTE_OFFSETS[i];
+                int route_offset = queue.route_offsets[i];
                 int next_offset = offset + route_offset;
                 if (valid_offset(next_offset, dist)) {
                     if (callback(next_offset, dist, i) == UNTIL_STOP) {
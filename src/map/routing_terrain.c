@@ -101,7 +101,7 @@ static int get_land_type_citizen_aqueduct(int grid_offset)
 
 void map_routing_update_land_citizen(void)
 {
-    map_grid_init_i8(terrain_land_citizen.items, -1);
+    map_grid_init_i8(&terrain_land_citizen, -1);
     int grid_offset = map_data.start_offset;
     for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
         for (int x = 0; x < map_data.width; x++, grid_offset++) {
@@ -191,7 +191,7 @@ static int get_land_type_noncitizen(int grid_offset)
 
 static void map_routing_update_land_noncitizen(void)
 {
-    map_grid_init_i8(terrain_land_noncitizen.items, -1);
+    map_grid_init_i8(&terrain_land_noncitizen, -1);
     int grid_offset = map_data.start_offset;
     for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
         for (int x = 0; x < map_data.width; x++, grid_offset++) {
@@ -229,7 +229,7 @@ static int is_surrounded_by_water(int grid_offset)
 
 void map_routing_update_water(void)
 {
-    map_grid_init_i8(terrain_water.items, -1);
+    map_grid_init_i8(&terrain_water, -1);
     int grid_offset = map_data.start_offset;
     for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
         for (int x = 0; x < map_data.width; x++, grid_offset++) {
@@ -293,7 +293,7 @@ static int count_adjacent_wall_tiles(int grid_offset)
 
 void map_routing_update_walls(void)
 {
-    map_grid_init_i8(terrain_walls.items, -1);
+    map_grid_init_i8(&terrain_walls, -1);
     int grid_offset = map_data.start_offset;
     for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
         for (int x = 0; x < map_data.width; x++, grid_offset++) {
@@ -32,27 +32,27 @@ void map_sprite_clear_tile(int grid_offset)
 
 void map_sprite_clear(void)
 {
-    map_grid_clear_u8(sprite.items);
+    map_grid_clear_u8(&sprite);
 }
 
 void map_sprite_backup(void)
 {
-    map_grid_copy_u8(sprite.items, sprite_backup.items);
+    map_grid_copy_u8(&sprite, &sprite_backup);
 }
 
 void map_sprite_restore(void)
 {
-    map_grid_copy_u8(sprite_backup.items, sprite.items);
+    map_grid_copy_u8(&sprite_backup, &sprite);
 }
 
 void map_sprite_save_state(buffer *buf, buffer *backup)
 {
-    map_grid_save_state_u8(sprite.items, buf);
-    map_grid_save_state_u8(sprite_backup.items, backup);
+    map_grid_save_state_u8(&sprite, buf);
+    map_grid_save_state_u8(&sprite_backup, backup);
 }
 
 void map_sprite_load_state(buffer *buf, buffer *backup)
 {
-    map_grid_load_state_u8(sprite.items, buf);
-    map_grid_load_state_u8(sprite_backup.items, backup);
+    map_grid_load_state_u8(&sprite, buf);
+    map_grid_load_state_u8(&sprite_backup, backup);
 }
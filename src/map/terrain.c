@@ -8,9 +8,13 @@
 #include "map/building.h"
 #include "map/grid.h"
 #include "map/ring.h"
+#include "map/road_access.h"
 #include "map/routing.h"
 #include "map/sprite.h"
 
+// terrain types that decide where walkers can roam
+#define TERRAIN_ROAMING (TERRAIN_ROAD | TERRAIN_ACCESS_RAMP | TERRAIN_BUILDING)
+
 static grid_u32 terrain_grid;
 static grid_u32 terrain_grid_backup;
 
@@ -77,28 +81,41 @@ int map_terrain_get(int grid_offset)
 
 int map_terrain_get_from_buffer_16(buffer *buf, int grid_offset)
 {
-    buffer_set(buf, grid_offset * sizeof(uint16_t));
+    if (!map_grid_seek_state(buf, grid_offset)) {
+        return 0;
+    }
     return buffer_read_u16(buf);
 }
 
 int map_terrain_get_from_buffer_32(buffer *buf, int grid_offset)
 {
-    buffer_set(buf, grid_offset * sizeof(uint32_t));
+    if (!map_grid_seek_state(buf, grid_offset)) {
+        return 0;
+    }
     return buffer_read_u32(buf);
 }
 
 void map_terrain_set(int grid_offset, int terrain)
 {
+    if ((terrain_grid.items[grid_offset] ^ terrain) & TERRAIN_ROAMING) {
+        map_road_invalidate_roaming_tiles(grid_offset);
+    }
     terrain_grid.items[grid_offset] = terrain;
 }
 
 void map_terrain_add(int grid_offset, int terrain)
 {
+    if (terrain & ~terrain_grid.items[grid_offset] & TERRAIN_ROAMING) {
+        map_road_invalidate_roaming_tiles(grid_offset);
+    }
     terrain_grid.items[grid_offset] |= terrain;
 }
 
 void map_terrain_remove(int grid_offset, int terrain)
 {
+    if (terrain & terrain_grid.items[grid_offset] & TERRAIN_ROAMING) {
+        map_road_invalidate_roaming_tiles(grid_offset);
+    }
     terrain_grid.items[grid_offset] &= ~terrain;
 }
 
@@ -128,7 +145,10 @@ void map_terrain_remove_with_radius(int x, int y, int size, int radius, int terr
 
 void map_terrain_remove_all(int terrain)
 {
-    map_grid_and_u32(terrain_grid.items, ~terrain);
+    map_grid_and_u32(&terrain_grid, ~terrain);
+    if (terrain & TERRAIN_ROAMING) {
+        map_road_clear_roaming_tiles();
+    }
 }
 
 int map_terrain_count_directly_adjacent_with_type(int grid_offset, int terrain)
@@ -444,75 +464,77 @@ void map_terrain_add_triumphal_arch_roads(int x, int y, int orientation)
 
 void map_terrain_backup(void)
 {
-    map_grid_copy_u32(terrain_grid.items, terrain_grid_backup.items);
+    map_grid_copy_u32(&terrain_grid, &terrain_grid_backup);
 }
 
 void map_terrain_restore(void)
 {
-    map_grid_copy_u32(terrain_grid_backup.items, terrain_grid.items);
+    map_grid_copy_u32(&terrain_grid_backup, &terrain_grid);
+    map_road_clear_roaming_tiles();
 }
 
 void map_terrain_clear(void)
 {
-    map_grid_clear_u32(terrain_grid.items);
+    map_grid_clear_u32(&terrain_grid);
+    map_road_clear_roaming_tiles();
 }
 
 void map_terrain_init_outside_map(void)
 {
     int map_width, map_height;
     map_grid_size(&map_width, &map_height);
-    int y_start = (GRID_SIZE - map_height) / 2;
-    int x_start = (GRID_SIZE - map_width) / 2;
-    for (int y = 0; y < GRID_SIZE; y++) {
+    int grid_size = map_grid_stride();
+    int y_start = map_grid_offset(0, 0) / grid_size;
+    int x_start = map_grid_offset(0, 0) % grid_size;
+    map_grid_ensure_u32(&terrain_grid);
+    for (int y = 0; y < grid_size; y++) {
         int y_outside_map = y < y_start || y >= y_start + map_height;
-        for (int x = 0; x < GRID_SIZE; x++) {
+        for (int x = 0; x < grid_size; x++) {
             if (y_outside_map || x < x_start || x >= x_start + map_width) {
-                terrain_grid.items[x + GRID_SIZE * y] = TERRAIN_MAP_EDGE;
+                terrain_grid.items[x + grid_size * y] = TERRAIN_MAP_EDGE;
             }
         }
     }
+    map_road_clear_roaming_tiles();
 }
 
 void map_terrain_save_state(buffer *buf)
 {
-    map_grid_save_state_u32(terrain_grid.items, buf);
+    map_grid_save_state_u32(&terrain_grid, buf);
 }
 
 void map_terrain_save_state_legacy(buffer *buf)
 {
-    map_grid_save_state_u32_to_u16(terrain_grid.items, buf);
+    map_grid_save_state_u32_to_u16(&terrain_grid, buf);
 }
 
 static void determine_original_trees(buffer *images, int legacy_buffer)
 {
-    for (int y = 0; y < GRID_SIZE; y++) {
-        for (int x = 0; x < GRID_SIZE; x++) {
-            if (terrain_grid.items[x + GRID_SIZE * y] & TERRAIN_TREE &&
-                !(terrain_grid.items[x + GRID_SIZE * y] & TERRAIN_WATER)) {
-                terrain_grid.items[x + GRID_SIZE * y] |= TERRAIN_ORIGINALLY_TREE;
-                if (images) {
-                    buffer_set(images, (x + GRID_SIZE * y) * (legacy_buffer ? 2 : 4));
-                    int image_id = legacy_buffer ? buffer_read_u16(images) : buffer_read_u32(images);
-                    int image_tree_group = image_group(GROUP_TERRAIN_TREE);
-                    int ring;
-                    if (image_id >= image_tree_group + 8 && image_id < image_tree_group + 16) {
-                        ring = 1;
-                    } else if (image_id >= image_tree_group + 16 && image_id < image_tree_group + 24) {
-                        ring = 2;
-                    } else if (image_id >= image_tree_group + 24 && image_id < image_tree_group + 32) {
-                        ring = 3;
-                    } else {
-                        continue;
-                    }
-                    int start = map_ring_start(1, ring);
-                    int end = map_ring_end(1, ring);
-                    int base_offset = x + GRID_SIZE * y;
-                    for (int i = start; i < end; i++) {
-                        int current_offset = base_offset + map_ring_tile(i)->grid_offset;
-                        if (map_grid_is_valid_offset(current_offset) &&
-                            !map_terrain_is_superset(current_offset, TERRAIN_MAP_EDGE)) {
-                            map_terrain_add(current_offset, TERRAIN_ORIGINALLY_TREE);
-                        }
+    int total_tiles = map_grid_total_tiles();
+    for (int grid_offset = 0; grid_offset < total_tiles; grid_offset++) {
+        if (terrain_grid.items[grid_offset] & TERRAIN_TREE &&
+            !(terrain_grid.items[grid_offset] & TERRAIN_WATER)) {
+            terrain_grid.items[grid_offset] |= TERRAIN_ORIGINALLY_TREE;
+            if (images && map_grid_seek_state(images, grid_offset)) {
+                int image_id = legacy_buffer ? buffer_read_u16(images) : buffer_read_u32(images);
+                int image_tree_group = image_group(GROUP_TERRAIN_TREE);
+                int ring;
+                if (image_id >= image_tree_group + 8 && image_id < image_tree_group + 16) {
+                    ring = 1;
+                } else if (image_id >= image_tree_group + 16 && image_id < image_tree_group + 24) {
+                    ring = 2;
+                } else if (image_id >= image_tree_group + 24 && image_id < image_tree_group + 32) {
+                    ring = 3;
+                } else {
+                    continue;
+                }
+                int start = map_ring_start(1, ring);
+                int end = map_ring_end(1, ring);
+                for (int i = start; i < end; i++) {
+                    int current_offset = grid_offset + map_ring_tile(i)->grid_offset;
+                    if (map_grid_is_valid_offset(current_offset) &&
+                        !map_terrain_is_superset(current_offset, TERRAIN_MAP_EDGE)) {
+                        map_terrain_add(current_offset, TERRAIN_ORIGINALLY_TREE);
                     }
                 }
             }
@@ -578,8 +600,8 @@ int map_bridge_find_start_and_direction_legacy(int grid_offset, int *axis, int *
 
 void map_terrain_migrate_old_bridges(void)
 {
-    for (int y = 0; y < GRID_SIZE; y++) {
-        for (int x = 0; x < GRID_SIZE; x++) {
+    for (int y = 0; y < map_grid_stride(); y++) {
+        for (int x = 0; x < map_grid_stride(); x++) {
             int grid_offset = map_grid_offset(x, y);
             if (!map_grid_is_valid_offset(grid_offset)) {
                 continue;
@@ -616,8 +638,8 @@ void map_terrain_migrate_old_bridges(void)
 
 void map_terrain_migrate_old_walls(void)
 {
-    for (int y = 0; y < GRID_SIZE; y++) {
-        for (int x = 0; x < GRID_SIZE; x++) {
+    for (int y = 0; y < map_grid_stride(); y++) {
+        for (int x = 0; x < map_grid_stride(); x++) {
             int grid_offset = map_grid_offset(x, y);
             if (!map_grid_is_valid_offset(grid_offset)) {
                 continue;
@@ -635,9 +657,10 @@ void map_terrain_migrate_old_walls(void)
 void map_terrain_load_state(buffer *buf, int expanded_terrain_data, buffer *images, int legacy_image_buffer)
 {
     if (expanded_terrain_data) {
-        map_grid_load_state_u32(terrain_grid.items, buf);
+        map_grid_load_state_u32(&terrain_grid, buf);
     } else {
-        map_grid_load_state_u16_to_u32(terrain_grid.items, buf);
+        map_grid_load_state_u16_to_u32(&terrain_grid, buf);
     }
     determine_original_trees(images, legacy_image_buffer);
+    map_road_clear_roaming_tiles();
 }
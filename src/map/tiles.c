@@ -26,7 +26,7 @@
 
 
 
-#define OFFSET(x,y) (x + GRID_SIZE * y)
+#define OFFSET(x,y) map_grid_delta(x, y)
 
 #define FORBIDDEN_TERRAIN_MEADOW (TERRAIN_AQUEDUCT | TERRAIN_ELEVATION | TERRAIN_ACCESS_RAMP |\
             TERRAIN_RUBBLE | TERRAIN_ROAD | TERRAIN_BUILDING | TERRAIN_GARDEN | TERRAIN_WALL)
@@ -37,10 +37,21 @@
 #define GARDEN_VARIANTS 2
 #define GARDEN_IMAGES_PER_VARIANT 4
 
+// Road paving looks for highways up to this many tiles away, which is also enough for fortified shores
+#define CHANGED_TILE_RADIUS 3
+
 static int aqueduct_include_construction = 0;
-static int highway_top_tile_offsets[4] = { 0, -GRID_SIZE, -1, -GRID_SIZE - 1 };
 static int elevation_recalculate_trees = 0;
 
+// State of the map at the last refresh of changed road, highway and water tiles
+static struct {
+    grid_u32 terrain;
+    grid_u32 buildings;
+    grid_u8 paving;
+    grid_u8 needs_refresh;
+    int paved_roads_near_granaries;
+} last_refresh;
+
 static int is_clear(int x, int y, int size, int disallowed_terrain, int check_figure, int check_image)
 {
     if (!map_grid_is_inside(x, y, size)) {
@@ -86,7 +97,7 @@ static void foreach_region_tile(int x_min, int y_min, int x_max, int y_max,
             callback(xx, yy, grid_offset);
             ++grid_offset;
         }
-        grid_offset += GRID_SIZE - (x_max - x_min + 1);
+        grid_offset += map_grid_stride() - (x_max - x_min + 1);
     }
 }
 
@@ -931,6 +942,7 @@ int map_tiles_clear_highway(int grid_offset, int measure_only)
     int items_cleared = 0;
     int terrain = map_terrain_get(grid_offset);
     int highway_terrain = TERRAIN_HIGHWAY_TOP_LEFT;
+    const int highway_top_tile_offsets[4] = { 0, OFFSET(0, -1), -1, OFFSET(-1, -1) };
     for (int i = 0; i < 4; i++) {
         if (terrain & highway_terrain) {
             int highway_top_tile = grid_offset + highway_top_tile_offsets[i];
@@ -1109,6 +1121,77 @@ void map_tiles_set_water(int x, int y)
     foreach_region_tile(x - 1, y - 1, x + 1, y + 1, set_water_image);
 }
 
+static int get_paving_level(int grid_offset)
+{
+    int desirability = map_desirability_get(grid_offset);
+    if (desirability > 4) {
+        return 2;
+    }
+    return desirability > 0 ? 1 : 0;
+}
+
+static void mark_for_refresh(int x, int y, int radius)
+{
+    int x_min = x - radius;
+    int y_min = y - radius;
+    int x_max = x + radius;
+    int y_max = y + radius;
+    map_grid_bound_area(&x_min, &y_min, &x_max, &y_max);
+    for (int yy = y_min; yy <= y_max; yy++) {
+        int grid_offset = map_grid_offset(x_min, yy);
+        for (int xx = x_min; xx <= x_max; xx++, grid_offset++) {
+            last_refresh.needs_refresh.items[grid_offset] = 1;
+        }
+    }
+}
+
+static void check_tile_changed(int x, int y, int grid_offset)
+{
+    unsigned int terrain = map_terrain_get(grid_offset);
+    unsigned int building_id = map_building_at(grid_offset);
+    unsigned char paving = get_paving_level(grid_offset);
+    if (terrain != last_refresh.terrain.items[grid_offset] ||
+        building_id != last_refresh.buildings.items[grid_offset]) {
+        mark_for_refresh(x, y, CHANGED_TILE_RADIUS);
+    } else if (paving != last_refresh.paving.items[grid_offset]) {
+        last_refresh.needs_refresh.items[grid_offset] = 1;
+    }
+    last_refresh.terrain.items[grid_offset] = terrain;
+    last_refresh.buildings.items[grid_offset] = building_id;
+    last_refresh.paving.items[grid_offset] = paving;
+}
+
+static void foreach_tile_needing_refresh(void (*callback)(int x, int y, int grid_offset))
+{
+    int grid_offset = map_data.start_offset;
+    for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
+        for (int x = 0; x < map_data.width; x++, grid_offset++) {
+            if (last_refresh.needs_refresh.items[grid_offset]) {
+                callback(x, y, grid_offset);
+            }
+        }
+    }
+}
+
+void map_tiles_update_changed_roads_and_water(void)
+{
+    map_grid_ensure_u32(&last_refresh.terrain);
+    map_grid_ensure_u32(&last_refresh.buildings);
+    map_grid_ensure_u8(&last_refresh.paving);
+    map_grid_clear_u8(&last_refresh.needs_refresh);
+    foreach_map_tile(check_tile_changed);
+
+    int paved_roads_near_granaries = config_get(CONFIG_UI_PAVED_ROADS_NEAR_GRANNARIES);
+    if (paved_roads_near_granaries != last_refresh.paved_roads_near_granaries) {
+        last_refresh.paved_roads_near_granaries = paved_roads_near_granaries;
+        foreach_map_tile(set_road_image);
+    } else {
+        foreach_tile_needing_refresh(set_road_image);
+    }
+    foreach_tile_needing_refresh(set_highway_image);
+    foreach_tile_needing_refresh(set_water_image);
+}
+
 static void set_aqueduct(int grid_offset)
 {
     const terrain_image *img = map_image_context_get_aqueduct(grid_offset, aqueduct_include_construction);
@@ -1212,7 +1295,7 @@ static int get_access_ramp_image_offset(int x, int y)
     if (!map_grid_is_inside(x, y, 1)) {
         return -1;
     }
-    static const int offsets[4][6] = {
+    const int offsets[4][6] = {
         {OFFSET(0,1), OFFSET(1,1), OFFSET(0,0), OFFSET(1,0), OFFSET(0,2), OFFSET(1,2)},
         {OFFSET(0,0), OFFSET(0,1), OFFSET(1,0), OFFSET(1,1), OFFSET(-1,0), OFFSET(-1,1)},
         {OFFSET(0,0), OFFSET(1,0), OFFSET(0,1), OFFSET(1,1), OFFSET(0,-1), OFFSET(1,-1)},
@@ -35,6 +35,8 @@ void map_tiles_update_all_water(void);
 void map_tiles_update_region_water(int x_min, int y_min, int x_max, int y_max);
 void map_tiles_set_water(int x, int y);
 
+void map_tiles_update_changed_roads_and_water(void);
+
 void map_tiles_update_all_aqueducts(int include_construction);
 void map_tiles_update_region_aqueducts(int x_min, int y_min, int x_max, int y_max);
 
@@ -11,7 +11,7 @@
 #include "map/property.h"
 #include "map/terrain.h"
 
-#define OFFSET(x,y) ((x) + GRID_SIZE * (y))
+#define OFFSET(x,y) map_grid_delta(x, y)
 
 void map_water_add_building(int building_id, int x, int y, int size)
 {
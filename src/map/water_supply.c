@@ -20,7 +20,7 @@
 
 #include <string.h>
 
-#define OFFSET(x,y) (x + GRID_SIZE * y)
+#define OFFSET(x,y) map_grid_delta(x, y)
 
 #define MAX_QUEUE 1000
 #define RESERVOIR_RADIUS 10
@@ -28,8 +28,8 @@
 #define LATRINES_RADIUS 3
 #define FOUNTAIN_RADIUS 4
 
-static const int ADJACENT_OFFSETS[] = { -GRID_SIZE, 1, GRID_SIZE, -1 };
-static const int CONNECTOR_OFFSETS[] = { OFFSET(1,-1), OFFSET(3,1), OFFSET(1,3), OFFSET(-1,1) };
+#define ADJACENT_OFFSETS { OFFSET(0,-1), 1, OFFSET(0,1), -1 }
+#define CONNECTOR_OFFSETS { OFFSET(1,-1), OFFSET(3,1), OFFSET(1,3), OFFSET(-1,1) }
 
 static struct {
     int items[MAX_QUEUE];
@@ -140,11 +140,12 @@ static void fill_aqueducts_from_offset(int grid_offset)
         return;
     }
     memset(&queue, 0, sizeof(queue));
+    const int adjacent_offsets[] = ADJACENT_OFFSETS;
     int guard = 0;
     int next_offset;
 
     do {
-        if (++guard >= GRID_SIZE * GRID_SIZE) {
+        if (++guard >= map_grid_total_tiles()) {
             break;
         }
         map_aqueduct_set_water_access(grid_offset, 1);
@@ -157,7 +158,7 @@ static void fill_aqueducts_from_offset(int grid_offset)
         }
         next_offset = -1;
         for (int i = 0; i < 4; i++) {
-            int new_offset = grid_offset + ADJACENT_OFFSETS[i];
+            int new_offset = grid_offset + adjacent_offsets[i];
             building *b = building_get(map_building_at(new_offset));
             if (b->id && b->type == BUILDING_RESERVOIR) {
                 if (!b->has_water_access && is_valid_reservoir_connection(new_offset)) {
@@ -205,6 +206,7 @@ void map_water_supply_update_reservoir_fountain(void)
         }
     }
     // fill reservoirs from full ones
+    const int connector_offsets[] = CONNECTOR_OFFSETS;
     int changed = 1;
     while (changed == 1) {
         changed = 0;
@@ -216,7 +218,7 @@ void map_water_supply_update_reservoir_fountain(void)
                 b->has_water_access = 1;
                 changed = 1;
                 for (int d = 0; d < 4; d++) {
-                    fill_aqueducts_from_offset(b->grid_offset + CONNECTOR_OFFSETS[d]);
+                    fill_aqueducts_from_offset(b->grid_offset + connector_offsets[d]);
                 }
             }
         }
@@ -299,8 +301,9 @@ void map_water_supply_update_reservoir_fountain(void)
 
 int map_water_supply_has_aqueduct_access(int grid_offset)
 {
+    const int connector_offsets[] = CONNECTOR_OFFSETS;
     for (int i = 0; i < 4; i++) {
-        int new_offset = grid_offset + CONNECTOR_OFFSETS[i];
+        int new_offset = grid_offset + connector_offsets[i];
         if (!map_grid_is_valid_offset(new_offset)) {
             continue;
         }
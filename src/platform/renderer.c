@@ -35,8 +35,17 @@
 #define HAS_TEXTURE_SCALE_MODE 0
 #endif
 
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+#define USE_RENDER_GEOMETRY
+#define HAS_RENDER_GEOMETRY (platform_sdl_version_at_least(2, 0, 18))
+#else
+#define HAS_RENDER_GEOMETRY 0
+#endif
+
 #define MAX_UNPACKED_IMAGES 20
 
+#define IMAGE_BATCH_SIZE_STEP 256
+
 #define MAX_PACKED_IMAGE_SIZE 64000
 
 #if (defined(__ANDROID__) || defined(__EMSCRIPTEN__)) && !SDL_VERSION_ATLEAST(2, 24, 0)
@@ -118,6 +127,19 @@ static struct {
     float city_scale;
     int should_correct_texture_offset;
     int disable_linear_filter;
+#ifdef USE_RENDER_GEOMETRY
+    struct {
+        int active;
+        SDL_Texture *texture;
+        int texture_width;
+        int texture_height;
+        float scale;
+        SDL_Vertex *vertices;
+        int *indices;
+        int num_quads;
+        int capacity;
+    } image_batch;
+#endif
 } data;
 
 static int save_screen_buffer(color_t *pixels, int x, int y, int width, int height, int row_width)
@@ -558,8 +580,126 @@ static void draw_texture_advanced(const image *img, float x, float y, color_t co
     SDL_RenderCopyEx(data.renderer, texture, &src_coords, &dst_coords, angle, NULL, SDL_FLIP_NONE);
 }
 
+#ifdef USE_RENDER_GEOMETRY
+static void flush_image_batch(void)
+{
+    if (!data.image_batch.num_quads) {
+        return;
+    }
+    // The color of each glyph is in its vertices, so the texture itself must not tint them again
+    set_texture_color_and_scale_mode(data.image_batch.texture, COLOR_MASK_NONE, data.image_batch.scale);
+    SDL_RenderGeometry(data.renderer, data.image_batch.texture, data.image_batch.vertices,
+        data.image_batch.num_quads * 4, data.image_batch.indices, data.image_batch.num_quads * 6);
+    data.image_batch.num_quads = 0;
+}
+
+static int grow_image_batch(void)
+{
+    int new_capacity = data.image_batch.capacity + IMAGE_BATCH_SIZE_STEP;
+    SDL_Vertex *vertices = realloc(data.image_batch.vertices, new_capacity * 4 * sizeof(SDL_Vertex));
+    if (!vertices) {
+        return 0;
+    }
+    data.image_batch.vertices = vertices;
+    int *indices = realloc(data.image_batch.indices, new_capacity * 6 * sizeof(int));
+    if (!indices) {
+        return 0;
+    }
+    data.image_batch.indices = indices;
+    for (int quad = data.image_batch.capacity; quad < new_capacity; quad++) {
+        int *index = &indices[quad * 6];
+        int vertex = quad * 4;
+        index[0] = vertex;
+        index[1] = vertex + 1;
+        index[2] = vertex + 2;
+        index[3] = vertex + 2;
+        index[4] = vertex + 1;
+        index[5] = vertex + 3;
+    }
+    data.image_batch.capacity = new_capacity;
+    return 1;
+}
+
+static int add_to_image_batch(const image *img, int x, int y, color_t color, float scale)
+{
+    SDL_Texture *texture = get_texture(img->atlas.id);
+    if (!texture) {
+        return 1;
+    }
+    if (texture != data.image_batch.texture || scale != data.image_batch.scale) {
+        flush_image_batch();
+        data.image_batch.texture = texture;
+        data.image_batch.scale = scale;
+        SDL_QueryTexture(texture, NULL, NULL, &data.image_batch.texture_width, &data.image_batch.texture_height);
+    }
+    if (data.image_batch.num_quads == data.image_batch.capacity && !grow_image_batch()) {
+        return 0;
+    }
+    if (!color) {
+        color = COLOR_MASK_NONE;
+    }
+    // Same coordinates as draw_texture_advanced uses for non-isometric images
+    int src_correction = scale == data.city_scale && data.should_correct_texture_offset ? 1 : 0;
+    float src_x = (float) (img->atlas.x_offset + src_correction) / data.image_batch.texture_width;
+    float src_y = (float) (img->atlas.y_offset + src_correction) / data.image_batch.texture_height;
+    float src_x_end = (float) (img->atlas.x_offset + img->width) / data.image_batch.texture_width;
+    float src_y_end = (float) (img->atlas.y_offset + img->height) / data.image_batch.texture_height;
+    float dst_x = (x + img->x_offset - src_correction) / scale;
+    float dst_y = (y + img->y_offset - src_correction) / scale;
+    float dst_x_end = dst_x + (img->width + src_correction) / scale;
+    float dst_y_end = dst_y + (img->height + src_correction) / scale;
+
+    SDL_Color vertex_color = {
+        (color & COLOR_CHANNEL_RED) >> COLOR_BITSHIFT_RED,
+        (color & COLOR_CHANNEL_GREEN) >> COLOR_BITSHIFT_GREEN,
+        (color & COLOR_CHANNEL_BLUE) >> COLOR_BITSHIFT_BLUE,
+        (color & COLOR_CHANNEL_ALPHA) >> COLOR_BITSHIFT_ALPHA
+    };
+    SDL_Vertex *vertex = &data.image_batch.vertices[data.image_batch.num_quads * 4];
+    vertex[0] = (SDL_Vertex) { { dst_x, dst_y }, vertex_color, { src_x, src_y } };
+    vertex[1] = (SDL_Vertex) { { dst_x_end, dst_y }, vertex_color, { src_x_end, src_y } };
+    vertex[2] = (SDL_Vertex) { { dst_x, dst_y_end }, vertex_color, { src_x, src_y_end } };
+    vertex[3] = (SDL_Vertex) { { dst_x_end, dst_y_end }, vertex_color, { src_x_end, src_y_end } };
+    data.image_batch.num_quads++;
+    return 1;
+}
+#endif
+
+static void start_image_batch(void)
+{
+#ifdef USE_RENDER_GEOMETRY
+    // Batches can be nested, only the outermost one is drawn
+    if (HAS_RENDER_GEOMETRY && !data.paused) {
+        data.image_batch.active++;
+    }
+#endif
+}
+
+static void finish_image_batch(void)
+{
+#ifdef USE_RENDER_GEOMETRY
+    if (!data.image_batch.active || --data.image_batch.active) {
+        return;
+    }
+    if (!data.paused) {
+        flush_image_batch();
+    }
+    data.image_batch.num_quads = 0;
+    data.image_batch.texture = 0;
+#endif
+}
+
 static void draw_texture(const image *img, int x, int y, color_t color, float scale)
 {
+#ifdef USE_RENDER_GEOMETRY
+    if (data.image_batch.active && !data.paused) {
+        if (add_to_image_batch(img, x, y, color, scale)) {
+            return;
+        }
+        // Out of memory, keep the draw order by flushing what we have and drawing this one directly
+        flush_image_batch();
+    }
+#endif
     draw_texture_advanced(img, (float) x, (float) y, color, scale, scale, 0.0, 0);
 }
 
@@ -1153,6 +1293,8 @@ static void create_renderer_interface(void)
     data.renderer_interface.draw_rect = draw_rect;
     data.renderer_interface.fill_rect = fill_rect;
     data.renderer_interface.draw_image = draw_texture;
+    data.renderer_interface.start_image_batch = start_image_batch;
+    data.renderer_interface.finish_image_batch = finish_image_batch;
     data.renderer_interface.draw_image_advanced = draw_texture_advanced;
     data.renderer_interface.draw_silhouette = draw_silhouetted_texture;
     data.renderer_interface.create_custom_image = create_custom_texture;
@@ -27,6 +27,9 @@
 
 #define NO_CHANNEL -1
 
+#define MAX_CACHED_SOUNDS 64
+#define MAX_CACHED_SOUND_BYTES (16 * 1024 * 1024)
+
 #if SDL_VERSION_ATLEAST(2, 0, 7)
 #define USE_SDL_AUDIOSTREAM
 #endif
@@ -46,6 +49,14 @@ typedef struct {
     time_millis last_played;
 } sound_channel;
 
+typedef struct {
+    char filename[FILE_NAME_MAX];
+    sound_type type;
+    Mix_Chunk *chunk;
+    int in_use;
+    time_millis last_used;
+} cached_sound;
+
 static struct {
     int initialized;
     uint8_t *custom_music;
@@ -53,6 +64,10 @@ static struct {
     sound_channel *channels;
     unsigned int total_channels;
     void (*sound_finished_callback)(sound_type);
+    struct {
+        cached_sound sounds[MAX_CACHED_SOUNDS];
+        unsigned int total_bytes;
+    } cache;
 } data;
 
 static struct {
@@ -76,6 +91,8 @@ static struct {
     int buffer_size;
     int cur_read;
     int cur_write;
+    // Video decoding writes the stream from its own thread while the audio callback reads it
+    SDL_mutex *lock;
 } custom_music;
 
 static int percentage_to_volume(int percentage)
@@ -115,6 +132,9 @@ void sound_device_open(void)
 #ifdef USE_SDL_AUDIOSTREAM
     custom_music.use_audiostream = HAS_AUDIOSTREAM();
 #endif
+    if (!custom_music.lock) {
+        custom_music.lock = SDL_CreateMutex();
+    }
     // Windows: use directsound by default, as wasapi has issues
 #ifdef __WINDOWS__
     SDL_AudioInit("directsound");
@@ -149,6 +169,66 @@ void sound_device_open(void)
     }
 }
 
+static cached_sound *get_cached_sound(const char *filename, sound_type type)
+{
+    for (int i = 0; i < MAX_CACHED_SOUNDS; i++) {
+        cached_sound *sound = &data.cache.sounds[i];
+        if (sound->chunk && sound->type == type && strcmp(sound->filename, filename) == 0) {
+            return sound;
+        }
+    }
+    return 0;
+}
+
+static void free_cached_sound(cached_sound *sound)
+{
+    data.cache.total_bytes -= sound->chunk->alen;
+    Mix_FreeChunk(sound->chunk);
+    sound->chunk = 0;
+    sound->filename[0] = 0;
+    sound->in_use = 0;
+}
+
+static void release_cached_chunk(Mix_Chunk *chunk)
+{
+    for (int i = 0; i < MAX_CACHED_SOUNDS; i++) {
+        cached_sound *sound = &data.cache.sounds[i];
+        if (sound->chunk == chunk) {
+            sound->in_use = 0;
+            sound->last_used = time_get_millis();
+            return;
+        }
+    }
+    // Chunks that did not fit in the cache are owned by the channel
+    Mix_FreeChunk(chunk);
+}
+
+static cached_sound *get_free_cache_slot(unsigned int bytes_needed)
+{
+    // Evict the least recently used sounds that are not playing until the new one fits
+    while (1) {
+        cached_sound *empty = 0;
+        cached_sound *oldest = 0;
+        for (int i = 0; i < MAX_CACHED_SOUNDS; i++) {
+            cached_sound *sound = &data.cache.sounds[i];
+            if (!sound->chunk) {
+                if (!empty) {
+                    empty = sound;
+                }
+            } else if (!sound->in_use && (!oldest || sound->last_used < oldest->last_used)) {
+                oldest = sound;
+            }
+        }
+        if (empty && data.cache.total_bytes + bytes_needed <= MAX_CACHED_SOUND_BYTES) {
+            return empty;
+        }
+        if (!oldest) {
+            return 0;
+        }
+        free_cached_sound(oldest);
+    }
+}
+
 static void stop_channel(int channel)
 {
     if (!data.initialized) {
@@ -157,13 +237,23 @@ static void stop_channel(int channel)
     sound_channel *ch = &data.channels[channel];
     if (ch->chunk) {
         Mix_HaltChannel(channel);
-        Mix_FreeChunk(ch->chunk);
+        release_cached_chunk(ch->chunk);
         ch->chunk = 0;
     }
     ch->filename[0] = 0;
     ch->last_played = 0;
 }
 
+void sound_device_clear_cache(void)
+{
+    for (int i = 0; i < MAX_CACHED_SOUNDS; i++) {
+        cached_sound *sound = &data.cache.sounds[i];
+        if (sound->chunk && !sound->in_use) {
+            free_cached_sound(sound);
+        }
+    }
+}
+
 void sound_device_close(void)
 {
     if (!data.initialized) {
@@ -172,6 +262,7 @@ void sound_device_close(void)
     for (unsigned int i = 0; i < data.total_channels; i++) {
         stop_channel(i);
     }
+    sound_device_clear_cache();
     Mix_ChannelFinished(NULL);
     Mix_CloseAudio();
     free(data.channels);
@@ -207,6 +298,49 @@ static Mix_Chunk *load_chunk(const char *filename)
 #endif
 }
 
+static Mix_Chunk *acquire_chunk(const char *filename, sound_type type, int in_use)
+{
+    if (!filename || !*filename) {
+        return 0;
+    }
+    cached_sound *sound = get_cached_sound(filename, type);
+    if (sound) {
+        if (in_use) {
+            sound->in_use = 1;
+        }
+        sound->last_used = time_get_millis();
+        return sound->chunk;
+    }
+    Mix_Chunk *chunk = load_chunk(filename);
+    if (!chunk) {
+        return 0;
+    }
+    // Sounds larger than the whole cache are never cached, so they must not evict anything
+    sound = chunk->alen > MAX_CACHED_SOUND_BYTES ? 0 : get_free_cache_slot(chunk->alen);
+    if (!sound) {
+        if (!in_use) {
+            Mix_FreeChunk(chunk);
+            return 0;
+        }
+        return chunk;
+    }
+    snprintf(sound->filename, FILE_NAME_MAX, "%s", filename);
+    sound->type = type;
+    sound->chunk = chunk;
+    sound->in_use = in_use;
+    sound->last_used = time_get_millis();
+    data.cache.total_bytes += chunk->alen;
+    return chunk;
+}
+
+void sound_device_preload_file(const char *filename, sound_type type)
+{
+    if (!data.initialized || !config_get(CONFIG_GENERAL_ENABLE_AUDIO) || !setting_sound_is_enabled(type)) {
+        return;
+    }
+    acquire_chunk(filename, type, 0);
+}
+
 static void callback_for_audio_finished(int channel)
 {
     if (!data.sound_finished_callback) {
@@ -437,7 +571,7 @@ int sound_device_play_file_on_channel_panned(const char *filename, sound_type ty
             return 0;
         }
         stop_channel(channel);
-        data.channels[channel].chunk = load_chunk(filename);
+        data.channels[channel].chunk = acquire_chunk(filename, type, 1);
         if (!data.channels[channel].chunk) {
             return 0;
         }
@@ -625,7 +759,7 @@ static void custom_music_callback(void *dummy, Uint8 *dst, int len)
     int volume = config_get(CONFIG_GENERAL_ENABLE_AUDIO) && config_get(CONFIG_GENERAL_ENABLE_VIDEO_SOUND) ?
         percentage_to_volume(config_get(CONFIG_GENERAL_VIDEO_VOLUME)) : 0;
 
-    if (!dst || len <= 0 || volume == 0 || !custom_audio_stream_active()) {
+    if (!dst || len <= 0 || volume == 0) {
         return;
     }
     int bytes_copied = 0;
@@ -637,10 +771,17 @@ static void custom_music_callback(void *dummy, Uint8 *dst, int len)
     }
     memset(mix_buffer, 0, len);
 
+    SDL_LockMutex(custom_music.lock);
+    if (!custom_audio_stream_active()) {
+        SDL_UnlockMutex(custom_music.lock);
+        free(mix_buffer);
+        return;
+    }
 #ifdef USE_SDL_AUDIOSTREAM
     if (custom_music.use_audiostream) {
         bytes_copied = SDL_AudioStreamGet(custom_music.stream, mix_buffer, len);
         if (bytes_copied <= 0) {
+            SDL_UnlockMutex(custom_music.lock);
             free(mix_buffer);
             return;
         }
@@ -668,6 +809,7 @@ static void custom_music_callback(void *dummy, Uint8 *dst, int len)
 #ifdef USE_SDL_AUDIOSTREAM
     }
 #endif
+    SDL_UnlockMutex(custom_music.lock);
 
     SDL_MixAudioFormat(dst, mix_buffer, custom_music.dst_format, bytes_copied, volume);
     free(mix_buffer);
@@ -695,10 +837,12 @@ void sound_device_use_custom_music_player(int bitdepth, int num_channels, int ra
     Mix_QuerySpec(&device_rate, &device_format, &device_channels);
     custom_music.format = format;
 
+    SDL_LockMutex(custom_music.lock);
     int result = create_custom_audio_stream(
         format, num_channels, rate,
         device_format, device_channels, device_rate
     );
+    SDL_UnlockMutex(custom_music.lock);
     if (!result) {
         return;
     }
@@ -710,10 +854,12 @@ void sound_device_use_custom_music_player(int bitdepth, int num_channels, int ra
 
 void sound_device_write_custom_music_data(const void *audio_data, int len)
 {
-    if (!data.initialized || !audio_data || len <= 0 || !custom_audio_stream_active()) {
+    if (!data.initialized || !audio_data || len <= 0) {
         return;
     }
+    SDL_LockMutex(custom_music.lock);
     put_custom_audio_stream(audio_data, len);
+    SDL_UnlockMutex(custom_music.lock);
 }
 
 void sound_device_use_default_music_player(void)
@@ -722,5 +868,7 @@ void sound_device_use_default_music_player(void)
         return;
     }
     Mix_HookMusic(0, 0);
+    SDL_LockMutex(custom_music.lock);
     free_custom_audio_stream();
+    SDL_UnlockMutex(custom_music.lock);
 }
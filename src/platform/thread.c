@@ -0,0 +1,52 @@
+#include "core/thread.h"
+#include "SDL.h"
+
+thread_handle *thread_create(thread_function function, const char *name, void *userdata)
+{
+    return (thread_handle *) SDL_CreateThread(function, name, userdata);
+}
+
+void thread_wait(thread_handle *thread)
+{
+    SDL_WaitThread((SDL_Thread *) thread, 0);
+}
+
+thread_mutex *thread_mutex_create(void)
+{
+    return (thread_mutex *) SDL_CreateMutex();
+}
+
+void thread_mutex_destroy(thread_mutex *mutex)
+{
+    SDL_DestroyMutex((SDL_mutex *) mutex);
+}
+
+void thread_mutex_lock(thread_mutex *mutex)
+{
+    SDL_LockMutex((SDL_mutex *) mutex);
+}
+
+void thread_mutex_unlock(thread_mutex *mutex)
+{
+    SDL_UnlockMutex((SDL_mutex *) mutex);
+}
+
+thread_condition *thread_condition_create(void)
+{
+    return (thread_condition *) SDL_CreateCond();
+}
+
+void thread_condition_destroy(thread_condition *condition)
+{
+    SDL_DestroyCond((SDL_cond *) condition);
+}
+
+void thread_condition_wait_timeout(thread_condition *condition, thread_mutex *mutex, unsigned int timeout_ms)
+{
+    SDL_CondWaitTimeout((SDL_cond *) condition, (SDL_mutex *) mutex, timeout_ms);
+}
+
+void thread_condition_signal(thread_condition *condition)
+{
+    SDL_CondSignal((SDL_cond *) condition);
+}
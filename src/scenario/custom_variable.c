@@ -21,6 +21,7 @@ typedef struct {
 } custom_variable_t;
 
 static array(custom_variable_t) custom_variables;
+static unsigned int value_changes;
 static custom_variable_t *get_variable(unsigned int id);
 
 #define CUSTOM_VARIABLES_SIZE_STEP 8
@@ -44,6 +45,7 @@ unsigned int scenario_custom_variable_create(const uint8_t *name, int initial_va
     }
     variable->in_use = 1;
     variable->value = initial_value;
+    value_changes++;
     variable->text_display[0] = 0; // Initialize to empty string
     variable->allow_display = 0; // Initialize to not visible
     if (name) {
@@ -57,6 +59,7 @@ void scenario_custom_variable_delete_all(void)
 {
     array_init(custom_variables, CUSTOM_VARIABLES_SIZE_STEP, new_variable, variable_in_use);
     array_advance(custom_variables);
+    value_changes++;
 }
 
 void scenario_custom_variable_set_color_group(unsigned int id, int color_group)
@@ -129,6 +132,7 @@ void scenario_custom_variable_delete(unsigned int id)
     custom_variable_t *variable = get_variable(id);
     if (variable) {
         variable->in_use = 0;
+        value_changes++;
     }
 }
 
@@ -194,7 +198,15 @@ void scenario_custom_variable_set_value(unsigned int id, int new_value)
     if (!variable) {
         return;
     }
-    variable->value = new_value;
+    if (variable->value != new_value) {
+        variable->value = new_value;
+        value_changes++;
+    }
+}
+
+unsigned int scenario_custom_variable_get_change_count(void)
+{
+    return value_changes;
 }
 
 void scenario_custom_variable_save_state(buffer *buf)
@@ -223,6 +235,7 @@ void scenario_custom_variable_save_state(buffer *buf)
 void scenario_custom_variable_load_state(buffer *buf, int version)
 {
     unsigned int total_variables = buffer_load_dynamic_array(buf);
+    value_changes++;
 
     if (!array_init(custom_variables, CUSTOM_VARIABLES_SIZE_STEP, new_variable, variable_in_use) ||
         !array_expand(custom_variables, total_variables)) {
@@ -254,6 +267,7 @@ void scenario_custom_variable_load_state(buffer *buf, int version)
 
 void scenario_custom_variable_load_state_old_version(buffer *buf)
 {
+    value_changes++;
     if (!array_init(custom_variables, CUSTOM_VARIABLES_SIZE_STEP, new_variable, variable_in_use) ||
         !array_expand(custom_variables, MAX_ORIGINAL_CUSTOM_VARIABLES)) {
         log_error("Failed to initialize custom variables array - out of memory. The game will probably crash.", 0, 0);
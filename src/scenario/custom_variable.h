@@ -33,6 +33,12 @@ void scenario_custom_variable_set_text_display(unsigned int id, const uint8_t *t
 int scenario_custom_variable_get_value(unsigned int id);
 void scenario_custom_variable_set_value(unsigned int id, int new_value);
 
+/**
+ * Returns a counter that increases whenever any custom variable is created, deleted or changes value.
+ * Used to know whether anything that depends on custom variables needs to be checked again.
+ */
+unsigned int scenario_custom_variable_get_change_count(void);
+
 void scenario_custom_variable_save_state(buffer *buf);
 void scenario_custom_variable_load_state(buffer *buf, int version);
 void scenario_custom_variable_load_state_old_version(buffer *buf);
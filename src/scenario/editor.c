@@ -1,5 +1,6 @@
 #include "editor.h"
 
+#include "core/calc.h"
 #include "core/lang.h"
 #include "core/string.h"
 #include "map/grid.h"
@@ -57,8 +58,10 @@ void scenario_editor_create(int map_size)
 
     scenario.map.width = MAP_SIZES[map_size].width;
     scenario.map.height = MAP_SIZES[map_size].height;
-    scenario.map.grid_border_size = GRID_SIZE - scenario.map.width;
-    scenario.map.grid_start = (GRID_SIZE - scenario.map.height) / 2 * GRID_SIZE + (GRID_SIZE - scenario.map.width) / 2;
+    // Keep a border of at least one tile around the map, and the original grid size for the original map sizes
+    int grid_size = calc_bound(scenario.map.width + 2, GRID_SIZE_LEGACY, GRID_SIZE_MAX);
+    scenario.map.grid_border_size = grid_size - scenario.map.width;
+    scenario.map.grid_start = (grid_size - scenario.map.height) / 2 * grid_size + (grid_size - scenario.map.width) / 2;
 
     string_copy(lang_get_string(44, 37), scenario.brief_description, MAX_BRIEF_DESCRIPTION);
     string_copy(lang_get_string(44, 38), scenario.briefing, MAX_BRIEFING);
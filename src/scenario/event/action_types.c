@@ -339,8 +339,9 @@ int scenario_action_type_building_force_collapse_execute(scenario_action_t *acti
     int destroy_all = action->parameter4;
     grid_slice *slice = map_grid_get_grid_slice_from_corner_offsets(grid_offset1, grid_offset2);
 
-    for (int i = 0; i < slice->size; i++) {
-        int current_grid_offset = slice->grid_offsets[i];
+    grid_slice_iterator it = map_grid_slice_iterate(slice);
+    while (map_grid_slice_next(&it)) {
+        int current_grid_offset = it.grid_offset;
         if (!map_grid_is_valid_offset(current_grid_offset)) {
             continue;
         }
@@ -718,8 +719,9 @@ int scenario_action_type_change_terrain_execute(scenario_action_t *action)
     int add = action->parameter4;
     grid_slice *slice = map_grid_get_grid_slice_from_corner_offsets(grid_offset1, grid_offset2);
 
-    for (int i = 0; i < slice->size; i++) {
-        int current_grid_offset = slice->grid_offsets[i];
+    grid_slice_iterator it = map_grid_slice_iterate(slice);
+    while (map_grid_slice_next(&it)) {
+        int current_grid_offset = it.grid_offset;
         if (!map_grid_is_valid_offset(current_grid_offset)) {
             continue;
         }
@@ -787,6 +789,7 @@ int scenario_action_type_change_model_data_execute(scenario_action_t *action)
         default:
             break;
     }
+    model_data_changed();
     return 1;
 }
 
@@ -3,6 +3,8 @@
 #include "core/log.h"
 #include "game/resource.h"
 #include "scenario/event/condition_types.h"
+#include "scenario/event/controller.h"
+#include "scenario/event/formula.h"
 
 static int condition_in_use(const scenario_condition_t *condition)
 {
@@ -98,6 +100,35 @@ int scenario_condition_type_is_met(scenario_condition_t *condition)
     }
 }
 
+static unsigned int formula_inputs(int formula_id)
+{
+    if (formula_id <= 0) {
+        return CONDITION_INPUT_NONE;
+    }
+    const scenario_formula_t *formula = scenario_formula_get(formula_id);
+    if (!formula || formula->is_error || formula->is_static) {
+        return CONDITION_INPUT_NONE;
+    }
+    return scenario_event_formula_is_random(formula_id) ?
+        CONDITION_INPUT_UNTRACKED : CONDITION_INPUT_CUSTOM_VARIABLES;
+}
+
+unsigned int scenario_condition_type_get_inputs(const scenario_condition_t *condition)
+{
+    switch (condition->type) {
+        case CONDITION_TYPE_CUSTOM_VARIABLE_CHECK:
+            return CONDITION_INPUT_CUSTOM_VARIABLES | formula_inputs(condition->parameter3);
+        case CONDITION_TYPE_CHECK_FORMULA:
+            return formula_inputs(condition->parameter1) | formula_inputs(condition->parameter3);
+        case CONDITION_TYPE_DIFFICULTY:
+            return CONDITION_INPUT_DIFFICULTY;
+        case CONDITION_TYPE_TIME_PASSED:
+            return CONDITION_INPUT_TIME;
+        default:
+            return CONDITION_INPUT_UNTRACKED;
+    }
+}
+
 void scenario_condition_type_delete(scenario_condition_t *condition)
 {
     memset(condition, 0, sizeof(scenario_condition_t));
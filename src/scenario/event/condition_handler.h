@@ -10,6 +10,13 @@ int scenario_condition_group_in_use(const scenario_condition_group_t *group);
 void scenario_condition_type_init(scenario_condition_t *condition);
 int scenario_condition_type_is_met(scenario_condition_t *condition);
 
+/**
+ * Gets what a condition reads to decide whether it is met
+ * @param condition The condition
+ * @return A combination of condition_inputs flags. CONDITION_INPUT_UNTRACKED means it must be checked every time.
+ */
+unsigned int scenario_condition_type_get_inputs(const scenario_condition_t *condition);
+
 void scenario_condition_type_delete(scenario_condition_t *condition);
 void scenario_condition_group_save_state(buffer *buf, const scenario_condition_group_t *condition_group, int link_type,
     int32_t link_id);
@@ -198,8 +198,9 @@ int scenario_condition_type_terrain_count_area_met(const scenario_condition_t *c
 
     int current_count = 0;
     grid_slice *slice = map_grid_get_grid_slice_from_corner_offsets(grid_offset1, grid_offset2);
-    for (int i = 0; i < slice->size; i++) {
-        int grid_offset = slice->grid_offsets[i];
+    grid_slice_iterator it = map_grid_slice_iterate(slice);
+    while (map_grid_slice_next(&it)) {
+        int grid_offset = it.grid_offset;
         if (map_terrain_is(grid_offset, terrain_type)) {
             current_count++;
         }
@@ -26,6 +26,15 @@ static unsigned int scenario_formulas_size;
 static void formulas_save_state(buffer *buf);
 static void formulas_load_state(buffer *buf);
 
+static void formulas_clear(void)
+{
+    for (unsigned int id = 1; id <= scenario_formulas_size && id < MAX_FORMULAS; id++) {
+        scenario_event_formula_free(&scenario_formulas[id]);
+    }
+    scenario_formulas_size = 0;
+    memset(scenario_formulas, 0, sizeof(scenario_formulas));
+}
+
 void scenario_events_init(void)
 {
     scenario_event_t *current;
@@ -41,7 +50,7 @@ unsigned int scenario_formula_add(const uint8_t *formatted_calculation, int min_
         log_error("Maximum number of custom formulas reached.", 0, 0);
         return 0;
     }
-    scenario_formula_t calculation;
+    scenario_formula_t calculation = { 0 };
     calculation.min_evaluation = min_limit;
     calculation.max_evaluation = max_limit;
     calculation.id = scenario_formulas_size;
@@ -117,8 +126,7 @@ void scenario_events_clear(void)
     }
 
     // Clear formulas
-    scenario_formulas_size = 0;
-    memset(scenario_formulas, 0, sizeof(scenario_formulas));
+    formulas_clear();
 }
 
 scenario_event_t *scenario_event_get(int event_id)
@@ -369,8 +377,7 @@ static void formulas_save_state(buffer *buf)
 static void formulas_load_state(buffer *buf)
 {
     unsigned int array_size = buffer_load_dynamic_array(buf);
-    memset(scenario_formulas, 0, sizeof(scenario_formulas));
-    scenario_formulas_size = 0;
+    formulas_clear();
     unsigned int max_id = 0;
     for (unsigned int i = 0; i < array_size; ++i) {
 
@@ -388,6 +395,7 @@ static void formulas_load_state(buffer *buf)
         scenario_formulas[id].is_error = buffer_read_u8(buf);
         scenario_formulas[id].min_evaluation = buffer_read_i32(buf);
         scenario_formulas[id].max_evaluation = buffer_read_i32(buf);
+        scenario_event_formula_compile(&scenario_formulas[id]);
         max_id = id > max_id ? id : max_id;
     }
 
@@ -628,8 +636,9 @@ void scenario_events_fetch_event_tiles_to_editor(void)
                 int grid_offset1 = action->parameter1;
                 int grid_offset2 = action->parameter2;
                 grid_slice *slice = map_grid_get_grid_slice_from_corner_offsets(grid_offset1, grid_offset2);
-                for (int i = 0; i < slice->size; i++) {
-                    widget_map_editor_add_draw_context_event_tile(slice->grid_offsets[i], event_id);
+                grid_slice_iterator it = map_grid_slice_iterate(slice);
+                while (map_grid_slice_next(&it)) {
+                    widget_map_editor_add_draw_context_event_tile(it.grid_offset, event_id);
                 }
 
             }
@@ -645,8 +654,9 @@ void scenario_events_fetch_event_tiles_to_editor(void)
                     int grid_offset1 = condition->parameter1;
                     int grid_offset2 = condition->parameter2;
                     grid_slice *slice = map_grid_get_grid_slice_from_corner_offsets(grid_offset1, grid_offset2);
-                    for (int i = 0; i < slice->size; i++) {
-                        widget_map_editor_add_draw_context_event_tile(slice->grid_offsets[i], event_id);
+                    grid_slice_iterator it = map_grid_slice_iterate(slice);
+                    while (map_grid_slice_next(&it)) {
+                        widget_map_editor_add_draw_context_event_tile(it.grid_offset, event_id);
                     }
 
                 }
@@ -58,6 +58,20 @@ typedef enum {
     CONDITION_TYPE_MIN = CONDITION_TYPE_TIME_PASSED,
 } condition_types;
 
+typedef enum {
+    CONDITION_INPUT_NONE = 0,
+    CONDITION_INPUT_CUSTOM_VARIABLES = 1,
+    CONDITION_INPUT_TIME = 2,
+    CONDITION_INPUT_DIFFICULTY = 4,
+    CONDITION_INPUT_UNTRACKED = 8 // city state, random values, etc - must be checked every time
+} condition_inputs;
+
+typedef struct {
+    unsigned int custom_variable_changes;
+    int total_months;
+    int difficulty;
+} scenario_condition_input_stamp_t;
+
 typedef enum {
     ACTION_TYPE_UNDEFINED = 0,
     ACTION_TYPE_ADJUST_FAVOR = 1,
@@ -170,8 +184,14 @@ typedef struct {
     uint8_t name[EVENT_NAME_LENGTH];
     array(scenario_condition_group_t) condition_groups;
     array(scenario_action_t) actions;
+    // Runtime only: when the conditions failed because of tracked inputs, they are not checked again until those change
+    unsigned char has_unmet_inputs;
+    unsigned int unmet_inputs;
+    scenario_condition_input_stamp_t unmet_stamp;
 } scenario_event_t;
 
+typedef struct scenario_formula_instruction_t scenario_formula_instruction_t;
+
 typedef struct {
     unsigned int id; //this number should correspond to the index in array
     uint8_t formatted_calculation[MAX_FORMULA_LENGTH]; //use [custom_variable_id] to get custom variables in the formula
@@ -180,6 +200,8 @@ typedef struct {
     unsigned char is_error; // flag to indicate an error in formula that will prevent it from evaluation
     int min_evaluation; //limits are inherited from xml parameters on adding to the array
     int max_evaluation; //they cannot be set afterwards, because they are dictated by the kind of number expected to be returned
+    scenario_formula_instruction_t *program; // compiled formatted_calculation, rebuilt on add, change and load - not saved
+    unsigned int program_size;
 } scenario_formula_t;
 
 #endif // SCENARIO_EVENT_DATA_H
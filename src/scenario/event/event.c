@@ -4,6 +4,9 @@
 #include "core/log.h"
 #include "core/random.h"
 #include "game/save_version.h"
+#include "game/settings.h"
+#include "game/time.h"
+#include "scenario/custom_variable.h"
 #include "scenario/event/action_handler.h"
 #include "scenario/event/condition_handler.h"
 
@@ -34,6 +37,7 @@ int scenario_event_is_active(const scenario_event_t *event)
 void scenario_event_init(scenario_event_t *event)
 {
     event->state = EVENT_STATE_ACTIVE;
+    event->has_unmet_inputs = 0;
     unsigned int event_id = event->id;
     scenario_condition_group_t *group;
     scenario_condition_t *condition;
@@ -72,6 +76,7 @@ void scenario_event_load_state(buffer *buf, scenario_event_t *event, int scenari
 {
     int saved_id = buffer_read_i32(buf);
     event->state = buffer_read_i16(buf);
+    event->has_unmet_inputs = 0;
     event->repeat_days_min = buffer_read_i32(buf);
     event->repeat_days_max = buffer_read_i32(buf);
     if (scenario_version <= SCENARIO_LAST_NO_FORMULAS_AND_MODEL_DATA) {
@@ -171,8 +176,43 @@ int scenario_event_can_repeat(scenario_event_t *event)
         ((event->execution_count < event->max_number_of_repeats) || (event->max_number_of_repeats <= 0));
 }
 
-static int conditions_fulfilled(scenario_event_t *event)
+static void get_input_stamp(scenario_condition_input_stamp_t *stamp)
 {
+    stamp->custom_variable_changes = scenario_custom_variable_get_change_count();
+    stamp->total_months = game_time_total_months();
+    stamp->difficulty = setting_difficulty();
+}
+
+static int unmet_inputs_changed(const scenario_event_t *event)
+{
+    scenario_condition_input_stamp_t current;
+    get_input_stamp(&current);
+    if ((event->unmet_inputs & CONDITION_INPUT_CUSTOM_VARIABLES) &&
+        event->unmet_stamp.custom_variable_changes != current.custom_variable_changes) {
+        return 1;
+    }
+    if ((event->unmet_inputs & CONDITION_INPUT_TIME) && event->unmet_stamp.total_months != current.total_months) {
+        return 1;
+    }
+    if ((event->unmet_inputs & CONDITION_INPUT_DIFFICULTY) && event->unmet_stamp.difficulty != current.difficulty) {
+        return 1;
+    }
+    return 0;
+}
+
+static unsigned int group_inputs(const scenario_condition_group_t *group)
+{
+    unsigned int inputs = CONDITION_INPUT_NONE;
+    for (unsigned int i = 0; i < group->conditions.size; i++) {
+        inputs |= scenario_condition_type_get_inputs(array_item(group->conditions, i));
+    }
+    return inputs;
+}
+
+// If the conditions are not fulfilled, unmet_inputs gets what the failing conditions depend on
+static int conditions_fulfilled(scenario_event_t *event, unsigned int *unmet_inputs)
+{
+    *unmet_inputs = CONDITION_INPUT_UNTRACKED;
     if (event->state != EVENT_STATE_ACTIVE) {
         return 0;
     }
@@ -186,6 +226,7 @@ static int conditions_fulfilled(scenario_event_t *event)
         for (unsigned int i = 0; i < group->conditions.size; i++) {
             scenario_condition_t *condition = array_item(group->conditions, i);
             if (group->type == FULFILLMENT_TYPE_ALL && !scenario_condition_type_is_met(condition)) {
+                *unmet_inputs = scenario_condition_type_get_inputs(condition);
                 return 0;
             }
             if (group->type == FULFILLMENT_TYPE_ANY && scenario_condition_type_is_met(condition)) {
@@ -194,6 +235,7 @@ static int conditions_fulfilled(scenario_event_t *event)
             }
         }
         if (group->type == FULFILLMENT_TYPE_ANY && group->conditions.size > 0 && !group_fulfilled) {
+            *unmet_inputs = group_inputs(group);
             return 0;
         }
     }
@@ -231,7 +273,13 @@ int scenario_event_count_conditions(const scenario_event_t *event)
 
 int scenario_event_conditional_execute(scenario_event_t *event)
 {
-    if (conditions_fulfilled(event)) {
+    // A failed condition that only depends on tracked inputs keeps failing until one of those inputs changes
+    if (event->has_unmet_inputs && !unmet_inputs_changed(event)) {
+        return 0;
+    }
+    unsigned int unmet_inputs;
+    if (conditions_fulfilled(event, &unmet_inputs)) {
+        event->has_unmet_inputs = 0;
         int result = scenario_event_execute(event);
         event->execution_count++;
         if (scenario_event_can_repeat(event)) {
@@ -243,6 +291,11 @@ int scenario_event_conditional_execute(scenario_event_t *event)
         }
         return result;
     }
+    event->has_unmet_inputs = !(unmet_inputs & CONDITION_INPUT_UNTRACKED);
+    if (event->has_unmet_inputs) {
+        event->unmet_inputs = unmet_inputs;
+        get_input_stamp(&event->unmet_stamp);
+    }
     return 0;
 }
 
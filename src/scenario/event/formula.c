@@ -7,14 +7,47 @@
 
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <ctype.h>
 #include <math.h>
 
 #define CLAMP(x, low, high) ((x) < (low) ? (low) : ((x) > (high) ? (high) : (x))) // simple clamp macro 
 // because mathematicians have only discovered clamping in 2023, so its not in all math.h yet
 
+// Heuristic cap on the program size. Some characters compile to more than one instruction, so a formula
+// can overflow it; such formulas are flagged by the compiler and fall back to string evaluation.
+#define MAX_PROGRAM_SIZE (MAX_FORMULA_LENGTH + 1)
+
+typedef enum {
+    FORMULA_OP_NUMBER,
+    FORMULA_OP_VARIABLE,
+    FORMULA_OP_ADD,
+    FORMULA_OP_SUBTRACT,
+    FORMULA_OP_MULTIPLY,
+    FORMULA_OP_DIVIDE,
+    FORMULA_OP_NEGATE,
+    FORMULA_OP_RANDOM,
+    FORMULA_OP_CLEAR // replaces the top of the stack with zero, used for random ranges without a second value
+} formula_opcode;
+
+struct scenario_formula_instruction_t {
+    formula_opcode opcode;
+    union {
+        double number;
+        unsigned int variable_id;
+    } operand;
+};
+
+typedef struct {
+    scenario_formula_instruction_t instructions[MAX_PROGRAM_SIZE];
+    unsigned int size;
+    int overflow;
+} formula_compiler;
+
 double parse_expr(const char **s);
 static int formula_evaluate(const char *str);
+static void compile_expr(const char **s, formula_compiler *compiler);
 
 double get_var_value(int id)
 {
@@ -134,11 +167,203 @@ double parse_expr(const char **s)
     return val;
 }
 
+static void emit(formula_compiler *compiler, formula_opcode opcode)
+{
+    if (compiler->size >= MAX_PROGRAM_SIZE) {
+        compiler->overflow = 1;
+        return;
+    }
+    compiler->instructions[compiler->size].opcode = opcode;
+    compiler->instructions[compiler->size].operand.number = 0.0;
+    compiler->size++;
+}
+
+static void emit_number(formula_compiler *compiler, double number)
+{
+    emit(compiler, FORMULA_OP_NUMBER);
+    if (!compiler->overflow) {
+        compiler->instructions[compiler->size - 1].operand.number = number;
+    }
+}
+
+static void emit_variable(formula_compiler *compiler, unsigned int variable_id)
+{
+    emit(compiler, FORMULA_OP_VARIABLE);
+    if (!compiler->overflow) {
+        compiler->instructions[compiler->size - 1].operand.variable_id = variable_id;
+    }
+}
+
+// The compile functions mirror parse_factor, parse_term and parse_expr exactly,
+// so a compiled formula consumes the same input and evaluates in the same order as the string parser
+
+static void compile_factor(const char **s, formula_compiler *compiler)
+{
+    skip_spaces(s);
+
+    if (**s == '(') {
+        (*s)++;
+        compile_expr(s, compiler);
+        if (**s == ')') (*s)++;
+    } else if (**s == '[') {
+        (*s)++;
+        int id = (int) parse_number(s);
+        if (**s == ']') (*s)++;
+        emit_variable(compiler, id);
+    } else if (**s == '{') {
+        (*s)++;
+        compile_expr(s, compiler);
+        if (**s == ',') {
+            (*s)++;
+            compile_expr(s, compiler);
+            emit(compiler, FORMULA_OP_RANDOM);
+        } else {
+            emit(compiler, FORMULA_OP_CLEAR);
+        }
+        if (**s == '}') {
+            (*s)++;
+        }
+    } else if (**s == '-') {
+        (*s)++;
+        compile_factor(s, compiler);
+        emit(compiler, FORMULA_OP_NEGATE);
+    } else if (isdigit(**s) || **s == '.') {
+        emit_number(compiler, parse_number(s));
+    } else {
+        emit_number(compiler, 0.0);
+    }
+}
+
+static void compile_term(const char **s, formula_compiler *compiler)
+{
+    compile_factor(s, compiler);
+    skip_spaces(s);
+
+    while (**s == '*' || **s == '/') {
+        char op = **s;
+        (*s)++;
+        compile_factor(s, compiler);
+        skip_spaces(s);
+        emit(compiler, op == '*' ? FORMULA_OP_MULTIPLY : FORMULA_OP_DIVIDE);
+    }
+}
+
+static void compile_expr(const char **s, formula_compiler *compiler)
+{
+    compile_term(s, compiler);
+    skip_spaces(s);
+
+    while (**s == '+' || **s == '-') {
+        char op = **s;
+        (*s)++;
+        compile_term(s, compiler);
+        emit(compiler, op == '+' ? FORMULA_OP_ADD : FORMULA_OP_SUBTRACT);
+        skip_spaces(s);
+    }
+}
+
+static void clear_program(scenario_formula_t *s_formula)
+{
+    free(s_formula->program);
+    s_formula->program = 0;
+    s_formula->program_size = 0;
+}
+
+void scenario_event_formula_compile(scenario_formula_t *s_formula)
+{
+    clear_program(s_formula);
+    if (s_formula->is_error) {
+        return;
+    }
+    formula_compiler compiler;
+    compiler.size = 0;
+    compiler.overflow = 0;
+    const char *str = (const char *) s_formula->formatted_calculation;
+    compile_expr(&str, &compiler);
+    if (compiler.overflow || !compiler.size) {
+        return; // falls back to parsing the string on every evaluation
+    }
+    s_formula->program = malloc(compiler.size * sizeof(scenario_formula_instruction_t));
+    if (!s_formula->program) {
+        return;
+    }
+    memcpy(s_formula->program, compiler.instructions, compiler.size * sizeof(scenario_formula_instruction_t));
+    s_formula->program_size = compiler.size;
+}
+
+void scenario_event_formula_free(scenario_formula_t *s_formula)
+{
+    clear_program(s_formula);
+}
+
+static double run_program(const scenario_formula_t *s_formula)
+{
+    double stack[MAX_PROGRAM_SIZE];
+    unsigned int top = 0;
+    for (unsigned int i = 0; i < s_formula->program_size; i++) {
+        const scenario_formula_instruction_t *instruction = &s_formula->program[i];
+        switch (instruction->opcode) {
+            case FORMULA_OP_NUMBER:
+                stack[top++] = instruction->operand.number;
+                break;
+            case FORMULA_OP_VARIABLE:
+                stack[top++] = get_var_value(instruction->operand.variable_id);
+                break;
+            case FORMULA_OP_ADD:
+                top--;
+                stack[top - 1] += stack[top];
+                break;
+            case FORMULA_OP_SUBTRACT:
+                top--;
+                stack[top - 1] -= stack[top];
+                break;
+            case FORMULA_OP_MULTIPLY:
+                top--;
+                stack[top - 1] *= stack[top];
+                break;
+            case FORMULA_OP_DIVIDE:
+                top--;
+                if (fabs(stack[top]) < 1e-12) {
+                    // Treat division by zero as multiplication by zero
+                    stack[top - 1] = 0.0;
+                } else {
+                    stack[top - 1] /= stack[top];
+                }
+                break;
+            case FORMULA_OP_NEGATE:
+                stack[top - 1] = -stack[top - 1];
+                break;
+            case FORMULA_OP_RANDOM:
+            {
+                top--;
+                double val1 = stack[top - 1];
+                double val2 = stack[top];
+                stack[top - 1] = val1 < val2 ?
+                    random_between_from_stdlib(val1, val2) : random_between_from_stdlib(val2, val1);
+                break;
+            }
+            case FORMULA_OP_CLEAR:
+                stack[top - 1] = 0.0;
+                break;
+        }
+    }
+    return top ? stack[top - 1] : 0.0;
+}
+
+static int evaluate_compiled(const scenario_formula_t *s_formula)
+{
+    if (!s_formula->program) {
+        return formula_evaluate((const char *) s_formula->formatted_calculation);
+    }
+    return (int) round(run_program(s_formula));
+}
+
 int scenario_event_formula_check(scenario_formula_t *s_formula)
 {
     char *s = (char *) s_formula->formatted_calculation;
     s_formula->is_error = 0;
     s_formula->is_static = 1;
+    clear_program(s_formula);
     while (*s) {
         if (*s == ',') {
             s_formula->is_static = 0; // found random value
@@ -171,9 +396,10 @@ int scenario_event_formula_check(scenario_formula_t *s_formula)
             s++;
         }
     }
+    scenario_event_formula_compile(s_formula);
     if (s_formula->is_static) {
         // Evaluate static formula once
-        int evaluation = formula_evaluate((const char *) s_formula->formatted_calculation);
+        int evaluation = evaluate_compiled(s_formula);
         evaluation = CLAMP(evaluation, s_formula->min_evaluation, s_formula->max_evaluation);
         s_formula->evaluation = evaluation;
     }
@@ -195,7 +421,7 @@ int scenario_event_formula_evaluate(scenario_formula_t *s_formula)
     if (s_formula->is_static) {
         return s_formula->evaluation;
     }
-    int evaluation = formula_evaluate((const char *) s_formula->formatted_calculation);
+    int evaluation = evaluate_compiled(s_formula);
     evaluation = CLAMP(evaluation, s_formula->min_evaluation, s_formula->max_evaluation);
     s_formula->evaluation = evaluation;
     return evaluation;
@@ -212,3 +438,20 @@ int scenario_event_formula_is_error(unsigned int id)
     scenario_formula_t *form = scenario_formula_get(id);
     return form->is_error;
 }
+
+int scenario_event_formula_is_random(unsigned int id)
+{
+    const scenario_formula_t *form = scenario_formula_get(id);
+    if (!form || form->is_error || form->is_static) {
+        return 0;
+    }
+    if (!form->program) {
+        return strchr((const char *) form->formatted_calculation, ',') != 0;
+    }
+    for (unsigned int i = 0; i < form->program_size; i++) {
+        if (form->program[i].opcode == FORMULA_OP_RANDOM) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -35,8 +35,33 @@
 int scenario_event_formula_evaluate(scenario_formula_t *formula);
 int scenario_event_formula_check(scenario_formula_t *formula);
 
+/**
+ * @brief Compile the formula string into the stack program used by scenario_event_formula_evaluate.
+ *
+ * Called by scenario_event_formula_check, and on load for formulas that were already checked when saved.
+ * If the formula cannot be compiled, evaluation falls back to parsing the string every time.
+ *
+ * @param formula Pointer to the scenario_formula_t structure to compile.
+ */
+void scenario_event_formula_compile(scenario_formula_t *formula);
+
+/**
+ * @brief Release the compiled program of a formula. Must be called before the formula is cleared.
+ *
+ * @param formula Pointer to the scenario_formula_t structure to release.
+ */
+void scenario_event_formula_free(scenario_formula_t *formula);
+
 int scenario_event_formula_is_static(unsigned int id);
 int scenario_event_formula_is_error(unsigned int id);
 
+/**
+ * @brief Check whether a formula contains random ranges, so it can give different results for the same inputs.
+ *
+ * @param id The formula id.
+ * @return 1 if the formula uses random values, 0 otherwise.
+ */
+int scenario_event_formula_is_random(unsigned int id);
+
 
 #endif // SCENARIO_EVENT_FORMULA_H
@@ -159,6 +159,14 @@ void sound_city_init(void)
         current_sound->filenames.current = 0;
         memset(current_sound->direction_views, 0, sizeof(current_sound->direction_views));
     }
+    // Campaigns can replace sound files, so decoded sounds from a previous scenario cannot be reused
+    sound_device_clear_cache();
+    for (sound_ambient_type sound = SOUND_AMBIENT_FIRST; sound < SOUND_AMBIENT_MAX; sound++) {
+        const background_sound *current_sound = &data.ambient_sounds[sound];
+        for (unsigned int i = 0; i < current_sound->filenames.total; i++) {
+            sound_device_preload_file(current_sound->filenames.list[i], SOUND_TYPE_CITY);
+        }
+    }
 }
 
 void sound_city_set_volume(int percentage)
@@ -29,6 +29,18 @@ int sound_device_resume_music(void);
 void sound_device_stop_music(void);
 void sound_device_stop_type(sound_type type);
 
+/**
+ * Decodes a sound file ahead of time, so playing it later does not need to read it from disk
+ * @param filename The file to load
+ * @param type The sound type the file will be played as
+ */
+void sound_device_preload_file(const char *filename, sound_type type);
+
+/**
+ * Frees all decoded sound files that are not currently bound to a channel
+ */
+void sound_device_clear_cache(void);
+
 void sound_device_on_audio_finished(void (*callback)(sound_type));
 void sound_device_fadeout_music(int milisseconds);
 
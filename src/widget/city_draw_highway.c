@@ -11,12 +11,20 @@
 #include "map/terrain.h"
 #include "map/tiles.h"
 
-static int highway_barrier_direction_offsets[4] = { 1, -GRID_SIZE, -1, GRID_SIZE };
+static const struct {
+    int x;
+    int y;
+} HIGHWAY_BARRIER_DIRECTIONS[4] = { { 1, 0 }, { 0, -1 }, { -1, 0 }, { 0, 1 } };
+
+static int highway_barrier_direction_offset(int direction_index)
+{
+    return map_grid_delta(HIGHWAY_BARRIER_DIRECTIONS[direction_index].x, HIGHWAY_BARRIER_DIRECTIONS[direction_index].y);
+}
 
 static int has_adjacent_road(int adjacent_grid_offset, int direction_index)
 {
-    int right_direction = highway_barrier_direction_offsets[(direction_index + 3) % 4];
-    int left_direction = highway_barrier_direction_offsets[(direction_index + 1) % 4];
+    int right_direction = highway_barrier_direction_offset((direction_index + 3) % 4);
+    int left_direction = highway_barrier_direction_offset((direction_index + 1) % 4);
     int left_has_road = map_terrain_is(adjacent_grid_offset + left_direction, TERRAIN_ROAD);
     int right_has_road = map_terrain_is(adjacent_grid_offset + right_direction, TERRAIN_ROAD);
     if (left_has_road && right_has_road) {
@@ -51,7 +59,7 @@ static int is_highway_access(int grid_offset, int direction_index)
 
 static void draw_barrier_image(int grid_offset, int direction_index, int x, int y, float scale, color_t color_mask)
 {
-    int direction = highway_barrier_direction_offsets[direction_index];
+    int direction = highway_barrier_direction_offset(direction_index);
 
     int direction_offset = grid_offset + direction;
     if (is_highway_access(direction_offset, direction_index)) {
@@ -59,7 +67,7 @@ static void draw_barrier_image(int grid_offset, int direction_index, int x, int
     }
 
     int last_direction_index = (direction_index + 3) % 4;
-    int last_direction_offset = grid_offset + highway_barrier_direction_offsets[last_direction_index];
+    int last_direction_offset = grid_offset + highway_barrier_direction_offset(last_direction_index);
     // last barrier was a corner and will handle the rendering
     if (!is_highway_access(last_direction_offset, last_direction_index)) {
         return;
@@ -67,7 +75,7 @@ static void draw_barrier_image(int grid_offset, int direction_index, int x, int
 
     int barrier_offset = (direction_index + city_view_orientation() / 2) % 4;
     int next_direction_index = (direction_index + 1) % 4;
-    int next_direction_offset = grid_offset + highway_barrier_direction_offsets[next_direction_index];
+    int next_direction_offset = grid_offset + highway_barrier_direction_offset(next_direction_index);
     // is this a corner?
     if (!is_highway_access(next_direction_offset, next_direction_index)) {
         // increment by 4 to get the corner image
@@ -9,16 +9,14 @@
 #include "map/water_supply.h"
 #include "widget/city_building_ghost.h"
 
-#include <string.h>
-
 enum {
     WATER_ACCESS_NONE = 0x0,
     WATER_ACCESS_WELL = 0x1,
     WATER_ACCESS_FOUNTAIN = 0x2
 };
 
-static uint8_t has_water_access[GRID_SIZE * GRID_SIZE];
-static uint8_t has_reservoir_access[GRID_SIZE * GRID_SIZE];
+static grid_u8 has_water_access;
+static grid_u8 has_reservoir_access;
 static building_type last_building_type = BUILDING_NONE;
 static building_type last_reservoir_building_type = BUILDING_NONE;
 static int last_well_count = 0;
@@ -27,22 +25,22 @@ static int last_reservoir_count = 0;
 
 static void set_well_access(int x, int y, int grid_offset)
 {
-    has_water_access[grid_offset] |= WATER_ACCESS_WELL;
+    has_water_access.items[grid_offset] |= WATER_ACCESS_WELL;
 }
 
 static void set_fountain_access(int x, int y, int grid_offset)
 {
-    has_water_access[grid_offset] |= WATER_ACCESS_FOUNTAIN;
+    has_water_access.items[grid_offset] |= WATER_ACCESS_FOUNTAIN;
 }
 
 static void set_reservoir_access(int x, int y, int grid_offset)
 {
-    has_reservoir_access[grid_offset] = 1;
+    has_reservoir_access.items[grid_offset] = 1;
 }
 
 static void update_water_access(void)
 {
-    memset(has_water_access, 0, sizeof(uint8_t) * GRID_SIZE * GRID_SIZE);
+    map_grid_clear_u8(&has_water_access);
     for (building *b = building_first_of_type(BUILDING_WELL); b; b = b->next_of_type) {
         if (b->state != BUILDING_STATE_RUBBLE) {
             city_view_foreach_tile_in_range(b->grid_offset, 1, map_water_supply_well_radius(), set_well_access);
@@ -57,7 +55,7 @@ static void update_water_access(void)
 
 static void update_reservoir_access(void)
 {
-    memset(has_reservoir_access, 0, sizeof(uint8_t) * GRID_SIZE * GRID_SIZE);
+    map_grid_clear_u8(&has_reservoir_access);
     for (building *b = building_first_of_type(BUILDING_RESERVOIR); b; b = b->next_of_type) {
         if (b->state == BUILDING_STATE_IN_USE && b->has_water_access) {
             city_view_foreach_tile_in_range(b->grid_offset, 3, map_water_supply_reservoir_radius(), set_reservoir_access);
@@ -79,7 +77,7 @@ static void update_reservoir_access(void)
 
 static void draw_water_access(int x, int y, int grid_offset)
 {
-    uint8_t water_access = has_water_access[grid_offset];
+    uint8_t water_access = has_water_access.items[grid_offset];
     if (water_access & WATER_ACCESS_FOUNTAIN) {
         city_building_ghost_draw_fountain_range(x, y, grid_offset);
     } else if (water_access & WATER_ACCESS_WELL) {
@@ -89,7 +87,7 @@ static void draw_water_access(int x, int y, int grid_offset)
 
 static void draw_reservoir_access(int x, int y, int grid_offset)
 {
-    if (has_reservoir_access[grid_offset]) {
+    if (has_reservoir_access.items[grid_offset]) {
         city_building_ghost_draw_reservoir_range(x, y, grid_offset);
     }
 }
@@ -99,6 +97,7 @@ void city_water_ghost_draw_water_structure_ranges(void)
     building_type type = building_construction_type();
     // we're counting the number of buildings using the building linked list rather than the counts in building/counts.c
     // because the linked list counts update immediately so the outlines still update even when the game is paused
+    map_grid_ensure_u8(&has_water_access);
     int num_wells = 0;
     for (building *b = building_first_of_type(BUILDING_WELL); b; b = b->next_of_type) {
         if (b->state != BUILDING_STATE_RUBBLE) {
@@ -123,6 +122,7 @@ void city_water_ghost_draw_water_structure_ranges(void)
 void city_water_ghost_draw_reservoir_ranges(void)
 {
     building_type type = building_construction_type();
+    map_grid_ensure_u8(&has_reservoir_access);
     int num_reservoirs = 0;
     for (building *b = building_first_of_type(BUILDING_RESERVOIR); b; b = b->next_of_type) {
         if (b->state == BUILDING_STATE_IN_USE && b->has_water_access) {
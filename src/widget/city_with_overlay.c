@@ -12,9 +12,11 @@
 #include "city/view.h"
 #include "core/config.h"
 #include "core/log.h"
+#include "core/time.h"
 #include "figure/roamer_preview.h"
 #include "game/resource.h"
 #include "game/state.h"
+#include "game/time.h"
 #include "graphics/graphics.h"
 #include "graphics/image.h"
 #include "graphics/renderer.h"
@@ -43,25 +45,56 @@
 #include "widget/city_without_overlay.h"
 #include "widget/city_draw_highway.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 static const city_overlay *overlay = 0;
 static float scale = SCALE_NONE;
 static unsigned int city_roamer_preview_selected_building_id = ((unsigned int) -1); //NO_POSITION default
 
+#define MAX_COLUMN_HEIGHT 10
+#define COLUMN_CACHE_SIZE_STEP 1000
+#define COLUMN_CACHE_REFRESH_MILLIS 1000
+
+typedef struct {
+    unsigned int stamp;
+    short type;
+    short height;
+} cached_column;
+
+static struct {
+    cached_column *items;
+    unsigned int size;
+    unsigned int stamp;
+    int day;
+    time_millis last_refresh;
+} column_cache;
+
+static struct {
+    int base_image_id;
+    struct {
+        int image_id;
+        int capital_y_offset;
+    } images[4][MAX_COLUMN_HEIGHT + 1];
+} column_images;
+
 #define SELECTED_BUILDING_COLOR_MASK COLOR_MASK_SKY_BLUE
-#define OFFSET(x,y) (x + GRID_SIZE * y)
 
-static const int ADJACENT_OFFSETS[2][4][7] = {
+static const struct {
+    int x;
+    int y;
+} ADJACENT_TILES[2][4][7] = {
     {
-        {OFFSET(-1, 0), OFFSET(-1, -1), OFFSET(-1, -2), OFFSET(0, -2), OFFSET(1, -2)},
-        {OFFSET(0, -1), OFFSET(1, -1), OFFSET(2, -1), OFFSET(2, 0), OFFSET(2, 1)},
-        {OFFSET(1, 0), OFFSET(1, 1), OFFSET(1, 2), OFFSET(0, 2), OFFSET(-1, 2)},
-        {OFFSET(0, 1), OFFSET(-1, 1), OFFSET(-2, 1), OFFSET(-2, 0), OFFSET(-2, -1)}
+        {{-1, 0}, {-1, -1}, {-1, -2}, {0, -2}, {1, -2}},
+        {{0, -1}, {1, -1}, {2, -1}, {2, 0}, {2, 1}},
+        {{1, 0}, {1, 1}, {1, 2}, {0, 2}, {-1, 2}},
+        {{0, 1}, {-1, 1}, {-2, 1}, {-2, 0}, {-2, -1}}
     },
     {
-        {OFFSET(-1, 0), OFFSET(-1, -1), OFFSET(-1, -2), OFFSET(-1, -3), OFFSET(0, -3),  OFFSET(1, -3), OFFSET(2, -3)},
-        {OFFSET(0, -1), OFFSET(1, -1), OFFSET(2, -1), OFFSET(3, -1), OFFSET(3, 0),  OFFSET(3, 1), OFFSET(3, 2)},
-        {OFFSET(1, 0), OFFSET(1, 1), OFFSET(1, 2), OFFSET(1, 3), OFFSET(0, 3),  OFFSET(-1, 3), OFFSET(-2, 3)},
-        {OFFSET(0, 1), OFFSET(-1, 1), OFFSET(-2, 1), OFFSET(-3, 1), OFFSET(-3, 0),  OFFSET(-3, -1), OFFSET(-3, -2)}
+        {{-1, 0}, {-1, -1}, {-1, -2}, {-1, -3}, {0, -3},  {1, -3}, {2, -3}},
+        {{0, -1}, {1, -1}, {2, -1}, {3, -1}, {3, 0},  {3, 1}, {3, 2}},
+        {{1, 0}, {1, 1}, {1, 2}, {1, 3}, {0, 3},  {-1, 3}, {-2, 3}},
+        {{0, 1}, {-1, 1}, {-2, 1}, {-3, 1}, {-3, 0},  {-3, -1}, {-3, -2}}
     }
 };
 
@@ -199,14 +232,57 @@ static const city_overlay *get_city_overlay(void)
     }
 }
 
+static void invalidate_column_cache(void)
+{
+    // Stamp 0 is never used so that new entries are always stale
+    if (!++column_cache.stamp) {
+        column_cache.stamp = 1;
+        memset(column_cache.items, 0, column_cache.size * sizeof(cached_column));
+    }
+}
+
 static int select_city_overlay(void)
 {
     if (!overlay || overlay->type != game_state_overlay()) {
         overlay = get_city_overlay();
+        invalidate_column_cache();
     }
     return overlay != 0;
 }
 
+static void refresh_column_cache(void)
+{
+    // Column values only change with the simulation, but things like the tax rate can be changed while paused
+    int day = game_time_total_months() * GAME_TIME_DAYS_PER_MONTH + game_time_day();
+    time_millis now = time_get_millis();
+    if (day != column_cache.day || now - column_cache.last_refresh >= COLUMN_CACHE_REFRESH_MILLIS) {
+        column_cache.day = day;
+        column_cache.last_refresh = now;
+        invalidate_column_cache();
+    }
+}
+
+static int get_column_height(const building *b)
+{
+    if (b->id >= column_cache.size) {
+        unsigned int new_size = (b->id / COLUMN_CACHE_SIZE_STEP + 1) * COLUMN_CACHE_SIZE_STEP;
+        cached_column *items = realloc(column_cache.items, new_size * sizeof(cached_column));
+        if (!items) {
+            return overlay->get_column_height(b);
+        }
+        memset(&items[column_cache.size], 0, (new_size - column_cache.size) * sizeof(cached_column));
+        column_cache.items = items;
+        column_cache.size = new_size;
+    }
+    cached_column *column = &column_cache.items[b->id];
+    if (column->stamp != column_cache.stamp || column->type != b->type) {
+        column->stamp = column_cache.stamp;
+        column->type = b->type;
+        column->height = overlay->get_column_height(b);
+    }
+    return column->height;
+}
+
 void city_with_overlay_update(void)
 {
     select_city_overlay();
@@ -302,10 +378,12 @@ static int has_adjacent_deletion(int grid_offset)
 {
     int size = map_property_multi_tile_size(grid_offset);
     int total_adjacent_offsets = size * 2 + 1;
-    const int *adjacent_offset = ADJACENT_OFFSETS[size - 2][city_view_orientation() / 2];
+    int orientation_index = city_view_orientation() / 2;
     for (int i = 0; i < total_adjacent_offsets; ++i) {
-        if (map_property_is_deleted(grid_offset + adjacent_offset[i]) ||
-            draw_building_as_deleted(building_get(map_building_at(grid_offset + adjacent_offset[i])))) {
+        int adjacent_offset = grid_offset + map_grid_delta(ADJACENT_TILES[size - 2][orientation_index][i].x,
+            ADJACENT_TILES[size - 2][orientation_index][i].y);
+        if (map_property_is_deleted(adjacent_offset) ||
+            draw_building_as_deleted(building_get(map_building_at(adjacent_offset)))) {
             return 1;
         }
     }
@@ -532,27 +610,44 @@ static void draw_footprint(int x, int y, int grid_offset)
     draw_roamer_frequency(x, y, grid_offset);
 }
 
+static void prepare_column_images(void)
+{
+    int base_image_id = image_group(GROUP_OVERLAY_COLUMN);
+    if (column_images.base_image_id == base_image_id) {
+        return;
+    }
+    column_images.base_image_id = base_image_id;
+    for (column_color_type color_type = COLUMN_COLOR_GREEN; color_type <= COLUMN_COLOR_RED_TO_GREEN; color_type++) {
+        for (int height = 0; height <= MAX_COLUMN_HEIGHT; height++) {
+            int image_id = base_image_id;
+            switch (color_type) {
+                case COLUMN_COLOR_RED:
+                    image_id += 9;
+                    break;
+                case COLUMN_COLOR_RED_TO_GREEN:
+                    image_id += height - (height % 3);
+                    break;
+                case COLUMN_COLOR_GREEN_TO_RED:
+                    image_id += 9 - height + (height % 3);
+                    break;
+                default:
+                    break;
+            }
+            column_images.images[color_type][height].image_id = image_id;
+            column_images.images[color_type][height].capital_y_offset =
+                -8 - image_get(image_id)->height - 10 * (height - 1) + 13;
+        }
+    }
+}
+
 static void draw_overlay_column(int x, int y, int height, column_color_type color_type)
 {
-    int image_id = image_group(GROUP_OVERLAY_COLUMN);
-    if (height > 10) {
-        height = 10;
-    }
-    switch (color_type) {
-        case COLUMN_COLOR_RED:
-            image_id += 9;
-            break;
-        case COLUMN_COLOR_RED_TO_GREEN:
-            image_id += height - (height % 3);
-            break;
-        case COLUMN_COLOR_GREEN_TO_RED:
-            image_id += 9 - height + (height % 3);
-            break;
-        default:
-            break;
+    if (height > MAX_COLUMN_HEIGHT) {
+        height = MAX_COLUMN_HEIGHT;
     }
+    prepare_column_images();
+    int image_id = column_images.images[color_type][height].image_id;
 
-    int capital_height = image_get(image_id)->height;
     // base
     image_draw(image_id + 2, x + 9, y - 8, 0, scale);
     if (height) {
@@ -561,7 +656,7 @@ static void draw_overlay_column(int x, int y, int height, column_color_type colo
             image_draw(image_id + 1, x + 17, y - 8 - 10 * i + 13, 0, scale);
         }
         // capital
-        image_draw(image_id, x + 5, y - 8 - capital_height - 10 * (height - 1) + 13, 0, scale);
+        image_draw(image_id, x + 5, y + column_images.images[color_type][height].capital_y_offset, 0, scale);
     }
 }
 static void draw_depot_resource(building *b, int x, int y, color_t color_mask)
@@ -723,7 +818,7 @@ void city_with_overlay_draw_building_top(int x, int y, int grid_offset)
     if (overlay->show_building(b)) {
         draw_building_top(grid_offset, b, x, y);
     } else {
-        int column_height = overlay->get_column_height(b);
+        int column_height = get_column_height(b);
         if (column_height != NO_COLUMN) {
             int draw = 1;
             if (building_is_farm(b->type)) {
@@ -908,6 +1003,7 @@ void city_with_overlay_draw(const map_tile *tile, unsigned int roamer_preview_bu
 
     scale = city_view_get_scale() / 100.0f;
     city_roamer_preview_selected_building_id = roamer_preview_building_id;
+    refresh_column_cache();
     int x, y, width, height;
     city_view_get_viewport(&x, &y, &width, &height);
     graphics_fill_rect(x, y, width, height, COLOR_BLACK);
@@ -49,23 +49,24 @@
 #include "widget/city_figure.h"
 #include "widget/city_draw_highway.h"
 
-#define OFFSET(x,y) (x + GRID_SIZE * y)
-
 #define WAREHOUSE_FLAG_FRAMES 9
 #define SELECTED_BUILDING_COLOR_MASK COLOR_MASK_SKY_BLUE
 
-static const int ADJACENT_OFFSETS[2][4][7] = {
+static const struct {
+    int x;
+    int y;
+} ADJACENT_TILES[2][4][7] = {
     {
-        {OFFSET(-1, 0), OFFSET(-1, -1),  OFFSET(-1, -2), OFFSET(0, -2), OFFSET(1, -2)},
-        {OFFSET(0, -1), OFFSET(1, -1),  OFFSET(2, -1), OFFSET(2, 0), OFFSET(2, 1)},
-        {OFFSET(1, 0), OFFSET(1, 1),  OFFSET(1, 2), OFFSET(0, 2), OFFSET(-1, 2)},
-        {OFFSET(0, 1), OFFSET(-1, 1),  OFFSET(-2, 1), OFFSET(-2, 0), OFFSET(-2, -1)}
+        {{-1, 0}, {-1, -1},  {-1, -2}, {0, -2}, {1, -2}},
+        {{0, -1}, {1, -1},  {2, -1}, {2, 0}, {2, 1}},
+        {{1, 0}, {1, 1},  {1, 2}, {0, 2}, {-1, 2}},
+        {{0, 1}, {-1, 1},  {-2, 1}, {-2, 0}, {-2, -1}}
     },
     {
-        {OFFSET(-1, 0), OFFSET(-1, -1),  OFFSET(-1, -2), OFFSET(-1, -3), OFFSET(0, -3),  OFFSET(1, -3), OFFSET(2, -3)},
-        {OFFSET(0, -1), OFFSET(1, -1),  OFFSET(2, -1), OFFSET(3, -1), OFFSET(3, 0),  OFFSET(3, 1), OFFSET(3, 2)},
-        {OFFSET(1, 0), OFFSET(1, 1),  OFFSET(1, 2), OFFSET(1, 3), OFFSET(0, 3),  OFFSET(-1, 3), OFFSET(-2, 3)},
-        {OFFSET(0, 1), OFFSET(-1, 1),  OFFSET(-2, 1), OFFSET(-3, 1), OFFSET(-3, 0),  OFFSET(-3, -1), OFFSET(-3, -2)}
+        {{-1, 0}, {-1, -1},  {-1, -2}, {-1, -3}, {0, -3},  {1, -3}, {2, -3}},
+        {{0, -1}, {1, -1},  {2, -1}, {3, -1}, {3, 0},  {3, 1}, {3, 2}},
+        {{1, 0}, {1, 1},  {1, 2}, {1, 3}, {0, 3},  {-1, 3}, {-2, 3}},
+        {{0, 1}, {-1, 1},  {-2, 1}, {-3, 1}, {-3, 0},  {-3, -1}, {-3, -2}}
     }
 };
 
@@ -130,10 +131,12 @@ static int has_adjacent_deletion(int grid_offset)
 {
     int size = map_property_multi_tile_size(grid_offset);
     int total_adjacent_offsets = size * 2 + 1;
-    const int *adjacent_offset = ADJACENT_OFFSETS[size - 2][city_view_orientation() / 2];
+    int orientation_index = city_view_orientation() / 2;
     for (int i = 0; i < total_adjacent_offsets; ++i) {
-        if (map_property_is_deleted(grid_offset + adjacent_offset[i]) ||
-            draw_building_as_deleted(building_get(map_building_at(grid_offset + adjacent_offset[i])))) {
+        int adjacent_offset = grid_offset + map_grid_delta(ADJACENT_TILES[size - 2][orientation_index][i].x,
+            ADJACENT_TILES[size - 2][orientation_index][i].y);
+        if (map_property_is_deleted(adjacent_offset) ||
+            draw_building_as_deleted(building_get(map_building_at(adjacent_offset)))) {
             return 1;
         }
     }
@@ -1064,7 +1067,7 @@ static void update_clouds(void)
         clouds_pause();
     }
     city_view_get_camera_in_pixels(&camera_x, &camera_y);
-    clouds_draw(camera_x, camera_y, GRID_SIZE * 60, GRID_SIZE * 30, draw_context.scale);
+    clouds_draw(camera_x, camera_y, map_grid_stride() * 60, map_grid_stride() * 30, draw_context.scale);
 }
 
 /***
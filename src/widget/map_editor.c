@@ -5,6 +5,7 @@
 #include "city/warning.h"
 #include "core/config.h"
 #include "core/lang.h"
+#include "core/log.h"
 #include "core/string.h"
 #include "editor/editor.h"
 #include "editor/tool.h"
@@ -35,6 +36,7 @@
 #include "widget/map_editor_tool.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #define MAX_EVENTS_PER_TILE 10
@@ -58,7 +60,43 @@ static struct {
     float scale;
 } draw_context;
 
-int event_tiles[GRID_SIZE * GRID_SIZE][MAX_EVENTS_PER_TILE];
+static struct {
+    int (*events)[MAX_EVENTS_PER_TILE];
+    terrain_image *earthquake_images;
+    int total_tiles;
+} tiles;
+
+static int ensure_tiles(void)
+{
+    int total_tiles = map_grid_total_tiles();
+    if (tiles.total_tiles == total_tiles) {
+        return 1;
+    }
+    free(tiles.events);
+    free(tiles.earthquake_images);
+    tiles.events = malloc(sizeof(*tiles.events) * total_tiles);
+    tiles.earthquake_images = calloc(total_tiles, sizeof(terrain_image));
+    if (!tiles.events || !tiles.earthquake_images) {
+        log_error("Unable to allocate memory for the editor map tiles", 0, total_tiles);
+        free(tiles.events);
+        free(tiles.earthquake_images);
+        tiles.events = 0;
+        tiles.earthquake_images = 0;
+        tiles.total_tiles = 0;
+        return 0;
+    }
+    memset(tiles.events, -1, sizeof(*tiles.events) * total_tiles);
+    tiles.total_tiles = total_tiles;
+    return 1;
+}
+
+static int event_at(int grid_offset, int index)
+{
+    if (!ensure_tiles()) {
+        return -1;
+    }
+    return tiles.events[grid_offset][index];
+}
 
 static void init_draw_context(void)
 {
@@ -75,7 +113,9 @@ static void init_draw_context(void)
 
 void widget_map_editor_clear_draw_context_event_tiles(void)
 {
-    memset(event_tiles, -1, sizeof(event_tiles));
+    if (ensure_tiles()) {
+        memset(tiles.events, -1, sizeof(*tiles.events) * tiles.total_tiles);
+    }
 }
 
 void widget_map_editor_custom_earthquake_request_refresh(void)
@@ -85,12 +125,15 @@ void widget_map_editor_custom_earthquake_request_refresh(void)
 
 int widget_map_editor_add_draw_context_event_tile(int grid_offset, int event_id)
 {
+    if (!ensure_tiles()) {
+        return 0;
+    }
     for (int i = 0; i < MAX_EVENTS_PER_TILE; i++) {
-        if (event_tiles[grid_offset][i] == event_id) {
+        if (tiles.events[grid_offset][i] == event_id) {
             return 1; // already exists
         }
-        if (event_tiles[grid_offset][i] == -1) {
-            event_tiles[grid_offset][i] = event_id;
+        if (tiles.events[grid_offset][i] == -1) {
+            tiles.events[grid_offset][i] = event_id;
             return 1;
         }
     }
@@ -114,8 +157,8 @@ static void draw_footprint(int x, int y, int grid_offset)
         }
         map_image_set(grid_offset, image_id);
     }
-    if (event_tiles[grid_offset][0] != -1) {
-        color_mask = complex_button_basic_colors((event_tiles[grid_offset][0] % 10) + 1);
+    if (event_at(grid_offset, 0) != -1) {
+        color_mask = complex_button_basic_colors((event_at(grid_offset, 0) % 10) + 1);
     }
     image_draw_isometric_footprint_from_draw_tile(image_id, x, y, color_mask, draw_context.scale);
 
@@ -135,7 +178,10 @@ static void draw_custom_earthquake(int x, int y, int grid_offset)
         return;
     }
     if (map_property_is_future_earthquake(grid_offset) && editor_is_active() && !map_terrain_is(grid_offset, TERRAIN_IMPASSABLE_EARTHQUAKE)) {
-        static terrain_image images[GRID_SIZE * GRID_SIZE] = { 0 };
+        if (!ensure_tiles()) {
+            return;
+        }
+        terrain_image *images = tiles.earthquake_images;
         if (data.custom_earthquake_refresh || !images[grid_offset].is_valid) {
             images[grid_offset] = *map_image_context_get_future_earthquake(grid_offset);
         }
@@ -153,8 +199,8 @@ static void draw_top(int x, int y, int grid_offset)
     }
     int image_id = map_image_at(grid_offset);
     color_t color_mask = 0;
-    if (event_tiles[grid_offset][0] != -1) {
-        color_mask = complex_button_basic_colors((event_tiles[grid_offset][0] % 10) + 1);
+    if (event_at(grid_offset, 0) != -1) {
+        color_mask = complex_button_basic_colors((event_at(grid_offset, 0) % 10) + 1);
     }
     image_draw_isometric_top_from_draw_tile(image_id, x, y, color_mask, draw_context.scale);
 }
@@ -428,12 +474,12 @@ void widget_map_editor_get_tooltip(tooltip_context *c)
     if (tile->grid_offset) {
         static uint8_t tooltip_text[128]; // increased a bit for safety
         int offset = tile->grid_offset;
-        if (event_tiles[offset][0] == -1) {
+        if (event_at(offset, 0) == -1) {
             return; // No events
         }
         int len = snprintf((char *) tooltip_text, sizeof(tooltip_text), "Event IDs: ");
         for (int i = 0; i < MAX_EVENTS_PER_TILE; i++) {
-            int event_id = event_tiles[offset][i];
+            int event_id = event_at(offset, i);
             if (event_id == -1)
                 break;
             int written = snprintf((char *) tooltip_text + len, sizeof(tooltip_text) - len, "%s%d", " ", event_id);
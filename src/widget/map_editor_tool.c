@@ -164,8 +164,9 @@ static void draw_selection_rectangle(const map_tile *current_tile, const map_til
     city_view_get_selected_tile_pixels(&x_pixels, &y_pixels);
 
     // Draw simple highlight for each tile in the selection
-    for (int i = 0; i < slice->size; i++) {
-        int offset = slice->grid_offsets[i];
+    grid_slice_iterator it = map_grid_slice_iterate(slice);
+    while (map_grid_slice_next(&it)) {
+        int offset = it.grid_offset;
         // Calculate the isometric view position for this tile
         int xx = map_grid_offset_to_x(offset);
         int yy = map_grid_offset_to_y(offset);
@@ -508,11 +508,13 @@ static void prepare_minimap_cache(void)
         !graphics_renderer()->has_custom_image(CUSTOM_IMAGE_MINIMAP)) {
         data.minimap.width = data.functions->map.width();
         data.minimap.height = data.functions->map.height() * 2;
-        data.minimap.x = (VIEW_X_MAX - data.minimap.width) / 2;
-        data.minimap.y = (VIEW_Y_MAX - data.minimap.height) / 2;
-
         graphics_renderer()->create_custom_image(CUSTOM_IMAGE_MINIMAP, data.minimap.width * 2, data.minimap.height, 0);
     }
+    // The view size follows the grid size, which can change even when the map size does not
+    int view_width, view_height;
+    city_view_get_view_size_tiles(&view_width, &view_height);
+    data.minimap.x = (view_width - data.minimap.width) / 2;
+    data.minimap.y = (view_height - data.minimap.height) / 2;
     data.cache.buffer = graphics_renderer()->get_custom_image_buffer(CUSTOM_IMAGE_MINIMAP, &data.cache.stride);
 }
 
@@ -23,9 +23,10 @@ static int get_education_advice(void)
         return 4;
     }
     int advice_id;
-    int coverage_school = city_culture_coverage_school();
-    int coverage_academy = city_culture_coverage_academy();
-    int coverage_library = city_culture_coverage_library();
+    const city_culture_snapshot *culture = city_culture_get_snapshot();
+    int coverage_school = culture->school.coverage;
+    int coverage_academy = culture->academy.coverage;
+    int coverage_library = culture->library.coverage;
     if (!demands->requiring.school) {
         advice_id = 5; // no demands yet
     } else if (!demands->requiring.library) {
@@ -59,6 +60,8 @@ static int draw_background(void)
     image_draw(image_group(GROUP_ADVISOR_ICONS) + 7, 10, 10, COLOR_MASK_NONE, SCALE_NONE);
     lang_text_draw(57, 0, 60, 12, FONT_LARGE_BLACK); // Education
 
+    const city_culture_snapshot *culture = city_culture_get_snapshot();
+
     // x population, y school age, z academy age
     int width = text_draw_number(city_population(), '@', " ", 60, 50, FONT_NORMAL_BLACK, 0);
     width += lang_text_draw(57, 1, 60 + width, 50, FONT_NORMAL_BLACK);
@@ -75,13 +78,13 @@ static int draw_background(void)
     inner_panel_draw(32, 100, 36, 5);
 
     // schools
-    lang_text_draw_amount(8, 18, building_count_total(BUILDING_SCHOOL), 40, 105, FONT_NORMAL_WHITE);
-    text_draw_number_centered(building_count_active(BUILDING_SCHOOL), 170, 105, 100, FONT_NORMAL_WHITE);
+    lang_text_draw_amount(8, 18, culture->school.total, 40, 105, FONT_NORMAL_WHITE);
+    text_draw_number_centered(culture->school.active, 170, 105, 100, FONT_NORMAL_WHITE);
 
-    width = text_draw_number(city_culture_get_school_person_coverage(), '@', " ", 280, 105, FONT_NORMAL_WHITE, 0);
+    width = text_draw_number(culture->school.people_covered, '@', " ", 280, 105, FONT_NORMAL_WHITE, 0);
     lang_text_draw(57, 7, 280 + width, 105, FONT_NORMAL_WHITE);
 
-    int pct_school = city_culture_coverage_school();
+    int pct_school = culture->school.coverage;
     if (pct_school == 0) {
         lang_text_draw_centered(57, 10, 420, 105, 200, FONT_NORMAL_WHITE);
     } else if (pct_school < 100) {
@@ -91,13 +94,13 @@ static int draw_background(void)
     }
 
     // academies
-    lang_text_draw_amount(8, 20, building_count_total(BUILDING_ACADEMY), 40, 125, FONT_NORMAL_WHITE);
-    text_draw_number_centered(building_count_active(BUILDING_ACADEMY), 170, 125, 100, FONT_NORMAL_WHITE);
+    lang_text_draw_amount(8, 20, culture->academy.total, 40, 125, FONT_NORMAL_WHITE);
+    text_draw_number_centered(culture->academy.active, 170, 125, 100, FONT_NORMAL_WHITE);
 
-    width = text_draw_number(city_culture_get_academy_person_coverage(), '@', " ", 280, 125, FONT_NORMAL_WHITE, 0);
+    width = text_draw_number(culture->academy.people_covered, '@', " ", 280, 125, FONT_NORMAL_WHITE, 0);
     lang_text_draw(57, 8, 280 + width, 125, FONT_NORMAL_WHITE);
 
-    int pct_academy = city_culture_coverage_academy();
+    int pct_academy = culture->academy.coverage;
     if (pct_academy == 0) {
         lang_text_draw_centered(57, 10, 420, 125, 200, FONT_NORMAL_WHITE);
     } else if (pct_academy < 100) {
@@ -107,13 +110,13 @@ static int draw_background(void)
     }
 
     // libraries
-    lang_text_draw_amount(8, 22, building_count_total(BUILDING_LIBRARY), 40, 145, FONT_NORMAL_WHITE);
-    text_draw_number_centered(building_count_active(BUILDING_LIBRARY), 170, 145, 100, FONT_NORMAL_WHITE);
+    lang_text_draw_amount(8, 22, culture->library.total, 40, 145, FONT_NORMAL_WHITE);
+    text_draw_number_centered(culture->library.active, 170, 145, 100, FONT_NORMAL_WHITE);
 
-    width = text_draw_number(city_culture_get_library_person_coverage(), '@', " ", 280, 145, FONT_NORMAL_WHITE, 0);
+    width = text_draw_number(culture->library.people_covered, '@', " ", 280, 145, FONT_NORMAL_WHITE, 0);
     lang_text_draw(57, 9, 280 + width, 145, FONT_NORMAL_WHITE);
 
-    int pct_library = city_culture_coverage_library();
+    int pct_library = culture->library.coverage;
     if (pct_library == 0) {
         lang_text_draw_centered(57, 10, 420, 145, 200, FONT_NORMAL_WHITE);
     } else if (pct_library < 100) {
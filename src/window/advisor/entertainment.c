@@ -51,7 +51,7 @@ static int get_entertainment_advice(void)
     if (demands->missing.entertainment > demands->missing.more_entertainment) {
         return 3;
     } else if (!demands->missing.more_entertainment) {
-        return city_culture_average_entertainment() ? 1 : 0;
+        return city_culture_get_snapshot()->average_entertainment ? 1 : 0;
     } else if (city_entertainment_venue_needing_shows()) {
         return 3 + city_entertainment_venue_needing_shows();
     } else {
@@ -98,7 +98,7 @@ static void draw_games_info(void)
 static int draw_background(void)
 {
     city_gods_calculate_moods(0);
-    city_culture_calculate();
+    const city_culture_snapshot *culture = city_culture_get_snapshot();
 
     outer_panel_draw(0, 0, 40, ADVISOR_HEIGHT);
     image_draw(image_group(GROUP_ADVISOR_ICONS) + 8, 10, 10, COLOR_MASK_NONE, SCALE_NONE);
@@ -114,13 +114,13 @@ static int draw_background(void)
 
     // taverns
     lang_text_draw_amount(CUSTOM_TRANSLATION, TR_WINDOW_ADVISOR_ENTERTAINMENT_TAVERN_COVERAGE,
-        building_count_total(BUILDING_TAVERN), 40, 67, FONT_NORMAL_WHITE);
-    text_draw_number_centered(building_count_active(BUILDING_TAVERN), 150, 67, 100, FONT_NORMAL_WHITE);
+        culture->tavern.total, 40, 67, FONT_NORMAL_WHITE);
+    text_draw_number_centered(culture->tavern.active, 150, 67, 100, FONT_NORMAL_WHITE);
     lang_text_draw_centered(56, 2, 230, 67, 100, FONT_NORMAL_WHITE);
-    int width = text_draw_number(city_culture_get_tavern_person_coverage(), '_', " ",
+    int width = text_draw_number(culture->tavern.people_covered, '_', " ",
         PEOPLE_OFFSET, 67, FONT_NORMAL_WHITE, 0);
     lang_text_draw(58, 5, PEOPLE_OFFSET + width, 67, FONT_NORMAL_WHITE);
-    int pct_tavern = city_culture_coverage_tavern();
+    int pct_tavern = culture->tavern.coverage;
     if (pct_tavern == 0) {
         lang_text_draw_centered(57, 10, COVERAGE_OFFSET, 67, COVERAGE_WIDTH, FONT_NORMAL_WHITE);
     } else if (pct_tavern < 100) {
@@ -130,13 +130,13 @@ static int draw_background(void)
     }
 
     // theaters
-    lang_text_draw_amount(8, 34, building_count_total(BUILDING_THEATER), 40, 87, FONT_NORMAL_WHITE);
-    text_draw_number_centered(building_count_active(BUILDING_THEATER), 150, 87, 100, FONT_NORMAL_WHITE);
-    text_draw_number_centered(city_entertainment_theater_shows(), 230, 87, 100, FONT_NORMAL_WHITE);
-    width = text_draw_number(city_culture_get_theatre_person_coverage(), '_', " ",
+    lang_text_draw_amount(8, 34, culture->theater.total, 40, 87, FONT_NORMAL_WHITE);
+    text_draw_number_centered(culture->theater.active, 150, 87, 100, FONT_NORMAL_WHITE);
+    text_draw_number_centered(culture->theater.shows, 230, 87, 100, FONT_NORMAL_WHITE);
+    width = text_draw_number(culture->theater.people_covered, '_', " ",
         PEOPLE_OFFSET, 87, FONT_NORMAL_WHITE, 0);
     lang_text_draw(58, 5, PEOPLE_OFFSET + width, 87, FONT_NORMAL_WHITE);
-    int pct_theater = city_culture_coverage_theater();
+    int pct_theater = culture->theater.coverage;
     if (pct_theater == 0) {
         lang_text_draw_centered(57, 10, COVERAGE_OFFSET, 87, COVERAGE_WIDTH, FONT_NORMAL_WHITE);
     } else if (pct_theater < 100) {
@@ -146,13 +146,13 @@ static int draw_background(void)
     }
 
     // amphitheaters
-    lang_text_draw_amount(8, 36, building_count_total(BUILDING_AMPHITHEATER), 40, 107, FONT_NORMAL_WHITE);
-    text_draw_number_centered(building_count_active(BUILDING_AMPHITHEATER), 150, 107, 100, FONT_NORMAL_WHITE);
-    text_draw_number_centered(city_entertainment_amphitheater_shows(), 230, 107, 100, FONT_NORMAL_WHITE);
-    width = text_draw_number(city_culture_get_ampitheatre_person_coverage(), '@', " ",
+    lang_text_draw_amount(8, 36, culture->amphitheater.total, 40, 107, FONT_NORMAL_WHITE);
+    text_draw_number_centered(culture->amphitheater.active, 150, 107, 100, FONT_NORMAL_WHITE);
+    text_draw_number_centered(culture->amphitheater.shows, 230, 107, 100, FONT_NORMAL_WHITE);
+    width = text_draw_number(culture->amphitheater.people_covered, '@', " ",
         PEOPLE_OFFSET, 107, FONT_NORMAL_WHITE, 0);
     lang_text_draw(58, 5, PEOPLE_OFFSET + width, 107, FONT_NORMAL_WHITE);
-    int pct_amphitheater = city_culture_coverage_amphitheater();
+    int pct_amphitheater = culture->amphitheater.coverage;
     if (pct_amphitheater == 0) {
         lang_text_draw_centered(57, 10, COVERAGE_OFFSET, 107, COVERAGE_WIDTH, FONT_NORMAL_WHITE);
     } else if (pct_amphitheater < 100) {
@@ -164,12 +164,12 @@ static int draw_background(void)
 
     // arenas
     lang_text_draw_amount(CUSTOM_TRANSLATION, TR_WINDOW_ADVISOR_ENTERTAINMENT_ARENA_COVERAGE,
-        building_count_total(BUILDING_ARENA), 40, 127, FONT_NORMAL_WHITE);
-    text_draw_number_centered(building_count_active(BUILDING_ARENA), 150, 127, 100, FONT_NORMAL_WHITE);
-    width = text_draw_number(city_culture_get_arena_person_coverage(), '_', " ", PEOPLE_OFFSET, 127, FONT_NORMAL_WHITE, 0);
+        culture->arena.total, 40, 127, FONT_NORMAL_WHITE);
+    text_draw_number_centered(culture->arena.active, 150, 127, 100, FONT_NORMAL_WHITE);
+    width = text_draw_number(culture->arena.people_covered, '_', " ", PEOPLE_OFFSET, 127, FONT_NORMAL_WHITE, 0);
     lang_text_draw(58, 5, PEOPLE_OFFSET + width, 127, FONT_NORMAL_WHITE);
-    text_draw_number_centered(city_entertainment_arena_shows(), 230, 127, 100, FONT_NORMAL_WHITE);
-    int pct = city_culture_coverage_arena();
+    text_draw_number_centered(culture->arena.shows, 230, 127, 100, FONT_NORMAL_WHITE);
+    int pct = culture->arena.coverage;
     if (pct == 0) {
         lang_text_draw_centered(57, 10, COVERAGE_OFFSET, 127, COVERAGE_WIDTH, FONT_NORMAL_WHITE);
     } else if (pct < 100) {
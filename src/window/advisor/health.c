@@ -96,8 +96,8 @@ static int draw_background(void)
     people_covered = city_health_get_population_with_clinic_access();
     print_health_building_info(168, BUILDING_DOCTOR, people_covered, calc_percentage(people_covered, population));
 
-    people_covered = 1000 * building_count_active(BUILDING_HOSPITAL);
-    print_health_building_info(188, BUILDING_HOSPITAL, people_covered, city_culture_coverage_hospital());
+    const city_culture_venue *hospital = &city_culture_get_snapshot()->hospital;
+    print_health_building_info(188, BUILDING_HOSPITAL, hospital->people_covered, hospital->coverage);
 
     int text_height = lang_text_draw_multiline(56, 7 + get_health_advice(), 45, 226, 560, FONT_NORMAL_BLACK);
 
@@ -154,7 +154,6 @@ static void init(void)
     city_migration_determine_no_immigration_cause();
 
     city_houses_calculate_culture_demands();
-    city_culture_update_coverage();
 
     city_resource_calculate_food_stocks_and_supply_wheat();
     formation_calculate_figures();
@@ -24,6 +24,7 @@
 #include "empire/object.h"
 #include "empire/trade_route.h"
 #include "figure/figure.h"
+#include "game/replay.h"
 #include "graphics/button.h"
 #include "graphics/generic_button.h"
 #include "graphics/graphics.h"
@@ -1552,9 +1553,12 @@ static void storage_toggle_all_states(int param1, int param2)
 {
 
     int storage_id = building_get(data.building_id)->storage_id;
+    // Storage creation also resets the accepted goods, so only the player's choice is recorded here
     if (param1 == 0) {
+        game_replay_record_action(REPLAY_ACTION_STORAGE_ACCEPT_ALL, storage_id, 0, 0);
         building_storage_accept_all(storage_id);
     } else {
+        game_replay_record_action(REPLAY_ACTION_STORAGE_ACCEPT_NONE, storage_id, 0, 0);
         building_storage_accept_none(storage_id);
     }
     window_invalidate();
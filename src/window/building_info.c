@@ -66,7 +66,7 @@ enum {
     HEIGHT_13_15_BLOCKS = 13,
 };
 
-#define OFFSET(x,y) (x + GRID_SIZE * y)
+#define OFFSET(x,y) map_grid_delta(x, y)
 #define SMALL_ICON_SIDE 24
 
 static void button_help(int param1, int param2);
@@ -458,12 +458,12 @@ static void init(int grid_offset)
     for (int i = 0; i < 7; i++) {
         context.figure.figure_ids[i] = 0;
     }
-    static const int FIGURE_OFFSETS[] = {
+    const int figure_offsets[] = {
         OFFSET(0,0), OFFSET(0,-1), OFFSET(0,1), OFFSET(1,0), OFFSET(-1,0),
         OFFSET(-1,-1), OFFSET(1,-1), OFFSET(-1,1), OFFSET(1,1)
     };
     for (int i = 0; i < 9 && context.figure.count < 7; i++) {
-        int figure_id = map_figure_at(grid_offset + FIGURE_OFFSETS[i]);
+        int figure_id = map_figure_at(grid_offset + figure_offsets[i]);
         while (figure_id > 0 && context.figure.count < 7) {
             figure *f = figure_get(figure_id);
             if (f->state != FIGURE_STATE_DEAD &&
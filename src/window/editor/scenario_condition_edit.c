@@ -407,9 +407,10 @@ static void on_grid_slice_selected(grid_slice *selection)
     int end_offset = 0;
     editor_tool_get_selection_offsets(&start_offset, &end_offset);
 
-    for (int i = 0; i < selection->size; i++) {
-        if (selection->grid_offsets[i]) {
-            widget_map_editor_add_draw_context_event_tile(selection->grid_offsets[i], data.condition->parent_event_id);
+    grid_slice_iterator it = map_grid_slice_iterate(selection);
+    while (map_grid_slice_next(&it)) {
+        if (it.grid_offset) {
+            widget_map_editor_add_draw_context_event_tile(it.grid_offset, data.condition->parent_event_id);
         }
     }
     data.condition->parameter1 = start_offset;